@@ -0,0 +1,213 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "AIPlanner.h"
+#include "PAASchifanoFrancesco/Units/UnitBase.h"
+
+const FAIUnitOrder* FAITurnPlan::FindOrder(const AUnitBase* Unit) const
+{
+	if (!bIsValid || !Unit) return nullptr;
+
+	return Orders.FindByPredicate([Unit](const FAIUnitOrder& Order)
+	{
+		return Order.Actor.Get() == Unit;
+	});
+}
+
+/**
+ * Descrizione:
+ * Esegue PlanHardUnit per ogni unità viva della fazione, nello stesso ordine
+ * in cui il BattleManager le processa durante il turno.
+ */
+FAITurnPlan FAIPlanner::PlanHardTurn(const FSimBoard& Board, int32 Team, const FInfluenceMap* BaseInfluence)
+{
+	FAITurnPlan Plan;
+	Plan.BoardHash = Board.ComputePositionHash();
+
+	// Copia di lavoro: i movimenti pianificati aggiornano le occupazioni
+	FSimBoard WorkBoard = Board;
+
+	FInfluenceMap Influence = BaseInfluence ? *BaseInfluence : FInfluenceMap();
+	Influence.Update(WorkBoard);
+
+	for (int32 UnitIndex = 0; UnitIndex < WorkBoard.Units.Num(); ++UnitIndex)
+	{
+		const FSimUnit& Unit = WorkBoard.Units[UnitIndex];
+		if (!Unit.IsAlive() || Unit.Team != Team) continue;
+
+		FAIUnitOrder& Order = Plan.Orders.AddDefaulted_GetRef();
+		PlanHardUnit(WorkBoard, UnitIndex, Order, &Influence);
+		Influence.Update(WorkBoard); // Ricalcola solo l'unità appena mossa
+	}
+
+	Plan.bIsValid = true;
+	return Plan;
+}
+
+/**
+ * Descrizione:
+ * Replica la logica di ProcessNextAIUnit per l'IA Hard:
+ * 1. Se un nemico è già nel raggio d'attacco, attacca senza muoversi.
+ * 2. Altrimenti calcola il percorso verso il nemico più vicino e si ferma
+ *    sull'ultima tile del percorso raggiungibile entro il range di movimento.
+ *    Con la mappa di minaccia sceglie invece, tra le tile raggiungibili del percorso, quella che
+ *    bilancia avanzamento, possibilità di attaccare e danno atteso subito al turno successivo.
+ * 3. Dopo il movimento prova di nuovo ad attaccare.
+ */
+void FAIPlanner::PlanHardUnit(FSimBoard& Board, int32 UnitIndex, FAIUnitOrder& OutOrder, const FInfluenceMap* Influence)
+{
+	OutOrder.UnitIndex = UnitIndex;
+	OutOrder.Actor = Board.Units[UnitIndex].Actor;
+
+	// 1. Attacco diretto
+	OutOrder.PreMoveTarget = Board.FindFirstAttackable(UnitIndex);
+	if (OutOrder.PreMoveTarget != INDEX_NONE)
+	{
+		Board.Units[UnitIndex].bHasAttacked = true;
+		return;
+	}
+
+	// 2. Movimento verso il nemico più vicino
+	const int32 Enemy = Board.FindNearestEnemy(UnitIndex);
+	if (Enemy == INDEX_NONE) return;
+
+	TArray<int32> Path;
+	if (!Board.FindPath(Board.Units[UnitIndex].TileIndex, Board.Units[Enemy].TileIndex, Path)) return;
+
+	TArray<int32> Area;
+	Board.GetReachableTiles(UnitIndex, Area);
+
+	// Ultima tile del percorso che rientra nell'area raggiungibile
+	const int32 MaxSteps = Board.Units[UnitIndex].MovementRange;
+	int32 LastReachableIndex = INDEX_NONE;
+	for (int32 i = FMath::Min(MaxSteps - 1, Path.Num() - 1); i >= 0; --i)
+	{
+		if (Area.Contains(Path[i]))
+		{
+			LastReachableIndex = i;
+			break;
+		}
+	}
+
+	if (LastReachableIndex == INDEX_NONE) return;
+
+	if (Influence)
+	{
+		// Peso di ogni tile di avanzamento, bonus se da lì si può attaccare, penalità per la minaccia nemica
+		constexpr float AttackBonus = 10.f;
+		constexpr float ThreatWeight = 0.5f;
+		const int32 Team = Board.Units[UnitIndex].Team;
+
+		float BestScore = -MAX_flt;
+		int32 BestIndex = LastReachableIndex;
+		for (int32 i = 0; i <= LastReachableIndex; ++i)
+		{
+			if (!Area.Contains(Path[i])) continue;
+
+			bool bCanAttack = false;
+			for (int32 Target = 0; Target < Board.Units.Num() && !bCanAttack; ++Target)
+			{
+				bCanAttack = Board.CanAttackFrom(UnitIndex, Path[i], Target);
+			}
+
+			const float Score = (i + 1) + (bCanAttack ? AttackBonus : 0.f) - ThreatWeight * Influence->GetEnemyThreat(Team, Path[i]);
+			if (Score > BestScore)
+			{
+				BestScore = Score;
+				BestIndex = i;
+			}
+		}
+		LastReachableIndex = BestIndex;
+	}
+
+	OutOrder.Path.Append(Path.GetData(), LastReachableIndex + 1);
+	Board.MoveUnit(UnitIndex, OutOrder.Path.Last());
+
+	// 3. Attacco dopo il movimento
+	OutOrder.PostMoveTarget = Board.FindFirstAttackable(UnitIndex);
+	if (OutOrder.PostMoveTarget != INDEX_NONE)
+	{
+		Board.Units[UnitIndex].bHasAttacked = true;
+	}
+}
+
+/**
+ * Descrizione:
+ * Logica dell'IA Easy:
+ * 1. Se non c'è più di una tile raggiungibile, prova solo ad attaccare.
+ * 2. Altrimenti sorteggia se dopo il movimento proverà ad attaccare (50%)
+ *    e si sposta su una tile raggiungibile scelta a caso.
+ */
+void FAIPlanner::PlanEasyUnit(FSimBoard& Board, int32 UnitIndex, FRandomStream& Random, FAIUnitOrder& OutOrder)
+{
+	OutOrder.UnitIndex = UnitIndex;
+	OutOrder.Actor = Board.Units[UnitIndex].Actor;
+
+	TArray<int32> Reachable;
+	Board.GetReachableTiles(UnitIndex, Reachable);
+
+	// 1. Nessuna tile utile oltre a quella in cui si trova
+	if (Reachable.Num() <= 1)
+	{
+		OutOrder.PreMoveTarget = Board.FindFirstAttackable(UnitIndex);
+		if (OutOrder.PreMoveTarget != INDEX_NONE)
+		{
+			Board.Units[UnitIndex].bHasAttacked = true;
+		}
+		return;
+	}
+
+	// 2. Sorteggio: 0 = solo movimento, 1 = movimento + attacco
+	const bool bAttackAfterMove = Random.RandRange(0, 1) == 1;
+
+	const int32 Destination = Reachable[Random.RandRange(0, Reachable.Num() - 1)];
+	if (!Board.FindPath(Board.Units[UnitIndex].TileIndex, Destination, OutOrder.Path)) return;
+
+	Board.MoveUnit(UnitIndex, Destination);
+
+	if (bAttackAfterMove)
+	{
+		OutOrder.PostMoveTarget = Board.FindFirstAttackable(UnitIndex);
+		if (OutOrder.PostMoveTarget != INDEX_NONE)
+		{
+			Board.Units[UnitIndex].bHasAttacked = true;
+		}
+	}
+}
+
+/**
+ * Descrizione:
+ * Se il candidato migliore è la tile attuale l'attacco avviene senza muoversi (PreMoveTarget),
+ * altrimenti l'unità segue il percorso verso la destinazione e poi attacca (PostMoveTarget).
+ */
+void FAIPlanner::PlanUtilityUnit(FSimBoard& Board, int32 UnitIndex, FAIUnitOrder& OutOrder, const FInfluenceMap* Influence, const FAIUtilityWeights& Weights)
+{
+	OutOrder.UnitIndex = UnitIndex;
+	OutOrder.Actor = Board.Units[UnitIndex].Actor;
+
+	FAIUtilityCandidates Candidates;
+	FAIUtilityScorer::GenerateCandidates(Board, UnitIndex, Candidates, Influence);
+	FAIUtilityScorer::ScoreCandidates(Candidates, Weights);
+
+	const int32 Best = FAIUtilityScorer::FindBest(Candidates);
+	if (Best == INDEX_NONE) return;
+
+	const int32 Destination = Candidates.Destination[Best];
+	const int32 Target = Candidates.Target[Best];
+
+	if (Destination == Board.Units[UnitIndex].TileIndex)
+	{
+		OutOrder.PreMoveTarget = Target;
+	}
+	else
+	{
+		if (!Board.FindPath(Board.Units[UnitIndex].TileIndex, Destination, OutOrder.Path)) return;
+
+		Board.MoveUnit(UnitIndex, Destination);
+		OutOrder.PostMoveTarget = Target;
+	}
+
+	if (Target != INDEX_NONE)
+	{
+		Board.Units[UnitIndex].bHasAttacked = true;
+	}
+}
@@ -0,0 +1,89 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PAASchifanoFrancesco/Simulation/SimBoard.h"
+#include "AIUtilityScorer.h"
+#include "InfluenceMap.h"
+
+class AUnitBase;
+
+/**
+ * Descrizione:
+ * Ordine deciso dall'IA per una singola unità: eventuale attacco immediato,
+ * percorso da seguire ed eventuale attacco dopo il movimento.
+ * Tile e bersagli sono espressi come indici della FSimBoard da cui il piano è stato calcolato.
+ */
+struct FAIUnitOrder
+{
+	/** Attore a cui si riferisce l'ordine (chiave per l'esecuzione reale) */
+	TWeakObjectPtr<AUnitBase> Actor;
+
+	/** Indice dell'unità nella board usata per pianificare */
+	int32 UnitIndex = INDEX_NONE;
+
+	/** Bersaglio attaccato prima di muoversi (INDEX_NONE se nessuno) */
+	int32 PreMoveTarget = INDEX_NONE;
+
+	/** Percorso da seguire, escluso il punto di partenza (vuoto se l'unità resta ferma) */
+	TArray<int32> Path;
+
+	/** Bersaglio attaccato dopo il movimento (INDEX_NONE se nessuno) */
+	int32 PostMoveTarget = INDEX_NONE;
+};
+
+/**
+ * Descrizione:
+ * Piano completo di un turno dell'IA. BoardHash identifica lo stato di partenza:
+ * il piano è riutilizzabile solo se la board reale ha ancora lo stesso hash.
+ */
+struct FAITurnPlan
+{
+	uint32 BoardHash = 0;
+	bool bIsValid = false;
+	TArray<FAIUnitOrder> Orders;
+
+	/** Cerca l'ordine relativo a un attore (nullptr se il piano non lo contiene) */
+	const FAIUnitOrder* FindOrder(const AUnitBase* Unit) const;
+};
+
+/**
+ * Descrizione:
+ * Decisioni dell'IA calcolate interamente sulla FSimBoard, senza attori né timer.
+ * Le stesse funzioni vengono usate dal BattleManager durante la partita e dal pondering
+ * durante il turno del giocatore.
+ *
+ * Il piano assume che gli attacchi non uccidano: le scelte dell'IA Hard dipendono solo dalle
+ * posizioni, quindi un'uccisione reale viene gestita dalla validazione al momento dell'esecuzione.
+ */
+class PAASCHIFANOFRANCESCO_API FAIPlanner
+{
+public:
+	/**
+	 * Pianifica il turno di tutte le unità della squadra indicata con la logica dell'IA Hard.
+	 * BaseInfluence (opzionale) è una mappa di minaccia già allineata a una board simile:
+	 * viene copiata e aggiornata solo per le unità cambiate.
+	 */
+	static FAITurnPlan PlanHardTurn(const FSimBoard& Board, int32 Team, const FInfluenceMap* BaseInfluence = nullptr);
+
+	/**
+	 * Pianifica una singola unità (IA Hard) e applica il movimento alla board,
+	 * così le unità successive vedono la posizione aggiornata.
+	 * Con una mappa di minaccia la tile di arrivo tiene conto del pericolo.
+	 */
+	static void PlanHardUnit(FSimBoard& Board, int32 UnitIndex, FAIUnitOrder& OutOrder, const FInfluenceMap* Influence = nullptr);
+
+	/**
+	 * Pianifica una singola unità con la logica dell'IA Easy (movimento casuale
+	 * e attacco con probabilità 50%) e applica il movimento alla board.
+	 * I sorteggi usano lo stream passato, così le simulazioni parallele restano riproducibili.
+	 */
+	static void PlanEasyUnit(FSimBoard& Board, int32 UnitIndex, FRandomStream& Random, FAIUnitOrder& OutOrder);
+
+	/**
+	 * Pianifica una singola unità con l'IA Utility: sceglie la coppia (destinazione, bersaglio)
+	 * con il punteggio più alto tra tutti i candidati e applica il movimento alla board.
+	 */
+	static void PlanUtilityUnit(FSimBoard& Board, int32 UnitIndex, FAIUnitOrder& OutOrder, const FInfluenceMap* Influence = nullptr, const FAIUtilityWeights& Weights = FAIUtilityWeights());
+};
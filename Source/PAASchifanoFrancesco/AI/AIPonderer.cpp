@@ -0,0 +1,281 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "AIPonderer.h"
+#include "PAASchifanoFrancesco/Core/MyGameMode.h"
+#include "Engine/World.h"
+
+/**
+ * Salva il riferimento al GameMode. Il ponderer resta inattivo finché non viene chiamato BeginPondering().
+ */
+void UAIPonderer::Initialize(AMyGameMode* InGameMode)
+{
+	GameMode = InGameMode;
+	bIsPondering = false;
+	Nodes.Reset();
+	NodeByHash.Reset();
+	ResetFrontier();
+}
+
+/**
+ * Avvia il pondering: la radice dell'albero è lo stato reale all'inizio del turno del player.
+ */
+void UAIPonderer::BeginPondering()
+{
+	if (!GameMode) return;
+
+	ResetTree(FSimBoard::FromWorld(GameMode));
+	bIsPondering = true;
+
+	UE_LOG(LogTemp, Log, TEXT("[Ponder] Avviato pondering durante il turno del player"));
+}
+
+void UAIPonderer::StopPondering()
+{
+	bIsPondering = false;
+	ResetFrontier();
+}
+
+void UAIPonderer::ResetFrontier()
+{
+	Frontier.Reset();
+	FrontierHead = 0;
+}
+
+/**
+ * Descrizione:
+ * Confronta lo stato reale (dopo l'azione del giocatore) con i nodi speculativi.
+ * Se il ramo era stato previsto, diventa la nuova radice e il lavoro già svolto viene conservato;
+ * altrimenti l'albero riparte dallo stato reale.
+ */
+void UAIPonderer::OnPlayerAction()
+{
+	if (!bIsPondering || !GameMode) return;
+
+	FSimBoard RealBoard = FSimBoard::FromWorld(GameMode);
+	const uint32 RealHash = RealBoard.ComputePositionHash();
+
+	const int32* MatchIndex = NodeByHash.Find(RealHash);
+	if (!MatchIndex)
+	{
+		UE_LOG(LogTemp, Log, TEXT("[Ponder] Mossa non prevista: ricostruzione dell'albero"));
+		ResetTree(MoveTemp(RealBoard));
+		return;
+	}
+
+	Reroot(*MatchIndex);
+
+	// La radice usa sempre lo stato reale (vita e azioni aggiornate) per le espansioni successive
+	Nodes[0].Board = MoveTemp(RealBoard);
+
+	UE_LOG(LogTemp, Log, TEXT("[Ponder] Ramo previsto: albero potato a %d nodi"), Nodes.Num());
+}
+
+/**
+ * Restituisce il piano della radice se corrisponde alla board richiesta.
+ */
+bool UAIPonderer::TakePlan(const FSimBoard& Board, FAITurnPlan& OutPlan)
+{
+	if (Nodes.Num() == 0 || !Nodes[0].bExpanded) return false;
+
+	if (Nodes[0].Hash != Board.ComputePositionHash()) return false;
+
+	OutPlan = Nodes[0].Plan;
+	UE_LOG(LogTemp, Log, TEXT("[Ponder] Piano dell'IA già pronto (%d ordini)"), OutPlan.Orders.Num());
+	return true;
+}
+
+/**
+ * Espande i nodi della frontiera finché non si esaurisce il budget di tempo del frame.
+ */
+void UAIPonderer::Tick(float DeltaTime)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	const double Budget = FrameBudgetMs / 1000.0;
+
+	while (HasFrontier() && FPlatformTime::Seconds() - StartTime < Budget)
+	{
+		ExpandNode(Frontier[FrontierHead++]);
+	}
+
+	if (!HasFrontier())
+	{
+		ResetFrontier();
+	}
+}
+
+bool UAIPonderer::IsTickable() const
+{
+	return bIsPondering && HasFrontier() && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UAIPonderer::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAIPonderer, STATGROUP_Tickables);
+}
+
+UWorld* UAIPonderer::GetTickableGameObjectWorld() const
+{
+	return GameMode ? GameMode->GetWorld() : nullptr;
+}
+
+/**
+ * Descrizione:
+ * 1. Calcola la risposta dell'IA allo stato del nodo (come se il player terminasse qui il turno).
+ * 2. Genera le mosse più probabili del giocatore:
+ *    - per ogni unità che non ha ancora mosso, le tile raggiungibili più vicine all'IA
+ *      (privilegiando quelle da cui può attaccare);
+ *    - per ogni unità che può ancora attaccare, gli attacchi che possono uccidere il bersaglio
+ *      (un attacco che non uccide non cambia le posizioni, quindi non crea un nuovo stato).
+ */
+void UAIPonderer::ExpandNode(int32 NodeIndex)
+{
+	if (!Nodes.IsValidIndex(NodeIndex) || Nodes[NodeIndex].bExpanded) return;
+
+	Nodes[NodeIndex].Plan = FAIPlanner::PlanHardTurn(Nodes[NodeIndex].Board, FUnitRegistry::AITeam);
+	Nodes[NodeIndex].bExpanded = true;
+
+	// Copia locale: AddChild può riallocare l'array dei nodi
+	const FSimBoard Board = Nodes[NodeIndex].Board;
+
+	for (int32 UnitIndex = 0; UnitIndex < Board.Units.Num() && Nodes.Num() < MaxNodes; ++UnitIndex)
+	{
+		const FSimUnit& Unit = Board.Units[UnitIndex];
+		if (!Unit.IsAlive() || !Unit.bPlayer || Unit.bHasAttacked) continue;
+
+		// Nemici vivi dell'unità, letti dai bitset delle squadre
+		TArray<int32, TInlineAllocator<16>> Enemies;
+		Board.GetEnemyUnits(Unit.Team, Enemies);
+
+		// Attacchi potenzialmente letali
+		for (int32 TargetIndex : Enemies)
+		{
+			if (!Board.CanAttackFrom(UnitIndex, Unit.TileIndex, TargetIndex)) continue;
+			if (Board.Units[TargetIndex].Health > Unit.MaxDamage) continue;
+
+			FSimBoard Child = Board;
+			Child.ApplyDamage(TargetIndex, Child.Units[TargetIndex].Health);
+			Child.Units[UnitIndex].bHasMoved = true;
+			Child.Units[UnitIndex].bHasAttacked = true;
+			AddChild(NodeIndex, MoveTemp(Child));
+		}
+
+		if (Unit.bHasMoved) continue;
+
+		// Movimenti: ordina le tile raggiungibili per vicinanza all'IA
+		TArray<int32> Reachable;
+		Board.GetReachableTiles(UnitIndex, Reachable);
+
+		TArray<TPair<int32, int32>> Scored;
+		for (int32 Tile : Reachable)
+		{
+			int32 Score = MAX_int32;
+			for (int32 EnemyIndex : Enemies)
+			{
+				const FSimUnit& Enemy = Board.Units[EnemyIndex];
+
+				// Una tile da cui si può attaccare vale più di qualsiasi avvicinamento
+				const int32 Distance = Board.DistanceSquared(Tile, Enemy.TileIndex);
+				const int32 TileScore = Board.CanAttackFrom(UnitIndex, Tile, EnemyIndex) ? Distance - 100000 : Distance;
+				Score = FMath::Min(Score, TileScore);
+			}
+			Scored.Emplace(Score, Tile);
+		}
+		Scored.Sort([](const TPair<int32, int32>& A, const TPair<int32, int32>& B) { return A.Key < B.Key; });
+
+		for (int32 i = 0; i < Scored.Num() && i < MaxMovesPerUnit; ++i)
+		{
+			FSimBoard Child = Board;
+			Child.MoveUnit(UnitIndex, Scored[i].Value);
+			AddChild(NodeIndex, MoveTemp(Child));
+		}
+	}
+}
+
+void UAIPonderer::AddChild(int32 ParentIndex, FSimBoard&& ChildBoard)
+{
+	if (Nodes.Num() >= MaxNodes) return;
+
+	const uint32 ChildHash = ChildBoard.ComputePositionHash();
+
+	// Lo stesso stato può essere raggiunto da ordini diversi: lo teniamo una volta sola
+	if (NodeByHash.Contains(ChildHash))
+	{
+		return;
+	}
+
+	const int32 ChildIndex = Nodes.Num();
+	NodeByHash.Add(ChildHash, ChildIndex);
+
+	FPonderNode& Child = Nodes.AddDefaulted_GetRef();
+	Child.Board = MoveTemp(ChildBoard);
+	Child.Hash = ChildHash;
+
+	Nodes[ParentIndex].Children.Add(ChildIndex);
+	Frontier.Add(ChildIndex);
+}
+
+/**
+ * Mantiene solo il sottoalbero del nodo indicato, rinumerando i nodi
+ * in modo che la nuova radice sia all'indice 0.
+ * La visita in ampiezza segna i nodi già accodati in un bitset e rinumera con un array di indici:
+ * ogni nodo viene visitato una volta sola.
+ */
+void UAIPonderer::Reroot(int32 NodeIndex)
+{
+	if (NodeIndex == 0) return;
+
+	TArray<FPonderNode> NewNodes;
+	TArray<int32> Remap;
+	Remap.Init(INDEX_NONE, Nodes.Num());
+	TBitArray<> Queued(false, Nodes.Num());
+	TArray<int32> Queue = { NodeIndex };
+	Queued[NodeIndex] = true;
+
+	for (int32 Head = 0; Head < Queue.Num(); ++Head)
+	{
+		const int32 OldIndex = Queue[Head];
+		Remap[OldIndex] = NewNodes.Num();
+		NewNodes.Add(MoveTemp(Nodes[OldIndex]));
+
+		for (int32 ChildIndex : NewNodes.Last().Children)
+		{
+			if (!Queued[ChildIndex])
+			{
+				Queued[ChildIndex] = true;
+				Queue.Add(ChildIndex);
+			}
+		}
+	}
+
+	// Aggiorna gli indici dei figli, l'indice degli stati e la frontiera
+	ResetFrontier();
+	NodeByHash.Reset();
+	for (int32 Index = 0; Index < NewNodes.Num(); ++Index)
+	{
+		FPonderNode& Node = NewNodes[Index];
+		for (int32& ChildIndex : Node.Children)
+		{
+			ChildIndex = Remap[ChildIndex];
+		}
+		NodeByHash.Add(Node.Hash, Index);
+		if (!Node.bExpanded)
+		{
+			Frontier.Add(Index);
+		}
+	}
+
+	Nodes = MoveTemp(NewNodes);
+}
+
+void UAIPonderer::ResetTree(FSimBoard&& RootBoard)
+{
+	Nodes.Reset();
+	NodeByHash.Reset();
+	ResetFrontier();
+
+	FPonderNode& Root = Nodes.AddDefaulted_GetRef();
+	Root.Hash = RootBoard.ComputePositionHash();
+	Root.Board = MoveTemp(RootBoard);
+	NodeByHash.Add(Root.Hash, 0);
+	Frontier.Add(0);
+}
@@ -0,0 +1,122 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "UObject/NoExportTypes.h"
+#include "AIPlanner.h"
+#include "AIPonderer.generated.h"
+
+class AMyGameMode;
+
+/**
+ * Classe: UAIPonderer
+ * Descrizione:
+ * Esegue il "pondering" dell'IA durante il turno del giocatore.
+ * Mantiene un albero speculativo di stati: la radice è lo stato attuale della partita,
+ * i figli sono le mosse più probabili del giocatore. Per ogni nodo viene calcolato in anticipo
+ * il piano di risposta dell'IA, in piccoli blocchi per frame (time slicing) così da non
+ * pesare sul framerate.
+ *
+ * Quando il giocatore agisce (RegisterPlayerMove / RegisterPlayerAttack) l'albero viene potato
+ * al ramo che corrisponde a ciò che è realmente successo. All'inizio del turno dell'IA il piano
+ * della radice è quindi già pronto e può essere usato con latenza quasi nulla.
+ */
+UCLASS()
+class PAASCHIFANOFRANCESCO_API UAIPonderer : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Collega il ponderer al GameMode da cui leggere lo stato della partita */
+	void Initialize(AMyGameMode* InGameMode);
+
+	/** Avvia il pondering a partire dallo stato attuale (inizio turno del player) */
+	void BeginPondering();
+
+	/** Interrompe il pondering (fine turno del player); il piano della radice resta disponibile */
+	void StopPondering();
+
+	/**
+	 * Chiamato dopo ogni azione del giocatore.
+	 * Cerca nell'albero il nodo che corrisponde al nuovo stato e lo rende radice,
+	 * scartando tutti i rami che non si sono verificati.
+	 */
+	void OnPlayerAction();
+
+	/**
+	 * Restituisce il piano già calcolato per lo stato indicato.
+	 * @return false se il pondering non ha un piano valido per quella board.
+	 */
+	bool TakePlan(const FSimBoard& Board, FAITurnPlan& OutPlan);
+
+	// --- FTickableGameObject ---
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+
+	/** Tempo massimo (in millisecondi) dedicato al pondering in ogni frame */
+	UPROPERTY(EditAnywhere, Category = "AI")
+	float FrameBudgetMs = 2.0f;
+
+	/** Numero massimo di mosse del giocatore considerate per ogni unità */
+	UPROPERTY(EditAnywhere, Category = "AI")
+	int32 MaxMovesPerUnit = 3;
+
+	/** Limite di nodi dell'albero speculativo */
+	UPROPERTY(EditAnywhere, Category = "AI")
+	int32 MaxNodes = 256;
+
+private:
+
+	/** Nodo dell'albero speculativo */
+	struct FPonderNode
+	{
+		FSimBoard Board;
+		uint32 Hash = 0;
+		FAITurnPlan Plan;
+		bool bExpanded = false;
+		TArray<int32> Children;
+	};
+
+	/** Calcola il piano dell'IA per un nodo e genera i figli (mosse probabili del giocatore) */
+	void ExpandNode(int32 NodeIndex);
+
+	/** Aggiunge un nodo figlio se lo stato non è già presente nell'albero */
+	void AddChild(int32 ParentIndex, FSimBoard&& ChildBoard);
+
+	/** Rende radice il nodo indicato, mantenendo solo il suo sottoalbero */
+	void Reroot(int32 NodeIndex);
+
+	/** Ricostruisce l'albero partendo dallo stato reale della partita */
+	void ResetTree(FSimBoard&& RootBoard);
+
+	/** Riferimento al GameMode */
+	UPROPERTY()
+	AMyGameMode* GameMode;
+
+	/** Nodi dell'albero: Nodes[0] è sempre la radice */
+	TArray<FPonderNode> Nodes;
+
+	/** Indice del nodo con lo stato indicato (ogni stato compare una sola volta nell'albero) */
+	TMap<uint32, int32> NodeByHash;
+
+	/**
+	 * Nodi ancora da espandere, in ordine di ampiezza: i nodi prima di FrontierHead sono già stati estratti.
+	 * Si estrae avanzando la testa (O(1)); l'array si svuota quando la frontiera è esaurita.
+	 */
+	TArray<int32> Frontier;
+	int32 FrontierHead = 0;
+
+	bool HasFrontier() const { return FrontierHead < Frontier.Num(); }
+
+	/** Svuota la frontiera */
+	void ResetFrontier();
+
+	/** Indica se il pondering è attivo */
+	bool bIsPondering = false;
+};
@@ -0,0 +1,183 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "AIUtilityScorer.h"
+#include "InfluenceMap.h"
+#include "PAASchifanoFrancesco/Simulation/CombatAnalytics.h"
+#include "Math/VectorRegister.h"
+
+void FAIUtilityCandidates::Reset()
+{
+	Destination.Reset();
+	Target.Reset();
+	ExpectedDamage.Reset();
+	KillChance.Reset();
+	CounterRisk.Reset();
+	Distance.Reset();
+	Cover.Reset();
+	Threat.Reset();
+	Score.Reset();
+}
+
+int32 FAIUtilityCandidates::Add(int32 InDestination, int32 InTarget)
+{
+	Target.Add(InTarget);
+	ExpectedDamage.Add(0.f);
+	KillChance.Add(0.f);
+	CounterRisk.Add(0.f);
+	Distance.Add(0.f);
+	Cover.Add(0.f);
+	Threat.Add(0.f);
+	Score.Add(0.f);
+	return Destination.Add(InDestination);
+}
+
+void FAIUtilityCandidates::PadToVectorWidth()
+{
+	const int32 PaddedNum = Align(Num(), 4);
+	ExpectedDamage.SetNumZeroed(PaddedNum);
+	KillChance.SetNumZeroed(PaddedNum);
+	CounterRisk.SetNumZeroed(PaddedNum);
+	Distance.SetNumZeroed(PaddedNum);
+	Cover.SetNumZeroed(PaddedNum);
+	Threat.SetNumZeroed(PaddedNum);
+	Score.SetNumZeroed(PaddedNum);
+}
+
+/**
+ * Descrizione:
+ * Il danno è un intero uniforme in [MinDamage, MaxDamage]. Il danno atteso è limitato
+ * alla vita del bersaglio (il danno in eccesso non conta) e la probabilità di uccisione
+ * è la frazione di valori che azzerano la vita. Entrambi vengono letti dalle tabelle
+ * precalcolate di FCombatAnalytics.
+ */
+void FAIUtilityScorer::ComputeAttackOdds(int32 MinDamage, int32 MaxDamage, int32 TargetHealth, float& OutExpectedDamage, float& OutKillChance)
+{
+	const FDamageTable& Table = FCombatAnalytics::GetDamageTable(MinDamage, MaxDamage);
+	OutExpectedDamage = Table.GetExpectedDamage(TargetHealth);
+	OutKillChance = Table.GetKillChance(TargetHealth);
+}
+
+/**
+ * Descrizione:
+ * Un solo passaggio sulle tile raggiungibili. Per ogni destinazione vengono calcolate
+ * una volta sola distanza dal nemico più vicino e copertura, poi per ogni nemico attaccabile
+ * danno atteso, probabilità di uccisione e rischio di contrattacco.
+ *
+ * Il rischio segue la regola di FCombatResolver: se l'attaccante è uno Sniper e il bersaglio
+ * sopravvive, uno Sniper o un Brawler adiacente risponde con 1-3 danni. Il rischio è il danno
+ * atteso del contrattacco, limitato alla vita dell'unità.
+ */
+void FAIUtilityScorer::GenerateCandidates(const FSimBoard& Board, int32 UnitIndex, FAIUtilityCandidates& OutCandidates, const FInfluenceMap* Influence)
+{
+	OutCandidates.Reset();
+	if (!Board.Units.IsValidIndex(UnitIndex)) return;
+
+	const FSimUnit& Unit = Board.Units[UnitIndex];
+
+	TArray<int32> Destinations;
+	Board.GetReachableTiles(UnitIndex, Destinations);
+	Destinations.Insert(Unit.TileIndex, 0); // Anche restare fermi è un'opzione
+
+	// Nemici vivi, raccolti una volta sola
+	TArray<int32, TInlineAllocator<8>> Enemies;
+	Board.GetEnemyUnits(Unit.Team, Enemies);
+	if (Enemies.Num() == 0) return;
+
+	for (int32 Destination : Destinations)
+	{
+		// Distanza (in tile) dal nemico più vicino
+		int32 MinDistanceSquared = MAX_int32;
+		for (int32 Enemy : Enemies)
+		{
+			MinDistanceSquared = FMath::Min(MinDistanceSquared, Board.DistanceSquared(Destination, Board.Units[Enemy].TileIndex));
+		}
+		const float DestinationDistance = FMath::Sqrt(static_cast<float>(MinDistanceSquared));
+
+		// Copertura: frazione di tile adiacenti occupate da ostacoli
+		int32 Neighbors[4];
+		const int32 NeighborCount = Board.GetNeighbors(Destination, Neighbors);
+		int32 ObstacleCount = 4 - NeighborCount; // Il bordo della griglia conta come copertura
+		for (int32 i = 0; i < NeighborCount; ++i)
+		{
+			ObstacleCount += Board.Obstacles[Neighbors[i]] ? 1 : 0;
+		}
+		const float DestinationCover = ObstacleCount / 4.f;
+
+		// Danno atteso che le squadre nemiche possono infliggere su questa tile al prossimo turno
+		const float DestinationThreat = Influence ? Influence->GetEnemyThreat(Unit.Team, Destination) : 0.f;
+
+		// Solo movimento
+		const int32 MoveOnly = OutCandidates.Add(Destination, INDEX_NONE);
+		OutCandidates.Distance[MoveOnly] = DestinationDistance;
+		OutCandidates.Cover[MoveOnly] = DestinationCover;
+		OutCandidates.Threat[MoveOnly] = DestinationThreat;
+
+		// Movimento + attacco
+		for (int32 Enemy : Enemies)
+		{
+			if (!Board.CanAttackFrom(UnitIndex, Destination, Enemy)) continue;
+
+			const FSimUnit& Target = Board.Units[Enemy];
+			const int32 Candidate = OutCandidates.Add(Destination, Enemy);
+			OutCandidates.Distance[Candidate] = DestinationDistance;
+			OutCandidates.Cover[Candidate] = DestinationCover;
+			OutCandidates.Threat[Candidate] = DestinationThreat;
+
+			float ExpectedDamage = 0.f;
+			float KillChance = 0.f;
+			ComputeAttackOdds(Unit.MinDamage, Unit.MaxDamage, Target.Health, ExpectedDamage, KillChance);
+			OutCandidates.ExpectedDamage[Candidate] = ExpectedDamage;
+			OutCandidates.KillChance[Candidate] = KillChance;
+
+			const bool bCanCounter = FCombatAnalytics::CanCounter(Unit.Archetype, Target.Archetype, Board.DistanceSquared(Destination, Target.TileIndex) <= 1);
+			OutCandidates.CounterRisk[Candidate] = bCanCounter
+				? (1.f - KillChance) * FCombatAnalytics::GetCounterTable(Target.Archetype).GetExpectedDamage(Unit.Health) : 0.f;
+		}
+	}
+
+	OutCandidates.PadToVectorWidth();
+}
+
+/**
+ * Descrizione:
+ * Score = Wd * Danno + Wk * Uccisione - Wc * Contrattacco - Wdist * Distanza + Wcov * Copertura - Wt * Minaccia,
+ * calcolato su quattro candidati per iterazione.
+ */
+void FAIUtilityScorer::ScoreCandidates(FAIUtilityCandidates& Candidates, const FAIUtilityWeights& Weights)
+{
+	const VectorRegister4Float DamageWeight = VectorSetFloat1(Weights.ExpectedDamage);
+	const VectorRegister4Float KillWeight = VectorSetFloat1(Weights.KillChance);
+	const VectorRegister4Float RiskWeight = VectorSetFloat1(-Weights.CounterRisk);
+	const VectorRegister4Float DistanceWeight = VectorSetFloat1(-Weights.Distance);
+	const VectorRegister4Float CoverWeight = VectorSetFloat1(Weights.Cover);
+	const VectorRegister4Float ThreatWeight = VectorSetFloat1(-Weights.Threat);
+
+	const int32 PaddedNum = Candidates.Score.Num();
+	for (int32 Index = 0; Index < PaddedNum; Index += 4)
+	{
+		VectorRegister4Float Score = VectorMultiply(VectorLoadAligned(&Candidates.ExpectedDamage[Index]), DamageWeight);
+		Score = VectorMultiplyAdd(VectorLoadAligned(&Candidates.KillChance[Index]), KillWeight, Score);
+		Score = VectorMultiplyAdd(VectorLoadAligned(&Candidates.CounterRisk[Index]), RiskWeight, Score);
+		Score = VectorMultiplyAdd(VectorLoadAligned(&Candidates.Distance[Index]), DistanceWeight, Score);
+		Score = VectorMultiplyAdd(VectorLoadAligned(&Candidates.Cover[Index]), CoverWeight, Score);
+		Score = VectorMultiplyAdd(VectorLoadAligned(&Candidates.Threat[Index]), ThreatWeight, Score);
+		VectorStoreAligned(Score, &Candidates.Score[Index]);
+	}
+}
+
+int32 FAIUtilityScorer::FindBest(const FAIUtilityCandidates& Candidates)
+{
+	int32 Best = INDEX_NONE;
+	float BestScore = -MAX_flt;
+
+	// Solo le righe reali: il padding non è mai un candidato valido
+	for (int32 Index = 0; Index < Candidates.Num(); ++Index)
+	{
+		if (Candidates.Score[Index] > BestScore)
+		{
+			BestScore = Candidates.Score[Index];
+			Best = Index;
+		}
+	}
+	return Best;
+}
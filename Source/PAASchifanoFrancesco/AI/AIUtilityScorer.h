@@ -0,0 +1,91 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PAASchifanoFrancesco/Simulation/SimBoard.h"
+
+class FInfluenceMap;
+
+/**
+ * Descrizione:
+ * Pesi dei termini che compongono il punteggio di un candidato.
+ * Danno atteso e probabilità di uccisione aumentano il punteggio,
+ * rischio di contrattacco, distanza dal nemico e minaccia nemica sulla tile lo diminuiscono,
+ * la copertura lo aumenta.
+ */
+struct FAIUtilityWeights
+{
+	float ExpectedDamage = 1.0f;
+	float KillChance = 10.0f;
+	float CounterRisk = 1.5f;
+	float Distance = 0.25f;
+	float Cover = 0.5f;
+	float Threat = 0.5f;
+};
+
+/**
+ * Descrizione:
+ * Candidati (destinazione, bersaglio) di una singola unità in formato SoA:
+ * ogni caratteristica è un array contiguo, così il punteggio viene calcolato
+ * quattro candidati alla volta con i registri vettoriali.
+ * Le colonne float sono allineate e riempite fino a un multiplo di 4.
+ */
+struct FAIUtilityCandidates
+{
+	using FFloatColumn = TArray<float, TAlignedHeapAllocator<16>>;
+
+	/** Tile di destinazione (indice della board) */
+	TArray<int32> Destination;
+
+	/** Unità bersaglio (INDEX_NONE = solo movimento) */
+	TArray<int32> Target;
+
+	FFloatColumn ExpectedDamage;
+	FFloatColumn KillChance;
+	FFloatColumn CounterRisk;
+	FFloatColumn Distance;
+	FFloatColumn Cover;
+	FFloatColumn Threat;
+	FFloatColumn Score;
+
+	int32 Num() const { return Destination.Num(); }
+
+	void Reset();
+
+	/** Aggiunge un candidato con tutte le caratteristiche a zero e ne restituisce l'indice */
+	int32 Add(int32 InDestination, int32 InTarget);
+
+	/** Riempie le colonne float fino a un multiplo di 4 (le righe extra non vengono mai scelte) */
+	void PadToVectorWidth();
+};
+
+/**
+ * Classe: FAIUtilityScorer
+ * Descrizione:
+ * IA "Utility": invece di prendere il primo bersaglio o la prima tile valida, genera in un solo
+ * passaggio tutti i candidati (destinazione, bersaglio) di un'unità, assegna a ciascuno un punteggio
+ * pesato e sceglie il migliore.
+ */
+class PAASCHIFANOFRANCESCO_API FAIUtilityScorer
+{
+public:
+	/**
+	 * Genera tutti i candidati dell'unità: per ogni tile raggiungibile (compresa quella attuale)
+	 * un candidato di solo movimento e uno per ogni nemico attaccabile da quella tile.
+	 * Se è disponibile una mappa di minaccia, la colonna Threat viene letta da lì (O(1) per tile).
+	 */
+	static void GenerateCandidates(const FSimBoard& Board, int32 UnitIndex, FAIUtilityCandidates& OutCandidates, const FInfluenceMap* Influence = nullptr);
+
+	/** Calcola la colonna Score di tutti i candidati */
+	static void ScoreCandidates(FAIUtilityCandidates& Candidates, const FAIUtilityWeights& Weights);
+
+	/** Indice del candidato con punteggio massimo (INDEX_NONE se non ci sono candidati) */
+	static int32 FindBest(const FAIUtilityCandidates& Candidates);
+
+	/**
+	 * Statistiche di un attacco con danno uniforme in [MinDamage, MaxDamage]
+	 * contro un bersaglio con la vita indicata.
+	 */
+	static void ComputeAttackOdds(int32 MinDamage, int32 MaxDamage, int32 TargetHealth, float& OutExpectedDamage, float& OutKillChance);
+};
@@ -0,0 +1,281 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "CooperativePathfinder.h"
+#include "Algo/Reverse.h"
+
+void FCooperativePathfinder::Init(const FSimBoard& Board, int32 InWindowSize)
+{
+	DimX = Board.DimX;
+	DimY = Board.DimY;
+	Blocked = Board.Obstacles;
+	Blocked.CombineWithBitwiseOR(Board.UnitTiles, EBitwiseOperatorFlags::MaxSize);
+	WindowSize = FMath::Max(2, InWindowSize);
+	Agents.Reset();
+	Reservations.Reset();
+	FirstPriority = 0;
+}
+
+/**
+ * Descrizione:
+ * La partenza viene liberata nella mappa statica (l'unità se ne andrà) e prenotata per sempre:
+ * finché l'agente non viene pianificato le altre unità la considerano occupata.
+ */
+int32 FCooperativePathfinder::AddAgent(uint32 Owner, int32 StartTile, int32 GoalTile, int32 MaxMoves)
+{
+	Blocked[StartTile] = false;
+
+	FAgent& Agent = Agents.AddDefaulted_GetRef();
+	Agent.Owner = Owner;
+	Agent.GoalTile = GoalTile;
+	Agent.MaxMoves = MaxMoves;
+	Agent.Timeline.Add(StartTile);
+
+	const int32 StartOnly[1] = { StartTile };
+	Reservations.ReserveTimeline(Owner, StartOnly, 0);
+
+	return Agents.Num() - 1;
+}
+
+/**
+ * Descrizione:
+ * 1. Ogni agente (in ordine di priorità) rilascia le proprie prenotazioni, cerca il percorso della finestra
+ *    rispettando quelle degli altri e prenota il risultato.
+ * 2. Di ogni finestra viene confermata la prima metà: la seconda resta prenotata solo come indicazione
+ *    per gli agenti pianificati dopo e viene ricalcolata alla finestra successiva.
+ */
+bool FCooperativePathfinder::PlanWindow()
+{
+	const int32 Half = FMath::Max(1, WindowSize / 2);
+	bool bAllFinished = true;
+
+	for (int32 Offset = 0; Offset < Agents.Num(); ++Offset)
+	{
+		FAgent& Agent = Agents[(FirstPriority + Offset) % Agents.Num()];
+		if (Agent.bFinished) continue;
+
+		if (Agent.GoalDistance.Num() == 0)
+		{
+			BuildGoalDistance(Agent);
+
+			// Destinazione irraggiungibile entro il range: l'unità resta ferma
+			const int32 Distance = Agent.GoalDistance[Agent.Timeline[0]];
+			if (Distance == INDEX_NONE || Distance > Agent.MaxMoves)
+			{
+				Agent.bFinished = true;
+				continue;
+			}
+		}
+
+		Reservations.Release(Agent.Owner);
+		SearchWindow(Agent);
+		ReserveAgent(Agent);
+	}
+
+	for (FAgent& Agent : Agents)
+	{
+		if (Agent.bFinished) continue;
+
+		const int32 Commit = FMath::Min(Half, Agent.Tentative.Num());
+		for (int32 Index = 0; Index < Commit; ++Index)
+		{
+			Agent.MovesUsed += Agent.Tentative[Index] != Agent.Timeline.Last() ? 1 : 0;
+			Agent.Timeline.Add(Agent.Tentative[Index]);
+		}
+		Agent.Tentative.RemoveAt(0, Commit, EAllowShrinking::No);
+
+		if (Agent.bGoalInWindow && Agent.Tentative.Num() == 0)
+		{
+			Agent.bFinished = true;
+			Agent.bReachedGoal = true;
+		}
+		bAllFinished &= Agent.bFinished;
+	}
+
+	FirstPriority = Agents.Num() > 0 ? (FirstPriority + 1) % Agents.Num() : 0;
+	return bAllFinished;
+}
+
+void FCooperativePathfinder::PlanAll(int32 MaxWindows)
+{
+	for (int32 Window = 0; Window < MaxWindows; ++Window)
+	{
+		if (PlanWindow()) return;
+	}
+}
+
+/**
+ * Descrizione:
+ * Le attese finali (l'unità è ferma sull'ultima tile) non fanno parte del percorso:
+ * la prenotazione dell'ultima tile vale comunque per sempre.
+ */
+void FCooperativePathfinder::GetPath(int32 AgentIndex, TArray<int32>& OutPath) const
+{
+	const FAgent& Agent = Agents[AgentIndex];
+
+	OutPath.Reset();
+	OutPath.Append(Agent.Timeline.GetData() + 1, Agent.Timeline.Num() - 1);
+	OutPath.Append(Agent.Tentative);
+
+	const int32 Start = Agent.Timeline[0];
+	while (OutPath.Num() > 0 && OutPath.Last() == (OutPath.Num() > 1 ? OutPath[OutPath.Num() - 2] : Start))
+	{
+		OutPath.Pop(EAllowShrinking::No);
+	}
+}
+
+void FCooperativePathfinder::BuildGoalDistance(FAgent& Agent) const
+{
+	Agent.GoalDistance.Init(INDEX_NONE, DimX * DimY);
+
+	TArray<int32> Queue;
+	Queue.Reserve(DimX * DimY);
+	Queue.Add(Agent.GoalTile);
+	Agent.GoalDistance[Agent.GoalTile] = 0;
+
+	int32 Neighbors[4];
+	for (int32 Head = 0; Head < Queue.Num(); ++Head)
+	{
+		const int32 Current = Queue[Head];
+		const int32 Count = GetNeighbors(Current, Neighbors);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const int32 Next = Neighbors[i];
+			if (Agent.GoalDistance[Next] != INDEX_NONE || Blocked[Next]) continue;
+
+			Agent.GoalDistance[Next] = Agent.GoalDistance[Current] + 1;
+			Queue.Add(Next);
+		}
+	}
+}
+
+/**
+ * Descrizione:
+ * Stati (tile, passo) con passo relativo da 0 a WindowSize. Azioni: attesa o spostamento su una tile adiacente,
+ * ciascuna con costo di un passo. Stima: distanza vera dalla destinazione (ammissibile, le altre unità
+ * possono solo allungare il percorso).
+ * La ricerca termina quando:
+ * - raggiunge la destinazione e può restarci per sempre (costo = passi impiegati);
+ * - oppure arriva al bordo della finestra (costo = WindowSize + distanza residua).
+ * Gli stati da cui la destinazione non è più raggiungibile entro il range di movimento vengono scartati;
+ * a parità di (tile, passo) viene espanso solo il primo stato, quindi il conteggio degli spostamenti è
+ * quello del percorso più rapido (approssimazione accettabile per i range di movimento del gioco).
+ */
+void FCooperativePathfinder::SearchWindow(FAgent& Agent)
+{
+	struct FNode
+	{
+		int32 Tile;
+		int32 Depth;
+		int32 Moves;
+		int32 Parent;
+	};
+
+	struct FOpenEntry
+	{
+		int32 Cost;
+		int32 Depth;
+		int32 Node;
+	};
+
+	const int32 NumTiles = DimX * DimY;
+	const int32 FirstStep = Agent.Timeline.Num() - 1;
+	const int32 StartTile = Agent.Timeline.Last();
+	const int32 Budget = Agent.MaxMoves - Agent.MovesUsed;
+
+	TArray<FNode> Nodes;
+	TArray<FOpenEntry> Open;
+	TSet<int32> Closed;
+
+	// Costo minore prima; a parità, lo stato più profondo (più vicino alla fine della ricerca)
+	const auto OpenOrder = [](const FOpenEntry& A, const FOpenEntry& B)
+	{
+		return A.Cost != B.Cost ? A.Cost < B.Cost : A.Depth > B.Depth;
+	};
+
+	Nodes.Add({ StartTile, 0, 0, INDEX_NONE });
+	Open.HeapPush({ Agent.GoalDistance[StartTile], 0, 0 }, OpenOrder);
+
+	int32 Found = INDEX_NONE;
+	Agent.bGoalInWindow = false;
+
+	int32 Neighbors[5];
+	while (Open.Num() > 0)
+	{
+		FOpenEntry Entry;
+		Open.HeapPop(Entry, OpenOrder, EAllowShrinking::No);
+		const FNode Node = Nodes[Entry.Node];
+
+		bool bAlreadyClosed = false;
+		Closed.Add(Node.Depth * NumTiles + Node.Tile, &bAlreadyClosed);
+		if (bAlreadyClosed) continue;
+
+		if (Node.Tile == Agent.GoalTile && Reservations.IsFree(Agent.Owner, Node.Tile, FirstStep + Node.Depth, MAX_int32))
+		{
+			Found = Entry.Node;
+			Agent.bGoalInWindow = true;
+			break;
+		}
+		if (Node.Depth >= WindowSize)
+		{
+			Found = Entry.Node;
+			break;
+		}
+
+		// Attesa sulla tile corrente, poi le tile adiacenti
+		Neighbors[0] = Node.Tile;
+		const int32 Count = 1 + GetNeighbors(Node.Tile, Neighbors + 1);
+		const int32 NextStep = FirstStep + Node.Depth + 1;
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const int32 Next = Neighbors[i];
+			const int32 Distance = Agent.GoalDistance[Next];
+			if (Distance == INDEX_NONE) continue;
+
+			const int32 Moves = Node.Moves + (Next != Node.Tile ? 1 : 0);
+			if (Moves + Distance > Budget) continue;
+			if (Closed.Contains((Node.Depth + 1) * NumTiles + Next)) continue;
+			if (!Reservations.IsFree(Agent.Owner, Next, NextStep, NextStep)) continue;
+
+			const int32 Child = Nodes.Add({ Next, Node.Depth + 1, Moves, Entry.Node });
+			Open.HeapPush({ Node.Depth + 1 + Distance, Node.Depth + 1, Child }, OpenOrder);
+		}
+	}
+
+	Agent.Tentative.Reset();
+	if (Found == INDEX_NONE)
+	{
+		// Nessuno stato valido (non dovrebbe succedere: la propria tile è prenotata per sempre): l'unità aspetta
+		Agent.Tentative.Init(StartTile, FMath::Max(1, WindowSize / 2));
+		return;
+	}
+
+	for (int32 Index = Found; Nodes[Index].Parent != INDEX_NONE; Index = Nodes[Index].Parent)
+	{
+		Agent.Tentative.Add(Nodes[Index].Tile);
+	}
+	Algo::Reverse(Agent.Tentative);
+}
+
+void FCooperativePathfinder::ReserveAgent(const FAgent& Agent)
+{
+	TArray<int32, TInlineAllocator<32>> Steps;
+	Steps.Append(Agent.Timeline);
+	Steps.Append(Agent.Tentative);
+	Reservations.ReserveTimeline(Agent.Owner, Steps, 0);
+}
+
+/** Stesso ordine di FSimBoard::GetNeighbors (giù, su, destra, sinistra) */
+int32 FCooperativePathfinder::GetNeighbors(int32 Tile, int32 OutNeighbors[4]) const
+{
+	const int32 Row = Tile / DimX;
+	const int32 Col = Tile % DimX;
+	int32 Count = 0;
+
+	if (Row + 1 < DimY && !Blocked[Tile + DimX]) OutNeighbors[Count++] = Tile + DimX;
+	if (Row - 1 >= 0 && !Blocked[Tile - DimX])   OutNeighbors[Count++] = Tile - DimX;
+	if (Col + 1 < DimX && !Blocked[Tile + 1])    OutNeighbors[Count++] = Tile + 1;
+	if (Col - 1 >= 0 && !Blocked[Tile - 1])      OutNeighbors[Count++] = Tile - 1;
+
+	return Count;
+}
@@ -0,0 +1,96 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PAASchifanoFrancesco/Simulation/SimBoard.h"
+#include "PAASchifanoFrancesco/Units/MovementReservationTable.h"
+
+/**
+ * Classe: FCooperativePathfinder
+ * Descrizione:
+ * Pianificazione congiunta dei percorsi di più unità che si muovono nello stesso momento
+ * (WHCA*, Windowed Hierarchical Cooperative A*).
+ * Ogni unità cerca con A* nello spazio (tile, passo) evitando le prenotazioni delle altre, registrate in una
+ * FMovementReservationTable con le stesse regole del MovementManager: i percorsi trovati possono contenere
+ * attese (la stessa tile ripetuta) e vengono eseguiti senza conflitti.
+ * - Finestra: la ricerca cooperativa guarda solo WindowSize passi avanti; oltre la finestra il costo residuo
+ *   è la distanza vera dalla destinazione sulla mappa statica (BFS inversa per agente, senza le altre unità).
+ * - Incrementale: ogni PlanWindow conferma metà finestra per tutti gli agenti e ruota la priorità.
+ *   Una finestra piccola costa meno CPU per chiamata, una grande evita più attese inutili.
+ */
+class PAASCHIFANOFRANCESCO_API FCooperativePathfinder
+{
+public:
+	/** Mappa statica dalla board: ostacoli e tile occupate (le partenze degli agenti vengono liberate in AddAgent) */
+	void Init(const FSimBoard& Board, int32 InWindowSize);
+
+	/**
+	 * Aggiunge un'unità da muovere verso GoalTile con al massimo MaxMoves spostamenti (le attese non contano).
+	 * @return indice dell'agente
+	 */
+	int32 AddAgent(uint32 Owner, int32 StartTile, int32 GoalTile, int32 MaxMoves);
+
+	/** Pianifica una finestra per tutti gli agenti non ancora arrivati; true quando hanno finito tutti */
+	bool PlanWindow();
+
+	/** Ripete PlanWindow fino a quando tutti gli agenti sono arrivati, al massimo MaxWindows volte */
+	void PlanAll(int32 MaxWindows);
+
+	/**
+	 * Percorso pianificato, esclusa la partenza: la i-esima tile viene occupata al passo i + 1
+	 * e una tile ripetuta è un passo di attesa. Vuoto se l'unità resta ferma.
+	 */
+	void GetPath(int32 AgentIndex, TArray<int32>& OutPath) const;
+
+	/** true se il percorso dell'agente termina sulla destinazione richiesta */
+	bool HasReachedGoal(int32 AgentIndex) const { return Agents[AgentIndex].bFinished && Agents[AgentIndex].bReachedGoal; }
+
+	int32 GetWindowSize() const { return WindowSize; }
+
+private:
+	struct FAgent
+	{
+		uint32 Owner = 0;
+		int32 GoalTile = INDEX_NONE;
+		int32 MaxMoves = 0;
+
+		/** Tile a ogni passo già confermata (Timeline[0] è la partenza) */
+		TArray<int32> Timeline;
+
+		/** Resto dell'ultima finestra: prenotato, ma ripianificato alla finestra successiva */
+		TArray<int32> Tentative;
+
+		/** Distanza vera dalla destinazione per ogni tile (INDEX_NONE se irraggiungibile) */
+		TArray<int32> GoalDistance;
+
+		int32 MovesUsed = 0;
+		bool bGoalInWindow = false;
+		bool bReachedGoal = false;
+		bool bFinished = false;
+	};
+
+	/** BFS inversa dalla destinazione sulla mappa statica */
+	void BuildGoalDistance(FAgent& Agent) const;
+
+	/** A* spazio-temporale su una finestra a partire dall'ultima tile confermata; riempie Tentative */
+	void SearchWindow(FAgent& Agent);
+
+	/** Prenota Timeline e Tentative dell'agente a partire dal passo 0 */
+	void ReserveAgent(const FAgent& Agent);
+
+	int32 GetNeighbors(int32 Tile, int32 OutNeighbors[4]) const;
+
+	int32 DimX = 0;
+	int32 DimY = 0;
+
+	/** Un bit per tile non attraversabile (ostacoli e unità che non fanno parte del gruppo) */
+	TBitArray<> Blocked;
+
+	int32 WindowSize = 8;
+	TArray<FAgent> Agents;
+	FMovementReservationTable Reservations;
+
+	/** Primo agente pianificato nella prossima finestra (la priorità ruota) */
+	int32 FirstPriority = 0;
+};
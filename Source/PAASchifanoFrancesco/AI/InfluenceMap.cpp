@@ -0,0 +1,181 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "InfluenceMap.h"
+
+void FInfluenceMap::Reset()
+{
+	Footprints.Reset();
+	for (TArray<float>& Layer : Layers)
+	{
+		Layer.Reset();
+	}
+	TotalLayer.Reset();
+	DimX = 0;
+	DimY = 0;
+	Obstacles.Reset();
+	LastRecomputedCount = 0;
+}
+
+/**
+ * Descrizione:
+ * 1. Se griglia od ostacoli sono cambiati, ricostruisce tutto da zero.
+ * 2. Rimuove le impronte delle unità morte o non più presenti.
+ * 3. Ricalcola le impronte delle unità nuove o che hanno cambiato tile.
+ */
+void FInfluenceMap::Update(const FSimBoard& Board)
+{
+	LastRecomputedCount = 0;
+
+	if (Board.DimX != DimX || Board.DimY != DimY || Board.Obstacles != Obstacles)
+	{
+		Reset();
+		DimX = Board.DimX;
+		DimY = Board.DimY;
+		Obstacles = Board.Obstacles;
+		for (TArray<float>& Layer : Layers)
+		{
+			Layer.SetNumZeroed(Board.NumTiles());
+		}
+		TotalLayer.SetNumZeroed(Board.NumTiles());
+	}
+
+	// Unità ancora presenti e vive in questa board
+	TSet<int32> AliveIds;
+	for (const FSimUnit& Unit : Board.Units)
+	{
+		if (Unit.IsAlive())
+		{
+			AliveIds.Add(Unit.UnitId);
+		}
+	}
+
+	for (auto It = Footprints.CreateIterator(); It; ++It)
+	{
+		if (!AliveIds.Contains(It.Key()))
+		{
+			ApplyFootprint(It.Value(), -1.f);
+			It.RemoveCurrent();
+		}
+	}
+
+	for (const FSimUnit& Unit : Board.Units)
+	{
+		if (!Unit.IsAlive()) continue;
+
+		FFootprint* Existing = Footprints.Find(Unit.UnitId);
+		if (Existing && Existing->TileIndex == Unit.TileIndex) continue;
+
+		if (Existing)
+		{
+			ApplyFootprint(*Existing, -1.f);
+		}
+
+		FFootprint& Footprint = Footprints.FindOrAdd(Unit.UnitId);
+		ComputeFootprint(Board, Unit, Footprint);
+		ApplyFootprint(Footprint, 1.f);
+		++LastRecomputedCount;
+	}
+}
+
+float FInfluenceMap::GetMaxThreat(int32 FromTeam) const
+{
+	float MaxThreat = 0.f;
+	for (float Threat : Layers[FromTeam])
+	{
+		MaxThreat = FMath::Max(MaxThreat, Threat);
+	}
+	return MaxThreat;
+}
+
+float FInfluenceMap::GetMaxEnemyThreat(int32 Team) const
+{
+	float MaxThreat = 0.f;
+	for (int32 TileIndex = 0; TileIndex < TotalLayer.Num(); ++TileIndex)
+	{
+		MaxThreat = FMath::Max(MaxThreat, TotalLayer[TileIndex] - Layers[Team][TileIndex]);
+	}
+	return MaxThreat;
+}
+
+/**
+ * Descrizione:
+ * BFS di movimento che considera solo gli ostacoli (le unità si spostano, quindi non vengono
+ * considerate: così l'impronta non dipende dalle altre unità e non va invalidata quando si muovono).
+ * Ogni tile raggiunta viene poi dilatata con il raggio d'attacco euclideo.
+ */
+void FInfluenceMap::ComputeFootprint(const FSimBoard& Board, const FSimUnit& Unit, FFootprint& OutFootprint) const
+{
+	OutFootprint.TileIndex = Unit.TileIndex;
+	OutFootprint.Team = Unit.Team;
+	OutFootprint.Value = (Unit.MinDamage + Unit.MaxDamage) * 0.5f;
+	OutFootprint.Tiles.Reset();
+
+	if (!Board.IsValidTile(Unit.TileIndex)) return;
+
+	// 1. Tile raggiungibili (compresa quella di partenza)
+	TArray<int32> Distance;
+	Distance.Init(INDEX_NONE, Board.NumTiles());
+	TArray<int32> Reachable;
+	Reachable.Add(Unit.TileIndex);
+	Distance[Unit.TileIndex] = 0;
+
+	for (int32 Head = 0; Head < Reachable.Num(); ++Head)
+	{
+		const int32 Current = Reachable[Head];
+		if (Distance[Current] >= Unit.MovementRange) continue;
+
+		int32 Neighbors[4];
+		const int32 Count = Board.GetNeighbors(Current, Neighbors);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const int32 Next = Neighbors[i];
+			if (Distance[Next] != INDEX_NONE || Board.Obstacles[Next]) continue;
+
+			Distance[Next] = Distance[Current] + 1;
+			Reachable.Add(Next);
+		}
+	}
+
+	// 2. Dilatazione con il disco del raggio d'attacco
+	const int32 Range = Unit.AttackRange;
+	TBitArray<> Threatened(false, Board.NumTiles());
+
+	for (int32 Origin : Reachable)
+	{
+		const int32 OriginRow = Board.GetRow(Origin);
+		const int32 OriginCol = Board.GetColumn(Origin);
+
+		for (int32 DY = -Range; DY <= Range; ++DY)
+		{
+			const int32 Row = OriginRow + DY;
+			if (Row < 0 || Row >= Board.DimY) continue;
+
+			// Semi-larghezza del disco su questa riga
+			const int32 HalfWidth = FMath::FloorToInt(FMath::Sqrt(static_cast<float>(Range * Range - DY * DY)));
+			const int32 MinCol = FMath::Max(0, OriginCol - HalfWidth);
+			const int32 MaxCol = FMath::Min(Board.DimX - 1, OriginCol + HalfWidth);
+
+			for (int32 Col = MinCol; Col <= MaxCol; ++Col)
+			{
+				Threatened[Row * Board.DimX + Col] = true;
+			}
+		}
+	}
+
+	for (TConstSetBitIterator<> It(Threatened); It; ++It)
+	{
+		OutFootprint.Tiles.Add(It.GetIndex());
+	}
+}
+
+void FInfluenceMap::ApplyFootprint(const FFootprint& Footprint, float Sign)
+{
+	TArray<float>& Layer = Layers[Footprint.Team];
+	const float Delta = Footprint.Value * Sign;
+
+	for (int32 TileIndex : Footprint.Tiles)
+	{
+		Layer[TileIndex] += Delta;
+		TotalLayer[TileIndex] += Delta;
+	}
+}
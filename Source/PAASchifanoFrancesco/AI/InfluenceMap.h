@@ -0,0 +1,81 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PAASchifanoFrancesco/Simulation/SimBoard.h"
+
+/**
+ * Classe: FInfluenceMap
+ * Descrizione:
+ * Mappe di minaccia per squadra. Per ogni tile, il layer di una squadra contiene la somma
+ * del danno atteso che le sue unità potrebbero infliggere su quella tile nel turno successivo
+ * (movimento + raggio d'attacco). Un layer totale somma tutte le squadre: la minaccia nemica
+ * per una squadra è il totale meno il suo layer, O(1) qualunque sia il numero di squadre.
+ *
+ * Ogni unità contribuisce con un'"impronta" (tile raggiungibili entro MovementRange, dilatate
+ * del raggio d'attacco). Le impronte dipendono solo da posizione e ostacoli, quindi Update()
+ * ricalcola soltanto le unità che si sono mosse, sono morte o sono nuove.
+ * La lettura di una tile è O(1).
+ */
+class PAASCHIFANOFRANCESCO_API FInfluenceMap
+{
+public:
+	/** Svuota tutti i layer e le impronte */
+	void Reset();
+
+	/** Allinea la mappa alla board, ricalcolando solo le unità cambiate */
+	void Update(const FSimBoard& Board);
+
+	/** Minaccia che le unità della squadra indicata esercitano sulla tile */
+	float GetThreat(int32 FromTeam, int32 TileIndex) const
+	{
+		const TArray<float>& Layer = Layers[FromTeam];
+		return Layer.IsValidIndex(TileIndex) ? Layer[TileIndex] : 0.f;
+	}
+
+	/** Minaccia che tutte le squadre nemiche esercitano sulla tile */
+	float GetEnemyThreat(int32 Team, int32 TileIndex) const
+	{
+		return TotalLayer.IsValidIndex(TileIndex) ? TotalLayer[TileIndex] - Layers[Team][TileIndex] : 0.f;
+	}
+
+	/** Minaccia massima del layer (usata per normalizzare l'overlay) */
+	float GetMaxThreat(int32 FromTeam) const;
+
+	/** Minaccia nemica massima per la squadra (overlay del player con più squadre IA) */
+	float GetMaxEnemyThreat(int32 Team) const;
+
+	/** Numero di impronte ricalcolate dall'ultimo Update (utile per il profiling) */
+	int32 GetLastRecomputedCount() const { return LastRecomputedCount; }
+
+private:
+	/** Contributo di una singola unità */
+	struct FFootprint
+	{
+		int32 TileIndex = INDEX_NONE;
+		float Value = 0.f;
+		int32 Team = 0;
+		TArray<int32> Tiles;
+	};
+
+	/** Calcola le tile minacciate da un'unità */
+	void ComputeFootprint(const FSimBoard& Board, const FSimUnit& Unit, FFootprint& OutFootprint) const;
+
+	/** Somma (Sign = 1) o sottrae (Sign = -1) un'impronta dal layer della sua squadra e dal totale */
+	void ApplyFootprint(const FFootprint& Footprint, float Sign);
+
+	/** Impronte correnti, indicizzate per UnitId */
+	TMap<int32, FFootprint> Footprints;
+
+	/** Layer di minaccia per squadra e somma di tutti i layer */
+	TArray<float> Layers[FSimBoard::MaxTeams];
+	TArray<float> TotalLayer;
+
+	/** Dimensioni e ostacoli con cui sono state calcolate le impronte */
+	int32 DimX = 0;
+	int32 DimY = 0;
+	TBitArray<> Obstacles;
+
+	int32 LastRecomputedCount = 0;
+};
@@ -33,10 +33,23 @@
 *   - Attacco: prova sempre prima ad attaccare direttamente se possibile.
 *   - Movimento: se non può attaccare subito, si sposta verso il nemico più vicino
 *               usando un pathfinding ottimizzato.
+*   - Lungo il percorso si ferma sulla tile che bilancia avanzamento, possibilità di attacco e
+*     minaccia del player (FInfluenceMap), invece di entrare a occhi chiusi nel raggio di uno Sniper.
 *   - Dopo il movimento, prova di nuovo ad attaccare.
 *   - Questo comportamento simula un'IA più strategica e aggressiva, che usa il proprio turno in modo efficiente.
+*   - Il piano del turno (percorsi compresi) viene calcolato da FAIPlanner; se il pondering (UAIPonderer)
+*     lo ha già preparato durante il turno del player, viene riutilizzato senza ricalcolarlo.
+*
+* ► IA UTILITY:
+*   - Genera tutte le coppie (destinazione, bersaglio) dell'unità e assegna a ciascuna un punteggio
+*     (danno atteso, probabilità di uccisione, rischio di contrattacco, distanza, copertura,
+*     minaccia nemica sulla destinazione).
+*   - Esegue la coppia con il punteggio più alto (FAIUtilityScorer).
 *
 * Questi comportamenti sono implementati nel metodo ProcessNextAIUnit() e variano in base al valore di GameMode->AILevel.
+*
+* Le decisioni (FAIPlanner) sono separate dalla presentazione: i delay tra un'azione e l'altra
+* sono scalati da GameMode->AIPlaybackScale e con valore 0 il turno dell'AI viene risolto istantaneamente.
 */
 
 #include "BattleManager.h"
@@ -47,6 +60,8 @@
 #include "PAASchifanoFrancesco/Grid/Tile.h"
 #include "PAASchifanoFrancesco/Units/UnitMovementManager.h"
 #include "PAASchifanoFrancesco/UI/StatusGameWidget.h"
+#include "PAASchifanoFrancesco/AI/AIPonderer.h"
+#include "PAASchifanoFrancesco/AI/CooperativePathfinder.h"
 #include "Kismet/GameplayStatics.h"
 
 /*
@@ -100,13 +115,13 @@ void ABattleManager::StartBattle()
 
     if (GameMode && GameMode->GetStatusGameWidget()) // Se il widget dello stato è disponibile
     {
-        for (AUnitBase* Unit : GameMode->PlayerUnits) // Aggiunge le unità del giocatore al widget
-        {
-            GameMode->GetStatusGameWidget()->AddUnitStatus(Unit);
-        }
-        for (AUnitBase* Unit : GameMode->AIUnits) // Aggiunge le unità AI al widget
+        const FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+        for (int32 Team = 0; Team < Registry.GetNumTeams(); ++Team) // Aggiunge al widget le unità di ogni squadra
         {
-            GameMode->GetStatusGameWidget()->AddUnitStatus(Unit);
+            for (AUnitBase* Unit : Registry.GetUnits(Team))
+            {
+                GameMode->GetStatusGameWidget()->AddUnitStatus(Unit);
+            }
         }
     }
 }
@@ -132,11 +147,39 @@ void ABattleManager::PrepareAITurn()
 {
     if (!GameMode || !TurnManager || !GridManager) return; // Controllo di sicurezza
 
-    UE_LOG(LogTemp, Warning, TEXT("AI inizia il suo turno..."));
+    const int32 Team = TurnManager->GetCurrentTeam(); // Squadra IA di turno
+    const FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+    UE_LOG(LogTemp, Warning, TEXT("%s inizia il suo turno..."), *FSimBoard::GetTeamName(Team));
 
-    AIUnitsToProcess = GameMode->AIUnits; // Copia le unità AI da processare
+    AIUnitsToProcess = Registry.GetHandles(Team); // Handle delle unità AI da processare
     CurrentAIIndex = 0; // Inizia dal primo indice
 
+    // AI Hard: usa il piano pre-calcolato dal pondering se corrisponde allo stato reale,
+    // altrimenti lo calcola adesso sulla board simulata
+    CurrentPlan = FAITurnPlan();
+    if (GameMode->AILevel == EAILevel::Hard)
+    {
+        const FSimBoard Board = FSimBoard::FromWorld(GameMode);
+
+        // Il pondering prepara solo la risposta della squadra che gioca subito dopo il player
+        UAIPonderer* Ponderer = Team == FUnitRegistry::AITeam ? GameMode->GetAIPonderer() : nullptr;
+
+        if (!Ponderer || !Ponderer->TakePlan(Board, CurrentPlan))
+        {
+            FInfluenceMap& Influence = GameMode->GetInfluenceMap();
+            Influence.Update(Board);
+            CurrentPlan = FAIPlanner::PlanHardTurn(Board, Team, &Influence);
+        }
+        PlannedEnemyUnits = Registry.Num() - Registry.Num(Team);
+
+        // Squadra numerosa: i movimenti partono tutti insieme (tabella di prenotazione del MovementManager)
+        if (GameMode->ConcurrentMoveMinUnits > 0 && AIUnitsToProcess.Num() >= GameMode->ConcurrentMoveMinUnits)
+        {
+            ProcessHardTurnConcurrently();
+            return;
+        }
+    }
+
     ProcessNextAIUnit(); // Avvia la gestione dell'unità
 }
 
@@ -151,9 +194,15 @@ void ABattleManager::PrepareAITurn()
 *    - Muoversi casualmente (Easy)
 *    - Muoversi verso il nemico più vicino e attaccare (Hard)
 * 4. Passa alla prossima unità o termina il turno AI
+*
+* I delay sono solo presentazione: vengono scalati da AIPlaybackScale e con velocità 0
+* le decisioni vengono eseguite subito, senza highlight.
 */
 void ABattleManager::ProcessNextAIUnit()
 {
+    // Un contrattacco può eliminare l'ultima unità AI: la partita è già finita
+    if (GameMode->GetCurrentGamePhase() == EGamePhase::EGameOver) return;
+
     // Se tutte le unità AI sono già state processate, termina il turno
     if (CurrentAIIndex >= AIUnitsToProcess.Num())
     {
@@ -162,136 +211,397 @@ void ABattleManager::ProcessNextAIUnit()
         return;
     }
 
-    // Recupera l'unità AI corrente
-    AUnitBase* CurrentUnit = AIUnitsToProcess[CurrentAIIndex];
+    // Recupera l'unità AI corrente (nulla se è morta durante il turno, es. per un contrattacco)
+    AUnitBase* CurrentUnit = GameMode->GetUnitRegistry().Get(AIUnitsToProcess[CurrentAIIndex]);
 
     // Se l'unità è nulla, non può agire o ha già attaccato, passa alla successiva
     if (!CurrentUnit || !CurrentUnit->CanAct() || CurrentUnit->GetCurrentAction() == EUnitAction::Attacked)
     {
-        CurrentAIIndex++;
-        ProcessNextAIUnit(); // Passa alla prossima unità
+        AdvanceToNextAIUnit(); // Passa alla prossima unità
         return;
     }
 
-    // Mostra la griglia di movimento per l’unità corrente
-    GridManager->HighlightMovementTiles(CurrentUnit);
+    const bool bShowHighlights = GameMode->AIPlaybackScale > 0.f;
 
-    // Timer: mostra la griglia di movimento per 3 secondi
-    FTimerHandle MovementTimerHandle;
-    GameMode->GetWorld()->GetTimerManager().SetTimer(MovementTimerHandle, [this, CurrentUnit]()
+    // Mostra la griglia di movimento per l’unità corrente
+    if (bShowHighlights)
     {
-        GridManager->ClearHighlights(); // Rimuove highlight movimento
+        GridManager->HighlightMovementTiles(CurrentUnit);
+    }
 
-        // Mostra la griglia di attacco
-        GridManager->HighlightAttackGrid(CurrentUnit);
+    // Mostra la griglia di movimento per 3 secondi
+    ScheduleAIStep([this, CurrentUnit, bShowHighlights]()
+    {
+        if (bShowHighlights)
+        {
+            GridManager->ClearHighlights(); // Rimuove highlight movimento
+            GridManager->HighlightAttackGrid(CurrentUnit); // Mostra la griglia di attacco
+        }
 
-        // Timer: mostra la griglia d'attacco per 3 secondi
-        FTimerHandle AttackTimerHandle;
-        GameMode->GetWorld()->GetTimerManager().SetTimer(AttackTimerHandle, [this, CurrentUnit]()
+        // Mostra la griglia d'attacco per 3 secondi
+        ScheduleAIStep([this, CurrentUnit, bShowHighlights]()
         {
-            GridManager->ClearHighlights(); // Rimuove highlight attacco
+            if (bShowHighlights)
+            {
+                GridManager->ClearHighlights(); // Rimuove highlight attacco
+            }
 
-            // ---- AI LEVEL: EASY ----
-            if (GameMode && GameMode->AILevel == EAILevel::Easy)
+            if (GameMode->AILevel == EAILevel::Easy)
+            {
+                ProcessEasyAIUnit(CurrentUnit);
+            }
+            else if (GameMode->AILevel == EAILevel::Hard)
+            {
+                ProcessHardAIUnit(CurrentUnit);
+            }
+            else if (GameMode->AILevel == EAILevel::Utility)
             {
-                TArray<ATile*> ReachableTiles = GridManager->GetValidMovementTiles(CurrentUnit);
+                ProcessUtilityAIUnit(CurrentUnit);
+            }
+        }, 3.0f); // Delay attacco
 
-                if (ReachableTiles.Num() <= 1) // Nessuna tile utile oltre quella in cui si trova
-                {
-                    UE_LOG(LogTemp, Warning, TEXT("AI Easy: nessuna tile disponibile per muoversi"));
-
-                    if (!TryAIAttack(CurrentUnit))
-                    {
-                        // Non può nemmeno attaccare → salta
-                        FTimerHandle SkipHandle;
-                        GameMode->GetWorld()->GetTimerManager().SetTimer(SkipHandle, [this]()
-                        {
-                            CurrentAIIndex++;
-                            ProcessNextAIUnit();
-                        }, 1.0f, false);
-                    }
-                    else
-                    {
-                        // Ha attaccato, va comunque avanti
-                        CurrentAIIndex++;
-                        ProcessNextAIUnit();
-                    }
-                    return;
-                }
+    }, 3.0f); // Delay movimento
+}
+
+/*
+* Descrizione:
+* ---- AI LEVEL: EASY ----
+* La decisione (tile casuale e sorteggio dell'attacco) viene presa da FAIPlanner::PlanEasyUnit;
+* qui viene solo eseguita, con i tempi della presentazione.
+*/
+void ABattleManager::ProcessEasyAIUnit(AUnitBase* CurrentUnit)
+{
+    FSimBoard Board = FSimBoard::FromWorld(GameMode);
+    const int32 UnitIndex = Board.FindUnitByActor(CurrentUnit);
 
-                // Movimento possibile → decidi se muovere o muovere+attaccare
-                int32 Choice = FMath::RandRange(0, 1); // 0 = solo muovi, 1 = muovi+attacca
+    if (UnitIndex == INDEX_NONE)
+    {
+        AdvanceToNextAIUnit();
+        return;
+    }
 
-                TryAIRandomMove(CurrentUnit); // Effettua movimento random
+    FAIUnitOrder Order;
+    FAIPlanner::PlanEasyUnit(Board, UnitIndex, GameMode->GetMatchRandom().AI, Order);
 
-                if (Choice == 1)
-                {
-                    // Attende 3s e poi prova ad attaccare
-                    FTimerHandle EasyAttackTimer;
-                    GameMode->GetWorld()->GetTimerManager().SetTimer(EasyAttackTimer, [this, CurrentUnit]()
-                    {
-                        GridManager->HighlightAttackGrid(CurrentUnit);
-                        TryAIAttack(CurrentUnit);
-
-                        FTimerHandle AfterAttack;
-                        GameMode->GetWorld()->GetTimerManager().SetTimer(AfterAttack, [this]()
-                        {
-                            GridManager->ClearHighlights();
-                            CurrentAIIndex++;
-                            ProcessNextAIUnit();
-                        }, 3.0f, false);
-                    }, 3.0f, false);
-                    return;
-                }
-                else
-                {
-                    UE_LOG(LogTemp, Warning, TEXT("AI Easy: solo movimento"));
-
-                    FTimerHandle EasyEndTimer;
-                    GameMode->GetWorld()->GetTimerManager().SetTimer(EasyEndTimer, [this]()
-                    {
-                        CurrentAIIndex++;
-                        ProcessNextAIUnit();
-                    }, 3.0f, false);
-                    return;
-                }
+    if (Order.Path.Num() == 0) // Nessuna tile utile oltre quella in cui si trova
+    {
+        UE_LOG(LogTemp, Warning, TEXT("AI Easy: nessuna tile disponibile per muoversi"));
+
+        if (!TryAIAttack(CurrentUnit))
+        {
+            // Non può nemmeno attaccare → salta
+            ScheduleAIStep([this]() { AdvanceToNextAIUnit(); }, 1.0f);
+        }
+        else
+        {
+            // Ha attaccato, va comunque avanti
+            AdvanceToNextAIUnit();
+        }
+        return;
+    }
+
+    TryAIPlannedMove(CurrentUnit, Order); // Effettua movimento random
+
+    if (Order.PostMoveTarget != INDEX_NONE)
+    {
+        // Attende 3s e poi prova ad attaccare
+        ScheduleAIStep([this, CurrentUnit]()
+        {
+            if (GameMode->AIPlaybackScale > 0.f)
+            {
+                GridManager->HighlightAttackGrid(CurrentUnit);
             }
-            else if (GameMode && GameMode->AILevel == EAILevel::Hard)
+            TryAIAttack(CurrentUnit);
+
+            ScheduleAIStep([this]()
             {
-                // ---- AI LEVEL: NORMAL/HARD ----
+                GridManager->ClearHighlights();
+                AdvanceToNextAIUnit();
+            }, 3.0f);
+        }, 3.0f);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("AI Easy: solo movimento"));
+        ScheduleAIStep([this]() { AdvanceToNextAIUnit(); }, 3.0f);
+    }
+}
 
-                // Prova a fare attacco diretto
-                if (!TryAIAttack(CurrentUnit))
-                {
-                    // Se non ha attaccato → prova a muoversi
-                    TryAIMove(CurrentUnit);
-
-                    // Dopo 5s → riprova ad attaccare
-                    FTimerHandle AfterMoveHandle;
-                    GameMode->GetWorld()->GetTimerManager().SetTimer(AfterMoveHandle, [this, CurrentUnit]()
-                    {
-                        GridManager->HighlightAttackGrid(CurrentUnit);
-                        TryAIAttack(CurrentUnit);
-
-                        FTimerHandle AttackTimer;
-                        GameMode->GetWorld()->GetTimerManager().SetTimer(AttackTimer, [this]()
-                        {
-                            GridManager->ClearHighlights();
-                            CurrentAIIndex++;
-                            ProcessNextAIUnit();
-                        }, 1.0f, false);
-                    }, 5.0f, false);
-                }
-                else
-                {
-                    // Ha attaccato subito, passa avanti
-                    CurrentAIIndex++;
-                    ProcessNextAIUnit();
-                }   
+/*
+* Descrizione:
+* ---- AI LEVEL: NORMAL/HARD ----
+* Attacco diretto se possibile, altrimenti movimento secondo il piano del turno
+* (o ricalcolato con TryAIMove) e nuovo tentativo di attacco.
+*/
+void ABattleManager::ProcessHardAIUnit(AUnitBase* CurrentUnit)
+{
+    // Prova a fare attacco diretto
+    if (TryAIAttack(CurrentUnit))
+    {
+        // Ha attaccato subito, passa avanti
+        AdvanceToNextAIUnit();
+        return;
+    }
+
+    // Se non ha attaccato → segue il piano, oppure ricalcola il movimento
+    // se nel frattempo un'unità nemica è morta
+    const FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+    const int32 EnemyUnits = Registry.Num() - Registry.Num(CurrentUnit->GetTeamID());
+    const FAIUnitOrder* Order = PlannedEnemyUnits == EnemyUnits ? CurrentPlan.FindOrder(CurrentUnit) : nullptr;
+    if (!Order || !TryAIPlannedMove(CurrentUnit, *Order))
+    {
+        TryAIMove(CurrentUnit);
+    }
+
+    // Dopo 5s → riprova ad attaccare
+    ScheduleAIStep([this, CurrentUnit]()
+    {
+        if (GameMode->AIPlaybackScale > 0.f)
+        {
+            GridManager->HighlightAttackGrid(CurrentUnit);
+        }
+        TryAIAttack(CurrentUnit);
+
+        ScheduleAIStep([this]()
+        {
+            GridManager->ClearHighlights();
+            AdvanceToNextAIUnit();
+        }, 1.0f);
+    }, 5.0f);
+}
+
+/*
+* Descrizione:
+* ---- AI LEVEL: UTILITY ----
+* FAIPlanner::PlanUtilityUnit valuta tutte le coppie (destinazione, bersaglio) e sceglie la migliore:
+* qui l'unità attacca subito il bersaglio scelto oppure si muove e lo attacca dopo il movimento.
+*/
+void ABattleManager::ProcessUtilityAIUnit(AUnitBase* CurrentUnit)
+{
+    FSimBoard Board = FSimBoard::FromWorld(GameMode);
+    const int32 UnitIndex = Board.FindUnitByActor(CurrentUnit);
+
+    if (UnitIndex == INDEX_NONE)
+    {
+        AdvanceToNextAIUnit();
+        return;
+    }
+
+    FInfluenceMap& Influence = GameMode->GetInfluenceMap();
+    Influence.Update(Board);
+
+    FAIUnitOrder Order;
+    FAIPlanner::PlanUtilityUnit(Board, UnitIndex, Order, &Influence);
+
+    // Attacco senza movimento
+    if (Order.PreMoveTarget != INDEX_NONE)
+    {
+        TryAIAttack(CurrentUnit, Board.Units[Order.PreMoveTarget].Actor.Get());
+        AdvanceToNextAIUnit();
+        return;
+    }
+
+    if (Order.Path.Num() > 0)
+    {
+        TryAIPlannedMove(CurrentUnit, Order);
+    }
+
+    if (Order.PostMoveTarget == INDEX_NONE)
+    {
+        ScheduleAIStep([this]() { AdvanceToNextAIUnit(); }, 3.0f);
+        return;
+    }
+
+    // Dopo il movimento attacca il bersaglio scelto
+    AUnitBase* Target = Board.Units[Order.PostMoveTarget].Actor.Get();
+    ScheduleAIStep([this, CurrentUnit, Target]()
+    {
+        if (GameMode->AIPlaybackScale > 0.f)
+        {
+            GridManager->HighlightAttackGrid(CurrentUnit);
+        }
+        TryAIAttack(CurrentUnit, Target);
+
+        ScheduleAIStep([this]()
+        {
+            GridManager->ClearHighlights();
+            AdvanceToNextAIUnit();
+        }, 1.0f);
+    }, 5.0f);
+}
+
+/*
+* Descrizione:
+* Passa all'unità AI successiva.
+*/
+void ABattleManager::AdvanceToNextAIUnit()
+{
+    CurrentAIIndex++;
+    ProcessNextAIUnit();
+}
+
+/*
+* Descrizione:
+* ---- AI LEVEL: HARD, squadre numerose ----
+* Stesse decisioni di ProcessHardAIUnit, ma senza attendere l'animazione di ogni unità:
+* chi può attacca subito, le altre partono insieme e attaccano all'arrivo.
+* 1. Per ogni unità viene scelta la destinazione (piano o nemico più vicino); la tile viene segnata occupata
+*    subito, così le unità successive scelgono destinazioni diverse.
+* 2. I percorsi vengono pianificati insieme con WHCA* (FCooperativePathfinder) sulla board di partenza:
+*    un'unità può aspettare qualche passo invece di attraversare un'altra, anche a metà percorso.
+* 3. I movimenti partono tutti nello stesso frame; il MovementManager li prenota con le stesse regole
+*    della pianificazione, quindi i percorsi non vengono ritardati ulteriormente.
+* Il turno termina quando è arrivato l'ultimo movimento.
+*/
+void ABattleManager::ProcessHardTurnConcurrently()
+{
+    const FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+
+    struct FGroupMove
+    {
+        AUnitBase* Unit = nullptr;
+        ATile* From = nullptr;
+        TArray<ATile*> Path;
+    };
+    TArray<FGroupMove> GroupMoves;
+
+    for (const FUnitHandle& Handle : AIUnitsToProcess)
+    {
+        if (GameMode->GetCurrentGamePhase() == EGamePhase::EGameOver) return;
+
+        AUnitBase* Unit = Registry.Get(Handle);
+        if (!Unit || !Unit->CanAct() || Unit->GetCurrentAction() == EUnitAction::Attacked) continue;
+
+        if (TryAIAttack(Unit)) continue;
+
+        const int32 EnemyUnits = Registry.Num() - Registry.Num(Unit->GetTeamID());
+        const FAIUnitOrder* Order = PlannedEnemyUnits == EnemyUnits ? CurrentPlan.FindOrder(Unit) : nullptr;
+
+        FGroupMove Move;
+        Move.Unit = Unit;
+        Move.From = GridManager->FindTileAtLocation(Unit->GetActorLocation());
+        if (!Move.From) continue;
+        if (!(Order && ResolvePlannedPath(*Order, Move.Path)) && !BuildAIMovePath(Unit, Move.Path)) continue;
+
+        // Come farebbe MoveUnit: partenza libera e destinazione occupata per le unità successive
+        Move.From->SetHasPawn(false);
+        Move.Path.Last()->SetHasPawn(true);
+        GroupMoves.Add(MoveTemp(Move));
+    }
+
+    // Le tile tornano allo stato reale (prima le destinazioni: una può essere la partenza di un'altra unità)
+    for (const FGroupMove& Move : GroupMoves)
+    {
+        Move.Path.Last()->SetHasPawn(false);
+    }
+    for (const FGroupMove& Move : GroupMoves)
+    {
+        Move.From->SetHasPawn(true);
+    }
+
+    FCooperativePathfinder Pathfinder;
+    Pathfinder.Init(FSimBoard::FromWorld(GameMode), GameMode->CooperativeWindow);
+
+    int32 MaxRange = 0;
+    for (const FGroupMove& Move : GroupMoves)
+    {
+        Pathfinder.AddAgent(Move.Unit->GetUniqueID(), GridManager->GetTileIndex(Move.From),
+            GridManager->GetTileIndex(Move.Path.Last()), Move.Unit->GetMovementRange());
+        MaxRange = FMath::Max(MaxRange, Move.Unit->GetMovementRange());
+    }
+
+    // Ogni finestra conferma metà dei propri passi: orizzonte pari al doppio del range (spazio per le attese)
+    const int32 HalfWindow = FMath::Max(1, Pathfinder.GetWindowSize() / 2);
+    Pathfinder.PlanAll(FMath::DivideAndRoundUp(2 * MaxRange, HalfWindow) + 1);
+
+    // Il contatore parte da 1: i movimenti istantanei arrivano durante il ciclo e non devono chiudere il turno
+    PendingConcurrentMoves = 1;
+
+    TArray<int32> PathIndices;
+    TArray<ATile*> Path;
+    TArray<ATile*, TInlineAllocator<16>> EndTiles;
+    for (int32 Agent = 0; Agent < GroupMoves.Num(); ++Agent)
+    {
+        if (GameMode->GetCurrentGamePhase() == EGamePhase::EGameOver) return;
+
+        AUnitBase* Unit = GroupMoves[Agent].Unit;
+        if (!IsValid(Unit) || Unit->IsInPool()) continue;
+
+        Pathfinder.GetPath(Agent, PathIndices);
+        if (PathIndices.Num() == 0) continue; // Nessun percorso senza conflitti: l'unità resta ferma
+
+        Path.Reset();
+        for (int32 TileIndex : PathIndices)
+        {
+            Path.Add(GridManager->GetTileByIndex(TileIndex));
+        }
+
+        auto OnArrived = [this](AUnitBase* MovedUnit)
+        {
+            if (GameMode->GetCurrentGamePhase() != EGamePhase::EGameOver)
+            {
+                TryAIAttack(MovedUnit);
             }
-        }, 3.0f, false); // Delay attacco
+            OnConcurrentMoveFinished();
+        };
+
+        ++PendingConcurrentMoves;
+        if (StartAIMove(Unit, Path, OnArrived))
+        {
+            EndTiles.Add(Path.Last());
+        }
+        else
+        {
+            --PendingConcurrentMoves; // L'unità non si è mossa
+        }
+    }
 
-    }, 3.0f, false); // Delay movimento
+    // Una destinazione che era la partenza di un'unità avviata dopo è stata liberata da quel MoveUnit
+    for (ATile* EndTile : EndTiles)
+    {
+        EndTile->SetHasPawn(true);
+    }
+
+    OnConcurrentMoveFinished();
+}
+
+void ABattleManager::OnConcurrentMoveFinished()
+{
+    if (--PendingConcurrentMoves > 0) return;
+    if (GameMode->GetCurrentGamePhase() == EGamePhase::EGameOver) return;
+
+    UE_LOG(LogTemp, Warning, TEXT("Tutte le unità AI hanno agito (movimenti contemporanei). Fine turno AI."));
+    ScheduleAIStep([this]() { TurnManager->EndTurn(); }, 1.0f);
+}
+
+/*
+* Descrizione:
+* Esegue un passo del turno AI dopo BaseDelay secondi, scalati da AIPlaybackScale.
+* Se il delay risultante è nullo il passo viene eseguito subito (modalità istantanea).
+* Un passo istantaneo pianificato da un altro passo viene solo accodato: il ciclo del primo passo
+* li esegue in ordine, così un intero turno istantaneo non fa crescere lo stack.
+*/
+void ABattleManager::ScheduleAIStep(TFunction<void()>&& Step, float BaseDelay)
+{
+    const float Delay = GameMode ? GameMode->GetAIDelay(BaseDelay) : BaseDelay;
+    if (Delay <= 0.f)
+    {
+        PendingAISteps.Add(MoveTemp(Step));
+        if (bRunningAISteps) return;
+
+        TGuardValue<bool> RunningGuard(bRunningAISteps, true);
+        for (int32 Index = 0; Index < PendingAISteps.Num(); ++Index)
+        {
+            // Copia locale: il passo può accodarne altri e riallocare l'array
+            const TFunction<void()> NextStep = MoveTemp(PendingAISteps[Index]);
+            NextStep();
+        }
+        PendingAISteps.Reset();
+        return;
+    }
+
+    FTimerHandle StepHandle;
+    GetWorld()->GetTimerManager().SetTimer(StepHandle, MoveTemp(Step), Delay, false);
 }
 
 /*
@@ -302,32 +612,46 @@ void ABattleManager::ProcessNextAIUnit()
 * Calcola il percorso ottimale considerando il range di movimento.
 * 
 * Flusso:
-* 1. Trova il nemico più vicino
-* 2. Calcola il percorso verso di esso
-* 3. Determina le tile raggiungibili
-* 4. Esegue il movimento lungo il percorso
-* 5. Registra l'azione nella history
+* 1. Calcola il percorso verso il nemico più vicino (BuildAIMovePath)
+* 2. Registra l'azione nella history
+* 3. Esegue il movimento lungo il percorso
+*/
+bool ABattleManager::TryAIMove(AUnitBase* AIUnit, AUnitMovementManager::FOnUnitArrived&& OnArrived)
+{
+    TArray<ATile*> PathToMove;
+    if (!BuildAIMovePath(AIUnit, PathToMove)) return false;
+
+    return StartAIMove(AIUnit, PathToMove, MoveTemp(OnArrived));
+}
+
+/*
+* Metodo: BuildAIMovePath
+* 
+* Descrizione:
+* Percorso verso il nemico più vicino, troncato all'ultima tile raggiungibile entro il range di movimento.
 */
-void ABattleManager::TryAIMove(AUnitBase* AIUnit)
+bool ABattleManager::BuildAIMovePath(AUnitBase* AIUnit, TArray<ATile*>& OutPath)
 {
+    OutPath.Reset();
+
     if (!AIUnit || !GridManager)
     {
         UE_LOG(LogTemp, Warning, TEXT("TryAIMove: AIUnit o GridManager è nullo"));
-        return;
+        return false;
     }
 
     AUnitBase* Enemy = FindNearestEnemy(AIUnit);  // Trova il nemico più vicino
     if (!Enemy)
     {
         UE_LOG(LogTemp, Warning, TEXT("TryAIMove: Nessun nemico trovato"));
-        return;
+        return false;
     }
 
     ATile* EnemyTile = GridManager->FindTileAtLocation(Enemy->GetActorLocation()); // Ottiene la tile del nemico
     if (!EnemyTile)
     {
         UE_LOG(LogTemp, Warning, TEXT("TryAIMove: EnemyTile non trovato"));
-        return;
+        return false;
     }
 
     TArray<ATile*> Path = GridManager->GetPathToTile(AIUnit, EnemyTile);  // Calcola il percorso
@@ -344,60 +668,100 @@ void ABattleManager::TryAIMove(AUnitBase* AIUnit)
             break;
         }
     }
-    
-    if (LastReachableIndex != -1)
+
+    if (LastReachableIndex == -1)
     {
-        TArray<ATile*> PathToMove;
-        for (int32 i = 0; i <= LastReachableIndex; i++)
-        {
-            PathToMove.Add(Path[i]); // Costruisce il path effettivo da percorrere
-        }
+        UE_LOG(LogTemp, Warning, TEXT("Nessuna tile raggiungibile trovata nel path."));
+        return false;
+    }
 
-        MovementManager->MoveUnit(AIUnit, PathToMove, 300.f);
+    for (int32 i = 0; i <= LastReachableIndex; i++)
+    {
+        OutPath.Add(Path[i]); // Costruisce il path effettivo da percorrere
+    }
+    return true;
+}
 
-        ATile* From = GridManager->FindTileAtLocation(AIUnit->GetActorLocation()); // Tile di partenza
-        FString FromName = From ? From->GetTileIdentifier() : TEXT("???");
-        FString ToName = PathToMove.Last()->GetTileIdentifier();  // Tile di arrivo
-        FString UnitType = AIUnit->IsRangedAttack() ? TEXT("Sniper") : TEXT("Brawler");  // Tipo unità
-        GameMode->AddMoveToHistory(FString::Printf(TEXT("AI: %s moves from %s to %s"), *UnitType, *FromName, *ToName)); // Registra l'azione
 
-        TurnManager->RegisterAIMove(AIUnit); // Notifica che si è mossa
-    }
-    else
+/*
+* Metodo: TryAIPlannedMove
+* 
+* Descrizione:
+* Esegue il movimento deciso da FAIPlanner.
+* Restituisce false se il piano non è applicabile, così il chiamante può usare TryAIMove.
+*/
+bool ABattleManager::TryAIPlannedMove(AUnitBase* AIUnit, const FAIUnitOrder& Order, AUnitMovementManager::FOnUnitArrived&& OnArrived)
+{
+    TArray<ATile*> PathToMove;
+    if (!AIUnit || !ResolvePlannedPath(Order, PathToMove)) return false;
+
+    return StartAIMove(AIUnit, PathToMove, MoveTemp(OnArrived));
+}
+
+/*
+* Metodo: ResolvePlannedPath
+* 
+* Descrizione:
+* Il percorso del piano è espresso in indici di tile: viene convertito nelle tile reali
+* e verificato (ostacoli, tile occupate).
+*/
+bool ABattleManager::ResolvePlannedPath(const FAIUnitOrder& Order, TArray<ATile*>& OutPath)
+{
+    OutPath.Reset();
+    if (!GridManager || Order.Path.Num() == 0) return false;
+
+    for (int32 TileIndex : Order.Path)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Nessuna tile raggiungibile trovata nel path."));
+        ATile* Tile = GridManager->GetTileByIndex(TileIndex);
+        if (!Tile || Tile->IsObstacle() || Tile->GetHasPawn())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("TryAIPlannedMove: percorso pianificato non più valido"));
+            OutPath.Reset();
+            return false;
+        }
+        OutPath.Add(Tile);
     }
+    return true;
 }
 
-
 /*
-* Metodo: TryAIRandomMove
+* Metodo: StartAIMove
 * 
 * Descrizione:
-* Muove un'unità AI in una posizione casuale all'interno del suo range.
-* Utilizzato principalmente per il livello di difficoltà Easy.
+* Registra il movimento nel log dei comandi, lo notifica al TurnManager e lo avvia.
+* Il log contiene solo le tile attraversate: le attese di un percorso cooperativo riguardano l'animazione.
+* Un movimento che non può partire non viene registrato: log e stato del turno contengono solo mosse avvenute.
 */
-void ABattleManager::TryAIRandomMove(AUnitBase* AIUnit)
+bool ABattleManager::StartAIMove(AUnitBase* AIUnit, const TArray<ATile*>& Path, AUnitMovementManager::FOnUnitArrived&& OnArrived)
 {
-    if (!AIUnit || !GridManager) return; // Verifica validità riferimenti
+    if (!MovementManager->CanMoveUnit(AIUnit, Path)) return false;
 
-    TArray<ATile*> MovableTiles = GridManager->GetValidMovementTiles(AIUnit); // Ottiene le tile valide
-    if (MovableTiles.Num() == 0) return; // Nessuna tile disponibile
+    const int32 LoggedCommands = GameMode->GetCommandLog().Num();
+    const EUnitAction PreviousAction = AIUnit->GetCurrentAction();
 
-    int32 Index = FMath::RandRange(0, MovableTiles.Num() - 1); // Sceglie un indice casuale
-    ATile* Destination = MovableTiles[Index]; // Tile di destinazione
+    ATile* From = GridManager->FindTileAtLocation(AIUnit->GetActorLocation()); // Tile di partenza
 
-    TArray<ATile*> Path = GridManager->GetPathToTile(AIUnit, Destination); // Percorso da seguire
-    MovementManager->MoveUnit(AIUnit, Path, 300.f); // Esegue il movimento
+    TArray<ATile*> Visited;
+    for (ATile* Tile : Path)
+    {
+        if (Tile != (Visited.Num() > 0 ? Visited.Last() : From))
+        {
+            Visited.Add(Tile);
+        }
+    }
+    GameMode->RecordMove(AIUnit, From, Visited); // Registra l'azione nel log dei comandi
 
-    FString From = GridManager->FindTileAtLocation(AIUnit->GetActorLocation()) ?
-        GridManager->FindTileAtLocation(AIUnit->GetActorLocation())->GetTileIdentifier() : TEXT("???");
+    TurnManager->RegisterAIMove(AIUnit); // Notifica che si è mossa (prima: un movimento istantaneo arriva subito)
 
-    FString To = Destination ? Destination->GetTileIdentifier() : TEXT("???");
-    FString UnitType = AIUnit->IsRangedAttack() ? TEXT("Sniper") : TEXT("Brawler");
+    if (MovementManager->MoveUnit(AIUnit, Path, GameMode->GetAIMoveSpeed(300.f), MoveTemp(OnArrived)))
+    {
+        return true;
+    }
 
-    GameMode->AddMoveToHistory(FString::Printf(TEXT("AI (Easy): %s moves from %s to %s"), *UnitType, *From, *To));
-    TurnManager->RegisterAIMove(AIUnit); // Notifica movimento effettuato
+    // Il movimento non è partito: annulla registrazione e stato
+    GameMode->GetCommandLog().Truncate(LoggedCommands);
+    AIUnit->SetCurrentAction(PreviousAction);
+    return false;
 }
 
 /*
@@ -406,39 +770,61 @@ void ABattleManager::TryAIRandomMove(AUnitBase* AIUnit)
 * 
 * Descrizione:
 * Tenta di eseguire un attacco con l'unità AI se ci sono nemici nel range.
+* Se PreferredTarget è indicato, viene attaccato solo quel bersaglio.
 * Restituisce true se è stato eseguito un attacco, false altrimenti.
 */
-bool ABattleManager::TryAIAttack(AUnitBase* AIUnit)
+bool ABattleManager::TryAIAttack(AUnitBase* AIUnit, AUnitBase* PreferredTarget)
 {
-    TArray<ATile*> AttackTiles = GridManager->GetValidAttackTiles(AIUnit); // Ottiene le tile d'attacco
+    if (!AIUnit || AIUnit->IsDead()) return false;
+
+    // Stesse regole di FSimBoard::CanAttackFrom, lette dal registro e dall'indice di occupazione
+    // senza costruire la board: nemico vivo sulla griglia entro il raggio d'attacco (distanza in tile)
+    const int32 FromTile = GridManager->GetUnitTileIndex(AIUnit);
+    if (FromTile == INDEX_NONE) return false;
 
-    for (AUnitBase* PlayerUnit : GameMode->PlayerUnits) // Cicla sulle unità nemiche
+    const int32 Team = AIUnit->GetTeamID();
+    const int32 RangeSquared = AIUnit->GetAttackRange() * AIUnit->GetAttackRange();
+    auto CanAttack = [this, Team, FromTile, RangeSquared](const AUnitBase* Target)
     {
-        ATile* PlayerTile = GridManager->FindTileAtLocation(PlayerUnit->GetActorLocation());
+        if (!IsValid(Target) || Target->IsDead() || Target->GetTeamID() == Team) return false;
 
-        if (!PlayerTile) continue; // Salta se tile non trovata
+        const int32 TargetTile = GridManager->GetUnitTileIndex(Target);
+        return TargetTile != INDEX_NONE && GridManager->GetTileDistanceSquared(FromTile, TargetTile) <= RangeSquared;
+    };
 
-        if (AttackTiles.Contains(PlayerTile)) // Se il nemico è attaccabile
+    AUnitBase* EnemyUnit = nullptr;
+    if (PreferredTarget) // Bersaglio scelto dall'IA Utility
+    {
+        EnemyUnit = CanAttack(PreferredTarget) ? PreferredTarget : nullptr;
+    }
+    else
+    {
+        // Primo nemico attaccabile in ordine di registro (prima squadra, prima unità), come la board
+        const FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+        for (int32 EnemyTeam = 0; EnemyTeam < Registry.GetNumTeams() && !EnemyUnit; ++EnemyTeam)
         {
-            UE_LOG(LogTemp, Warning, TEXT("AI %s attacca %s"), *AIUnit->GetName(), *PlayerUnit->GetName());
-            AIUnit->AttackUnit(PlayerUnit); // Esegue l'attacco
-            // Aggiorna la barra della vita del difensore
-            if (GameMode && GameMode->GetStatusGameWidget() && !PlayerUnit->IsDead())
+            if (EnemyTeam == Team) continue;
+
+            for (AUnitBase* Candidate : Registry.GetUnits(EnemyTeam))
             {
-                GameMode->GetStatusGameWidget()->UpdateUnitHealth(PlayerUnit, PlayerUnit->GetHealthPercent());
+                if (CanAttack(Candidate))
+                {
+                    EnemyUnit = Candidate;
+                    break;
+                }
             }
-
-            ATile* TargetTile = GridManager->FindTileAtLocation(PlayerUnit->GetActorLocation());
-            FString TileName = TargetTile ? TargetTile->GetTileIdentifier() : TEXT("???");
-            FString UnitType = AIUnit->IsRangedAttack() ? TEXT("Sniper") : TEXT("Brawler");
-            int32 Damage = FMath::RandRange(AIUnit->MinDamage, AIUnit->MaxDamage); // Calcola danno
-            GameMode->AddMoveToHistory(FString::Printf(TEXT("AI: %s attacks %s damage %d"), *UnitType, *TileName, Damage));
-
-            TurnManager->RegisterAIAttack(AIUnit); // Notifica attacco
-            return true;
         }
     }
-    return false; // Nessun attacco eseguito
+
+    if (!EnemyUnit) return false; // Nessun attacco eseguito
+
+    UE_LOG(LogTemp, Warning, TEXT("AI %s attacca %s"), *AIUnit->GetName(), *EnemyUnit->GetName());
+
+    // Stesse regole dell'attacco del player (FCombatResolver), contrattacco compreso
+    AIUnit->AttackUnit(EnemyUnit, GameMode->GetMatchRandom().Combat);
+
+    TurnManager->RegisterAIAttack(AIUnit); // Notifica attacco (ignorata se il contrattacco ha ucciso l'unità)
+    return true;
 }
 
 /*
@@ -456,18 +842,27 @@ AUnitBase* ABattleManager::FindNearestEnemy(AUnitBase* AIUnit)
         return nullptr;
     }
 
-    AUnitBase* NearestEnemy = nullptr;
-    float MinDistance = FLT_MAX; // Distanza iniziale massima
+    // Nemici dal registro, tile dall'indice di occupazione (distanza in tile, come FSimBoard::FindNearestEnemy)
+    const int32 FromTile = GridManager->GetUnitTileIndex(AIUnit);
+    if (FromTile == INDEX_NONE) return nullptr;
 
-    for (AUnitBase* PlayerUnit : GameMode->PlayerUnits)
+    const FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+    AUnitBase* NearestEnemy = nullptr;
+    int32 MinDistance = MAX_int32;
+    for (int32 EnemyTeam = 0; EnemyTeam < Registry.GetNumTeams(); ++EnemyTeam)
     {
-        if (PlayerUnit && PlayerUnit->IsPlayerControlled()) 
+        if (EnemyTeam == AIUnit->GetTeamID()) continue;
+
+        for (AUnitBase* Enemy : Registry.GetUnits(EnemyTeam))
         {
-            float Distance = FVector::Dist2D(AIUnit->GetActorLocation(), PlayerUnit->GetActorLocation()); // Distanza 2D
+            const int32 EnemyTile = GridManager->GetUnitTileIndex(Enemy);
+            if (EnemyTile == INDEX_NONE || !IsValid(Enemy) || Enemy->IsDead()) continue;
+
+            const int32 Distance = GridManager->GetTileDistanceSquared(FromTile, EnemyTile);
             if (Distance < MinDistance)
             {
                 MinDistance = Distance;
-                NearestEnemy = PlayerUnit; // Aggiorna il più vicino
+                NearestEnemy = Enemy;
             }
         }
     }
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "PAASchifanoFrancesco/Units/UnitMovementManager.h"
+#include "PAASchifanoFrancesco/AI/AIPlanner.h"
+#include "PAASchifanoFrancesco/Units/UnitRegistry.h"
 #include "GameFramework/Actor.h"
 #include "BattleManager.generated.h"
 
@@ -35,14 +37,14 @@ public:
 	// Inizializza il turno dell'IA
 	void PrepareAITurn();
 
-	// Prova a far attaccare un'unità AI
-	bool TryAIAttack(AUnitBase* AIUnit);
+	// Prova a far attaccare un'unità AI (se PreferredTarget è indicato, attacca solo quel bersaglio)
+	bool TryAIAttack(AUnitBase* AIUnit, AUnitBase* PreferredTarget = nullptr);
 
-	// Prova a far muovere un'unità AI verso il nemico più vicino
-	void TryAIMove(AUnitBase* AIUnit);
+	// Prova a far muovere un'unità AI verso il nemico più vicino (OnArrived viene chiamata all'arrivo)
+	bool TryAIMove(AUnitBase* AIUnit, AUnitMovementManager::FOnUnitArrived&& OnArrived = nullptr);
 
-	// Prova a far muovere un'unità AI in modo casuale
-	void TryAIRandomMove(AUnitBase* AIUnit);
+	// Muove un'unità AI seguendo il percorso già pianificato (pondering o FAIPlanner)
+	bool TryAIPlannedMove(AUnitBase* AIUnit, const FAIUnitOrder& Order, AUnitMovementManager::FOnUnitArrived&& OnArrived = nullptr);
 
 	// Restituisce il nemico più vicino a una determinata unità AI
 	AUnitBase* FindNearestEnemy(AUnitBase* AIUnit);
@@ -60,12 +62,52 @@ private:
 	// Indice dell'unità AI attualmente in fase di elaborazione
 	int32 CurrentAIIndex;
 
-	// Lista di unità AI che devono ancora agire durante il turno corrente
-	TArray<AUnitBase*> AIUnitsToProcess;
+	// Unità AI che devono ancora agire durante il turno corrente (handle: un'unità morta non risolve più)
+	TArray<FUnitHandle> AIUnitsToProcess;
+
+	// Piano del turno corrente dell'AI Hard (calcolato in PrepareAITurn)
+	FAITurnPlan CurrentPlan;
+
+	// Numero di unità nemiche (di tutte le altre squadre) quando il piano è stato calcolato:
+	// se una muore durante il turno il piano non è più affidabile
+	int32 PlannedEnemyUnits = 0;
 
 	// Gestisce la logica della prossima unità IA nel turno corrente
 	void ProcessNextAIUnit();
 
+	// Esegue le azioni dell'unità corrente secondo il livello di difficoltà
+	void ProcessEasyAIUnit(AUnitBase* CurrentUnit);
+	void ProcessHardAIUnit(AUnitBase* CurrentUnit);
+	void ProcessUtilityAIUnit(AUnitBase* CurrentUnit);
+
+	// Passa alla prossima unità IA
+	void AdvanceToNextAIUnit();
+
+	// AI Hard con squadre numerose: tutte le unità agiscono insieme, i movimenti si animano in parallelo
+	void ProcessHardTurnConcurrently();
+
+	// Arrivo di un movimento contemporaneo: chiude il turno quando non ne restano in corso
+	void OnConcurrentMoveFinished();
+
+	// Movimenti contemporanei ancora in corso (+1 durante l'invio degli ordini)
+	int32 PendingConcurrentMoves = 0;
+
+	// Percorso verso il nemico più vicino, troncato al range di movimento (false se l'unità non può muoversi)
+	bool BuildAIMovePath(AUnitBase* AIUnit, TArray<ATile*>& OutPath);
+
+	// Tile reali del percorso pianificato, se ancora libere (false se il piano non è più valido)
+	bool ResolvePlannedPath(const FAIUnitOrder& Order, TArray<ATile*>& OutPath);
+
+	// Registra e avvia un movimento dell'AI (le tile ripetute di un percorso cooperativo sono attese)
+	bool StartAIMove(AUnitBase* AIUnit, const TArray<ATile*>& Path, AUnitMovementManager::FOnUnitArrived&& OnArrived);
+
+	// Esegue un passo del turno IA dopo un delay scalato da AIPlaybackScale (subito se 0)
+	void ScheduleAIStep(TFunction<void()>&& Step, float BaseDelay);
+
+	// Passi istantanei in attesa: vengono eseguiti in ciclo da chi ha avviato il primo, non in ricorsione
+	TArray<TFunction<void()>> PendingAISteps;
+	bool bRunningAISteps = false;
+
 	// Riferimento al TurnManager, gestisce i turni tra player e AI
 	UPROPERTY()
 	UTurnManager* TurnManager;
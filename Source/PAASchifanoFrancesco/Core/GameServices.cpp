@@ -0,0 +1,28 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "GameServices.h"
+#include "Engine/World.h"
+
+UGameServices* UGameServices::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UGameServices>() : nullptr;
+}
+
+/**
+ * Descrizione:
+ * Alla chiusura del mondo i riferimenti vengono azzerati: nessun servizio sopravvive al proprio mondo.
+ */
+void UGameServices::Deinitialize()
+{
+	GameMode = nullptr;
+	GridManager = nullptr;
+	TurnManager = nullptr;
+	BattleManager = nullptr;
+	MovementManager = nullptr;
+	PlayerController = nullptr;
+	StatusWidget = nullptr;
+	TurnIndicator = nullptr;
+
+	Super::Deinitialize();
+}
@@ -0,0 +1,81 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameServices.generated.h"
+
+class AMyGameMode;
+class AGridManager;
+class UTurnManager;
+class ABattleManager;
+class AUnitMovementManager;
+class AMyPlayerController;
+class UStatusGameWidget;
+class UUITurnIndicator;
+
+/**
+ * Classe: UGameServices
+ * Descrizione:
+ * Punto di accesso unico ai manager e ai widget della partita, uno per mondo.
+ * Ogni servizio viene registrato una sola volta da chi lo crea (GameMode e PlayerController);
+ * chi lo usa nelle azioni frequenti (attacco, morte, movimento) legge il riferimento già tipizzato,
+ * senza GetGameMode + Cast né ricerche tra gli attori del mondo.
+ */
+UCLASS()
+class PAASCHIFANOFRANCESCO_API UGameServices : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Sottosistema del mondo dell'oggetto (nullptr senza mondo, es. CDO o commandlet) */
+	static UGameServices* Get(const UObject* WorldContextObject);
+
+	// Registrazione (un servizio ricreato sostituisce il precedente)
+	void RegisterGameMode(AMyGameMode* InGameMode) { GameMode = InGameMode; }
+	void RegisterGridManager(AGridManager* InGridManager) { GridManager = InGridManager; }
+	void RegisterTurnManager(UTurnManager* InTurnManager) { TurnManager = InTurnManager; }
+	void RegisterBattleManager(ABattleManager* InBattleManager) { BattleManager = InBattleManager; }
+	void RegisterMovementManager(AUnitMovementManager* InMovementManager) { MovementManager = InMovementManager; }
+	void RegisterPlayerController(AMyPlayerController* InPlayerController) { PlayerController = InPlayerController; }
+	void RegisterStatusWidget(UStatusGameWidget* InStatusWidget) { StatusWidget = InStatusWidget; }
+	void RegisterTurnIndicator(UUITurnIndicator* InTurnIndicator) { TurnIndicator = InTurnIndicator; }
+
+	// Accesso ai servizi (nullptr se non ancora registrati)
+	AMyGameMode* GetGameMode() const { return GameMode; }
+	AGridManager* GetGridManager() const { return GridManager; }
+	UTurnManager* GetTurnManager() const { return TurnManager; }
+	ABattleManager* GetBattleManager() const { return BattleManager; }
+	AUnitMovementManager* GetMovementManager() const { return MovementManager; }
+	AMyPlayerController* GetPlayerController() const { return PlayerController; }
+	UStatusGameWidget* GetStatusWidget() const { return StatusWidget; }
+	UUITurnIndicator* GetTurnIndicator() const { return TurnIndicator; }
+
+	virtual void Deinitialize() override;
+
+private:
+	UPROPERTY()
+	AMyGameMode* GameMode = nullptr;
+
+	UPROPERTY()
+	AGridManager* GridManager = nullptr;
+
+	UPROPERTY()
+	UTurnManager* TurnManager = nullptr;
+
+	UPROPERTY()
+	ABattleManager* BattleManager = nullptr;
+
+	UPROPERTY()
+	AUnitMovementManager* MovementManager = nullptr;
+
+	UPROPERTY()
+	AMyPlayerController* PlayerController = nullptr;
+
+	UPROPERTY()
+	UStatusGameWidget* StatusWidget = nullptr;
+
+	UPROPERTY()
+	UUITurnIndicator* TurnIndicator = nullptr;
+};
@@ -2,6 +2,7 @@
 #include "BattleManager.h" // Include la logica di battaglia
 #include "PlacementManager.h" // Include il manager per il piazzamento delle unità
 #include "TurnManager.h" // Include la gestione dei turni
+#include "GameServices.h" // Include il registro dei servizi del mondo
 #include "PAASchifanoFrancesco/UI/UICOinFlip.h" // Include il widget per il lancio della moneta
 #include "PAASchifanoFrancesco/UI/GameOverWidget.h" // Include il widget di fine gioco
 #include "PAASchifanoFrancesco/UI/UIMainMenu.h" // Include il menu principale
@@ -9,6 +10,16 @@
 #include "PAASchifanoFrancesco/Input/CameraPawn.h" // Include il Pawn per la visuale dall'alto
 #include "PAASchifanoFrancesco/Input/MyPlayerController.h" // Include il PlayerController personalizzato
 #include "PAASchifanoFrancesco/Units/UnitMovementManager.h" // Include il manager del movimento
+#include "PAASchifanoFrancesco/AI/AIPonderer.h" // Include il pondering dell'AI
+#include "PAASchifanoFrancesco/Simulation/CombatAnalytics.h" // Include le tabelle di danno precalcolate
+#include "PAASchifanoFrancesco/Simulation/MatchReplay.h" // Include il formato dei replay
+#include "PAASchifanoFrancesco/Simulation/MatchSnapshot.h" // Include i salvataggi della partita
+#include "PAASchifanoFrancesco/Simulation/SimBoard.h" // Include i nomi delle squadre
+#include "PAASchifanoFrancesco/Net/LockstepSession.h" // Include il lockstep (comandi e checksum)
+#include "PAASchifanoFrancesco/Units/Sniper.h" // Include le classi delle unità (caricamento)
+#include "PAASchifanoFrancesco/Units/Brawler.h"
+#include "PAASchifanoFrancesco/Units/UnitPool.h" // Include il pool delle unità
+#include "Misc/FileHelper.h" // Include per leggere i salvataggi
 #include "Blueprint/UserWidget.h" // Include per usare i widget in C++
 #include "Engine/World.h" // Include per accedere al mondo
 #include "GameFramework/PlayerController.h" // Include per accedere ai controller
@@ -99,6 +110,53 @@ void AMyGameMode::BeginPlay()
     // Chiama la versione base di BeginPlay (superclasse)
     Super::BeginPlay();
 
+    // Registro dei servizi: ogni manager viene registrato qui sotto appena creato
+    UGameServices* Services = UGameServices::Get(this);
+    Services->RegisterGameMode(this);
+
+    // Velocità di riproduzione dell'AI da riga di comando (es. -AIPlayback=0 per partite istantanee)
+    if (FParse::Value(FCommandLine::Get(), TEXT("AIPlayback="), AIPlaybackScale))
+    {
+        AIPlaybackScale = FMath::Max(0.f, AIPlaybackScale);
+        UE_LOG(LogTemp, Warning, TEXT("AIPlaybackScale impostato a %.2f"), AIPlaybackScale);
+    }
+
+    // Soglia dei movimenti contemporanei dell'AI da riga di comando (es. -ConcurrentMoves=0 per disattivarli)
+    if (FParse::Value(FCommandLine::Get(), TEXT("ConcurrentMoves="), ConcurrentMoveMinUnits))
+    {
+        ConcurrentMoveMinUnits = FMath::Max(0, ConcurrentMoveMinUnits);
+    }
+
+    // Finestra della pianificazione cooperativa da riga di comando (es. -CoopWindow=4 per risparmiare CPU)
+    if (FParse::Value(FCommandLine::Get(), TEXT("CoopWindow="), CooperativeWindow))
+    {
+        CooperativeWindow = FMath::Clamp(CooperativeWindow, 2, 32);
+    }
+
+    // Numero di squadre da riga di comando (es. -Teams=4: il player contro tre squadre IA)
+    if (FParse::Value(FCommandLine::Get(), TEXT("Teams="), NumTeams))
+    {
+        NumTeams = FMath::Clamp(NumTeams, 2, FUnitRegistry::MaxTeams);
+    }
+
+    // Dimensione delle squadre da riga di comando (es. -UnitsPerSide=50 per battaglie grandi)
+    if (FParse::Value(FCommandLine::Get(), TEXT("UnitsPerSide="), UnitsPerSide))
+    {
+        UnitsPerSide = FMath::Clamp(UnitsPerSide, 1, 200);
+    }
+
+    // Seed della partita: da riga di comando (-MatchSeed=N) oppure generato
+    int32 MatchSeed = 0;
+    if (!FParse::Value(FCommandLine::Get(), TEXT("MatchSeed="), MatchSeed))
+    {
+        MatchSeed = FMatchRandom::GenerateSeed();
+    }
+    MatchRandom.Initialize(MatchSeed);
+    UE_LOG(LogTemp, Warning, TEXT("Match seed: %d (per rigiocare la partita: -MatchSeed=%d)"), MatchSeed, MatchSeed);
+
+    // Precalcola le tabelle di danno di Sniper, Brawler e contrattacco (IA e anteprima attacco)
+    FCombatAnalytics::WarmupArchetypes();
+
     // Se non è ancora stato creato un GridManager, lo istanzia
     if (!GridManager)
     {
@@ -109,21 +167,24 @@ void AMyGameMode::BeginPlay()
             // Genera la griglia 25x25
             GridManager->GenerateGrid();
             // Genera gli ostacoli sulla griglia
-            GridManager->GenerateObstacles();
+            GridManager->GenerateObstacles(MatchRandom.Map);
             // Log di conferma creazione
             UE_LOG(LogTemp, Warning, TEXT("GridManager creato all'avvio!"));
         }
     }
+    Services->RegisterGridManager(GridManager);
 
     // Notifica che la fase attuale è attiva (utile per bind esterni)
     OnGamePhaseChanged.Broadcast(CurrentGamePhase);
     // Istanzia il manager globale dei movimenti
     GlobalMovementManager = GetWorld()->SpawnActor<AUnitMovementManager>();
+    Services->RegisterMovementManager(GlobalMovementManager);
     // Se il widget StatusGameWidget è stato assegnato correttamente
     if (StatusGameWidgetClass)
     {
         // Crea il widget e lo salva nella variabile StatusGameWidget
         StatusGameWidget = CreateWidget<UStatusGameWidget>(GetWorld(), StatusGameWidgetClass);
+        Services->RegisterStatusWidget(StatusGameWidget);
     }
 
     // Avvia la fase iniziale del gioco (menu principale)
@@ -158,6 +219,23 @@ void AMyGameMode::HandleInitialPhase()
     }
 }
 
+/**
+ * Metodo: SetMatchSeed
+ * Descrizione: Reinizializza gli stream della partita con il seed scelto nel menu
+ *              e rigenera griglia e ostacoli, così la mappa corrisponde al seed.
+ */
+void AMyGameMode::SetMatchSeed(int32 Seed)
+{
+    MatchRandom.Initialize(Seed);
+    UE_LOG(LogTemp, Warning, TEXT("Match seed: %d (per rigiocare la partita: -MatchSeed=%d)"), Seed, Seed);
+
+    if (GridManager)
+    {
+        GridManager->GenerateGrid();
+        GridManager->GenerateObstacles(MatchRandom.Map);
+    }
+}
+
 /**
  * Metodo: FlipCoin
  * Descrizione: Esegue un lancio di moneta per determinare il primo giocatore,
@@ -165,8 +243,8 @@ void AMyGameMode::HandleInitialPhase()
  */
 void AMyGameMode::FlipCoin()
 {
-    // Genera un numero casuale tra 0 e 1
-    int FlipResult = FMath::RandRange(0, 1);
+    // Genera un numero casuale tra 0 e 1 (stream della mappa: dipende solo dal seed)
+    int FlipResult = MatchRandom.Map.RandRange(0, 1);
     // Imposta il giocatore iniziale in base al risultato
     StartingPlayer = (FlipResult == 0) ? EPlayer::Player1 : EPlayer::AI;
 
@@ -191,6 +269,7 @@ void AMyGameMode::FlipCoin()
 
     // Crea e inizializza il TurnManager
     TurnManager = NewObject<UTurnManager>(this);
+    UGameServices::Get(this)->RegisterTurnManager(TurnManager);
     TurnManager->Initialize(this);
     TurnManager->SetInitialPlayer(StartingPlayer);
 }
@@ -209,6 +288,23 @@ void AMyGameMode::HandlePlacementPhase()
         Widget->RemoveFromParent();
     }
 
+    // Il log dei comandi parte vuoto a ogni partita (i nomi delle tile dipendono dalla griglia)
+    if (GridManager)
+    {
+        CommandLog.Reset(GridManager->GetGridDimX(), GridManager->GetGridDimY());
+        UnitRegistry.Reset();
+        UnitRegistry.SetNumTeams(NumTeams);
+        GridManager->ResetOccupancy();
+        StartLockstep();
+    }
+
+    // Tutte le unità della partita vengono create ora, nascoste nel pool: il piazzamento non spawna attori
+    if (UUnitPool* Pool = UUnitPool::Get(this))
+    {
+        Pool->Prewarm(ASniper::StaticClass(), GetRosterQuota(true) * NumTeams);
+        Pool->Prewarm(ABrawler::StaticClass(), GetRosterQuota(false) * NumTeams);
+    }
+
     // Crea il PlacementManager
     PlacementManager = GetWorld()->SpawnActor<APlacementManager>(APlacementManager::StaticClass());
     if (PlacementManager)
@@ -221,10 +317,13 @@ void AMyGameMode::HandlePlacementPhase()
             {
                 // Usa NewObject per assegnare prima le proprietà al widget
                 TurnIndicatorWidget = NewObject<UUITurnIndicator>(this, TurnIndicatorWidgetClass);
+                UGameServices::Get(this)->RegisterTurnIndicator(TurnIndicatorWidget);
                 if (TurnIndicatorWidget)
                 {
                     // Assegna la classe del widget informativo
                     TurnIndicatorWidget->InfoWidgetClass = InfoWidgetClass;
+                    // La history è una vista del log dei comandi
+                    TurnIndicatorWidget->SetCommandLog(&CommandLog);
                     // Mostra il widget nella viewport
                     TurnIndicatorWidget->AddToViewport();
                 }
@@ -254,6 +353,7 @@ void AMyGameMode::HandleBattlePhase()
 {
     // Istanzia il BattleManager nella scena
     BattleManager = GetWorld()->SpawnActor<ABattleManager>(ABattleManager::StaticClass());
+    UGameServices::Get(this)->RegisterBattleManager(BattleManager);
 
     if (BattleManager)
     {
@@ -262,6 +362,10 @@ void AMyGameMode::HandleBattlePhase()
         {
             StatusGameWidget->AddToViewport();
         }
+        // Crea il ponderer che pre-calcola le risposte dell'AI durante il turno del player
+        AIPonderer = NewObject<UAIPonderer>(this);
+        AIPonderer->Initialize(this);
+
         // Inizializza TurnManager con il BattleManager
         TurnManager->Initialize(this, BattleManager);
         // Imposta il giocatore iniziale
@@ -301,15 +405,256 @@ void AMyGameMode::HandleGameOver(const FString& WinnerName)
 }
 
 /**
- * Metodo: AddMoveToHistory
- * Descrizione: Aggiunge una stringa allo storico visivo del widget del turno.
+ * Metodo: SaveReplay
+ * Descrizione: Costruisce il replay dal log dei comandi e lo salva su file.
+ *              Gli ostacoli sono letti dalla griglia reale, quindi il replay non dipende dal generatore.
+ */
+void AMyGameMode::SaveReplay()
+{
+    if (!GridManager || CommandLog.Num() == 0) return;
+
+    FMatchReplay Replay;
+    Replay.Build(MatchRandom.Seed, FSimBoard::FromWorld(this).Obstacles, CommandLog);
+    Replay.SaveToFile(FMatchReplay::MakeReplayFilename(MatchRandom.Seed));
+}
+
+/**
+ * Metodo: StartLockstep
+ * Descrizione: Con -Lockstep crea due sessioni collegate in loopback sulla griglia corrente.
+ *              Il peer specchio riceve solo comandi e checksum, mai attori: se la sua board
+ *              diverge da quella della partita il desync viene segnalato nel log.
+ */
+void AMyGameMode::StartLockstep()
+{
+    LockstepLocal.Reset();
+    LockstepMirror.Reset();
+    LockstepSentCommands = 0;
+
+    if (!GridManager || !FParse::Param(FCommandLine::Get(), TEXT("Lockstep"))) return;
+
+    TSharedPtr<FLoopbackTransport> LocalTransport;
+    TSharedPtr<FLoopbackTransport> MirrorTransport;
+    FLoopbackTransport::CreatePair(LocalTransport, MirrorTransport);
+
+    const TBitArray<> Obstacles = FSimBoard::FromWorld(this).Obstacles;
+    const int32 DimX = GridManager->GetGridDimX();
+    const int32 DimY = GridManager->GetGridDimY();
+    LockstepLocal = MakeShared<FLockstepSession>(LocalTransport.ToSharedRef(), DimX, DimY, Obstacles);
+    LockstepMirror = MakeShared<FLockstepSession>(MirrorTransport.ToSharedRef(), DimX, DimY, Obstacles);
+
+    // Dopo un caricamento il primo pacchetto contiene l'intera history salvata
+    PublishLockstepTurn();
+}
+
+/**
+ * Metodo: PublishLockstepTurn
+ * Descrizione: Invia i comandi registrati dall'ultimo invio e li fa ricevere allo specchio.
+ *              Una history lunga (dopo un caricamento) viene divisa in più pacchetti; l'ultimo porta
+ *              il checksum della board costruita dal mondo, quindi lo specchio confronta la propria
+ *              riproduzione dei comandi con lo stato reale della partita.
+ */
+void AMyGameMode::PublishLockstepTurn()
+{
+    if (!LockstepLocal || CommandLog.Num() == LockstepSentCommands) return;
+
+    const uint32 WorldChecksum = FSimBoard::FromWorld(this).ComputeStateChecksum();
+    while (LockstepSentCommands < CommandLog.Num())
+    {
+        const int32 BatchEnd = CommandLog.FindBatchEnd(LockstepSentCommands, FLockstepSession::MaxPacketCommandBytes);
+        const TOptional<uint32> Checksum = BatchEnd == CommandLog.Num() ? TOptional<uint32>(WorldChecksum) : TOptional<uint32>();
+        if (!LockstepLocal->SubmitLocalCommands(CommandLog.GetCommandBytes(LockstepSentCommands, BatchEnd), Checksum))
+        {
+            // Gli stessi byte fallirebbero di nuovo: la sessione non è più utilizzabile
+            UE_LOG(LogTemp, Error, TEXT("Lockstep: invio dei comandi %d-%d fallito, sessione chiusa"), LockstepSentCommands, BatchEnd);
+            LockstepLocal.Reset();
+            LockstepMirror.Reset();
+            return;
+        }
+        LockstepSentCommands = BatchEnd;
+    }
+    LockstepMirror->Poll();
+
+    if (LockstepMirror->IsDesynced())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Lockstep: la partita non corrisponde più ai soli comandi (sequenza %d)"),
+            LockstepMirror->GetDesyncSequence());
+        LockstepLocal.Reset();
+        LockstepMirror.Reset();
+    }
+}
+
+/**
+ * Metodo: SaveMatch
+ * Descrizione: Cattura lo stato della partita sul game thread e ne affida la scrittura a un worker.
+ *              Le scritture vengono accodate: uno slot non è mai scritto da due task insieme.
  */
-void AMyGameMode::AddMoveToHistory(const FString& Entry)
+bool AMyGameMode::SaveMatch(const FString& SlotName)
 {
+    if (CurrentGamePhase != EGamePhase::EBattle) return false;
+
+    FMatchSnapshot Snapshot;
+    if (!FMatchSnapshot::Capture(this, Snapshot)) return false;
+
+    TArray<uint8> Bytes;
+    Snapshot.Save(Bytes);
+    PendingSave = FMatchSnapshot::WriteAsync(MoveTemp(Bytes), FMatchSnapshot::GetSlotFilename(SlotName), PendingSave);
+    return true;
+}
+
+/**
+ * Metodo: LoadMatch
+ * Descrizione: Sostituisce la partita in corso con quella salvata nello slot.
+ *              È consentito durante il turno del player: le unità vengono distrutte e ricreate
+ *              in un unico passaggio, poi il turno salvato riparte da StartTurn.
+ */
+bool AMyGameMode::LoadMatch(const FString& SlotName)
+{
+    if (CurrentGamePhase != EGamePhase::EBattle || !GridManager || !TurnManager || !BattleManager
+        || TurnManager->GetCurrentPlayer() != EPlayer::Player1)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("LoadMatch: caricamento possibile solo durante il turno del player in battaglia"));
+        return false;
+    }
+
+    // Un salvataggio ancora in scrittura deve terminare prima della lettura
+    PendingSave.Wait();
+
+    TArray<uint8> Bytes;
+    FMatchSnapshot Snapshot;
+    const FString Filename = FMatchSnapshot::GetSlotFilename(SlotName);
+    if (!FFileHelper::LoadFileToArray(Bytes, *Filename) || !Snapshot.Load(Bytes))
+    {
+        UE_LOG(LogTemp, Error, TEXT("LoadMatch: impossibile caricare %s"), *Filename);
+        return false;
+    }
+
+    const TArray<ATile*>& Tiles = GridManager->GetGridTiles();
+    if (Snapshot.Obstacles.Num() != Tiles.Num() || Snapshot.Phase != EGamePhase::EBattle
+        || Snapshot.NumTeams > FSimBoard::MaxTeams || Snapshot.CurrentTeam >= Snapshot.NumTeams)
+    {
+        UE_LOG(LogTemp, Error, TEXT("LoadMatch: %s non corrisponde alla griglia attuale"), *Filename);
+        return false;
+    }
+
+    if (AIPonderer)
+    {
+        AIPonderer->StopPondering();
+    }
+    GridManager->ClearHighlights();
+
+    // 1. Rimette nel pool le unità attuali (verranno riusate qui sotto)
+    UUnitPool* Pool = UUnitPool::Get(this);
+    for (int32 Team = 0; Team < UnitRegistry.GetNumTeams(); ++Team)
+    {
+        for (AUnitBase* Unit : UnitRegistry.GetUnits(Team))
+        {
+            if (StatusGameWidget) StatusGameWidget->RemoveUnitStatus(Unit);
+            Pool->Release(Unit);
+        }
+    }
+    UnitRegistry.Reset();
+    NumTeams = Snapshot.NumTeams;
+    UnitRegistry.SetNumTeams(NumTeams);
+
+    // 2. Ripristina ostacoli e occupazioni della griglia
+    for (int32 Index = 0; Index < Tiles.Num(); ++Index)
+    {
+        Tiles[Index]->SetAsObstacle(Snapshot.Obstacles[Index]);
+        Tiles[Index]->SetHasPawn(false);
+    }
+    GridManager->ResetOccupancy();
+
+    // 3. Riprende le unità dal pool (spawnandole solo se non bastano) e le riporta allo stato salvato
+    int32 NumLoaded = 0;
+    for (const FMatchSnapshotUnit& SavedUnit : Snapshot.Units)
+    {
+        ATile* Tile = GridManager->GetTileByIndex(SavedUnit.TileIndex);
+        if (!Tile) continue;
+
+        UClass* UnitClass = SavedUnit.bRanged ? ASniper::StaticClass() : ABrawler::StaticClass();
+        AUnitBase* Unit = Pool->Acquire(UnitClass, Tile->GetPawnSpawnLocation());
+        if (!Unit) continue;
+
+        Unit->SetIsPlayerController(SavedUnit.bPlayer);
+        Unit->SetTeamID(SavedUnit.Team);
+        Unit->CurrentHealth = SavedUnit.Health;
+        Unit->SetCurrentAction(SavedUnit.Action);
+        Unit->UnitDisplayName = SavedUnit.bPlayer
+            ? FString::Printf(TEXT("%s(Player)"), SavedUnit.bRanged ? TEXT("Sniper") : TEXT("Brawler"))
+            : FString::Printf(TEXT("%s (%s)"), SavedUnit.bRanged ? TEXT("Sniper") : TEXT("Brawler"), *FSimBoard::GetTeamName(SavedUnit.Team));
+        Tile->SetHasPawn(true);
+        GridManager->SetUnitTile(Unit, SavedUnit.TileIndex);
+        ++NumLoaded;
+
+        UnitRegistry.Add(Unit);
+        if (StatusGameWidget)
+        {
+            StatusGameWidget->AddUnitStatus(Unit);
+            StatusGameWidget->UpdateUnitHealth(Unit, Unit->GetHealthPercent());
+        }
+    }
+
+    // 4. Stream casuali, impostazioni e history
+    MatchRandom.Seed = Snapshot.Seed;
+    MatchRandom.Map.Initialize(Snapshot.MapState);
+    MatchRandom.AI.Initialize(Snapshot.AIState);
+    MatchRandom.Combat.Initialize(Snapshot.CombatState);
+    StartingPlayer = Snapshot.StartingPlayer;
+    AILevel = Snapshot.AILevel;
+    CommandLog = Snapshot.CommandLog;
+    InfluenceMap.Reset();
+    StartLockstep();
+
     if (TurnIndicatorWidget)
     {
-        TurnIndicatorWidget->AddHistoryEntry(Entry);
+        TurnIndicatorWidget->SetCommandLog(&CommandLog);
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("Partita caricata da %s (seed %d, %d unità)"), *Filename, Snapshot.Seed, NumLoaded);
+
+    // 5. Riprende dal turno salvato (le mosse annullabili appartenevano alla partita sostituita)
+    TurnManager->ClearUndoHistory();
+    TurnManager->SetCurrentTeam(Snapshot.CurrentTeam);
+    TurnManager->StartTurn();
+    return true;
+}
+
+/**
+ * Metodo: EndPlay
+ * Descrizione: Attende la fine delle scritture in corso, così l'ultimo autosave non va perso.
+ */
+void AMyGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    PendingSave.Wait();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+/**
+ * Metodo: RecordMove
+ * Descrizione: Aggiunge un comando Move al log; la history del widget del turno ne è una vista.
+ */
+void AMyGameMode::RecordMove(const AUnitBase* Unit, const ATile* From, const TArray<ATile*>& Path)
+{
+    if (!Unit || !GridManager) return;
+
+    TArray<int32, TInlineAllocator<8>> PathIndices;
+    for (const ATile* Tile : Path)
+    {
+        PathIndices.Add(GridManager->GetTileIndex(Tile));
     }
+
+    CommandLog.AppendMove(Unit->IsPlayerControlled(), Unit->IsRangedAttack(), GridManager->GetTileIndex(From), PathIndices, Unit->GetTeamID());
+}
+
+/**
+ * Metodo: GetWinnerName
+ * Descrizione: Nome dell'unica squadra con unità vive (la maschera del registro si aggiorna a ogni morte).
+ */
+FString AMyGameMode::GetWinnerName() const
+{
+    const int32 Winner = UnitRegistry.GetLastTeamStanding();
+    return Winner != INDEX_NONE ? FSimBoard::GetTeamName(Winner) : FString(TEXT("Nessuno"));
 }
 
 /**
@@ -346,7 +691,8 @@ void AMyGameMode::SetGamePhase(EGamePhase NewPhase)
             HandleBattlePhase();
             break;
         case EGamePhase::EGameOver:
-            HandleGameOver(PlayerUnits.Num() == 0 ? TEXT("AI") : TEXT("Player"));
+            SaveReplay(); // Una sola volta per partita, al passaggio di fase
+            HandleGameOver(GetWinnerName());
             break;
         default:
             break;
@@ -14,6 +14,23 @@
 // Includi il gestore della griglia
 #include "PAASchifanoFrancesco/Grid/GridManager.h"
 
+// Mappe di minaccia per fazione (IA e overlay)
+#include "PAASchifanoFrancesco/AI/InfluenceMap.h"
+
+// Stream casuali della partita (mappa, IA, combattimento)
+#include "PAASchifanoFrancesco/Simulation/MatchRandom.h"
+
+// Log binario dei comandi della partita (history, replay, rete)
+#include "PAASchifanoFrancesco/Simulation/MatchCommandLog.h"
+
+// Registro delle unità (handle stabili, statistiche in colonne)
+#include "PAASchifanoFrancesco/Units/UnitRegistry.h"
+
+// Task per la scrittura asincrona dei salvataggi
+#include "Tasks/Task.h"
+
+class FLockstepSession;
+
 #include "MyGameMode.generated.h"
 
 // Forward declarations per classi UI
@@ -23,6 +40,7 @@ class ABattleManager;
 class APlacementManager;
 class UTurnManager;
 class AUnitMovementManager;
+class UAIPonderer;
 
 // Enum che rappresenta le fasi del gioco
 UENUM()
@@ -47,8 +65,9 @@ enum class EPlayer : uint8
 UENUM()
 enum class EAILevel : uint8
 {
-	Easy,  // AI più semplice (movimenti casuali)
-	Hard   // AI più complessa (scelte tattiche)
+	Easy,    // AI più semplice (movimenti casuali)
+	Hard,    // AI più complessa (scelte tattiche)
+	Utility  // AI a punteggio (valuta tutte le coppie destinazione/bersaglio)
 };
 
 // Delegato per notificare il cambio di fase di gioco
@@ -83,6 +102,28 @@ public:
 	void HandleBattlePhase();
 	void HandleGameOver(const FString& WinnerName);
 
+	// Imposta il seed della partita e rigenera la mappa (usato dal menu principale)
+	void SetMatchSeed(int32 Seed);
+
+	// Scrive il replay della partita (seed, ostacoli, log dei comandi) in Saved/Replays
+	void SaveReplay();
+
+	// Salva la partita in corso nello slot indicato (scrittura del file in background)
+	bool SaveMatch(const FString& SlotName);
+
+	// Carica lo slot indicato e ricostruisce unità, griglia e history (solo durante la battaglia)
+	bool LoadMatch(const FString& SlotName);
+
+	// Salvataggio automatico a ogni fine turno
+	void AutosaveMatch() { SaveMatch(TEXT("Autosave")); }
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Lockstep in loopback (-Lockstep): i comandi di ogni turno concluso vengono inviati a un peer
+	// specchio, che li applica alla propria board e ne verifica il checksum
+	void StartLockstep();
+	void PublishLockstepTurn();
+
 	// Gestione lancio della moneta e accesso risultato
 	void FlipCoin();
 	EPlayer GetCoinFlipResult() const { return StartingPlayer; }
@@ -95,13 +136,18 @@ public:
 	AGridManager* GetGridManager() const { return GridManager; }
 	void SetGridManager(AGridManager* NewGridManager) { GridManager = NewGridManager; }
 	UUITurnIndicator* GetTurnIndicatorWidget() const { return TurnIndicatorWidget; }
+	UAIPonderer* GetAIPonderer() const { return AIPonderer; }
+	FInfluenceMap& GetInfluenceMap() { return InfluenceMap; }
+	FMatchRandom& GetMatchRandom() { return MatchRandom; }
+	FMatchCommandLog& GetCommandLog() { return CommandLog; }
+	FUnitRegistry& GetUnitRegistry() { return UnitRegistry; }
+	const FUnitRegistry& GetUnitRegistry() const { return UnitRegistry; }
 
-	// Liste delle unità controllate dal player e dall'AI
-	TArray<AUnitBase*> PlayerUnits;
-	TArray<AUnitBase*> AIUnits;
+	// Registra nel log il movimento di un'unità (tile di partenza e percorso convertiti in indici)
+	void RecordMove(const AUnitBase* Unit, const ATile* From, const TArray<ATile*>& Path);
 
-	// Aggiunge una riga allo storico delle mosse
-	void AddMoveToHistory(const FString& Entry);
+	// Unità in partita di entrambe le fazioni (handle stabili, statistiche in colonne per fazione)
+	FUnitRegistry UnitRegistry;
 
 	// Riferimenti ai manager principali (Movement, Placement, Turni, Battaglia)
 	UPROPERTY()
@@ -116,6 +162,29 @@ public:
 	UPROPERTY()
 	AUnitMovementManager* GlobalMovementManager;
 
+	// Pondering dell'AI durante il turno del player (solo AI Hard)
+	UPROPERTY()
+	UAIPonderer* AIPonderer;
+
+	// Mappe di minaccia aggiornate in modo incrementale a ogni decisione dell'AI
+	FInfluenceMap InfluenceMap;
+
+	// Seed e stream casuali della partita: con lo stesso seed la partita si ripete identica
+	FMatchRandom MatchRandom;
+
+	// Log dei comandi della partita: unica fonte per history, replay, undo e rete
+	FMatchCommandLog CommandLog;
+
+	// Peer locale e peer specchio del lockstep (nulli se il lockstep non è attivo)
+	TSharedPtr<FLockstepSession> LockstepLocal;
+	TSharedPtr<FLockstepSession> LockstepMirror;
+
+	// Comandi del log già inviati al peer
+	int32 LockstepSentCommands = 0;
+
+	// Ultima scrittura di un salvataggio: le successive vengono accodate a questa
+	UE::Tasks::FTask PendingSave;
+
 	// Widget attivi durante il gioco (status, indicatori, info)
 	UPROPERTY()
 	UStatusGameWidget* StatusGameWidget;
@@ -130,6 +199,42 @@ public:
 	UPROPERTY(EditAnywhere, Category = "AI")
 	EAILevel AILevel = EAILevel::Hard;
 
+	// Unità piazzate da ogni fazione, alternando Sniper e Brawler (-UnitsPerSide=<n>)
+	UPROPERTY(EditAnywhere, Category = "Roster", meta = (ClampMin = "1", ClampMax = "200"))
+	int32 UnitsPerSide = 2;
+
+	// Squadre in partita: la squadra 0 è il player, le altre sono giocate dall'IA (-Teams=<n>)
+	UPROPERTY(EditAnywhere, Category = "Roster", meta = (ClampMin = "2", ClampMax = "4"))
+	int32 NumTeams = 2;
+
+	// Nome dell'ultima squadra rimasta in gioco ("Player", "AI", "AI 2", ...)
+	FString GetWinnerName() const;
+
+	// Quante unità del tipo indicato ogni fazione può piazzare (gli Sniper prendono l'eventuale unità dispari)
+	int32 GetRosterQuota(bool bRanged) const { return bRanged ? (UnitsPerSide + 1) / 2 : UnitsPerSide / 2; }
+
+	// Velocità di riproduzione delle azioni dell'AI: moltiplica tutti i delay e la durata dei movimenti
+	// (1 = velocità normale, 0.5 = doppia velocità, 0 = risoluzione istantanea).
+	// Può essere impostata da riga di comando con -AIPlayback=<valore>
+	UPROPERTY(EditAnywhere, Category = "AI", meta = (ClampMin = "0.0"))
+	float AIPlaybackScale = 1.0f;
+
+	// Con almeno questo numero di unità, l'AI Hard muove tutta la squadra contemporaneamente
+	// invece di animare le unità una alla volta (-ConcurrentMoves=<n>, 0 = mai)
+	UPROPERTY(EditAnywhere, Category = "AI", meta = (ClampMin = "0"))
+	int32 ConcurrentMoveMinUnits = 4;
+
+	// Finestra (in passi) della pianificazione cooperativa dei movimenti contemporanei (-CoopWindow=<n>):
+	// una finestra più grande evita più attese ma costa più CPU per unità
+	UPROPERTY(EditAnywhere, Category = "AI", meta = (ClampMin = "2", ClampMax = "32"))
+	int32 CooperativeWindow = 8;
+
+	// Restituisce il delay da usare per un'azione dell'AI, scalato da AIPlaybackScale
+	float GetAIDelay(float BaseDelay) const { return BaseDelay * AIPlaybackScale; }
+
+	// Restituisce la velocità di movimento delle unità AI (0 = movimento istantaneo)
+	float GetAIMoveSpeed(float BaseSpeed) const { return AIPlaybackScale > 0.f ? BaseSpeed / AIPlaybackScale : 0.f; }
+
 protected:
 	// Classi dei vari widget utilizzati nel gioco
 	UPROPERTY(EditDefaultsOnly, Category = "UI")
@@ -5,9 +5,11 @@
 #include "TurnManager.h"
 #include "PAASchifanoFrancesco/Units/Brawler.h"
 #include "PAASchifanoFrancesco/Units/Sniper.h"
+#include "PAASchifanoFrancesco/Units/UnitPool.h"
 #include "PAASchifanoFrancesco/Grid/GridManager.h"
 #include "PAASchifanoFrancesco/Grid/Tile.h"
 #include "PAASchifanoFrancesco/UI/SelectPawn.h"
+#include "PAASchifanoFrancesco/Simulation/SimBoard.h"
 #include "Kismet/GameplayStatics.h"
 
 /**
@@ -131,16 +133,13 @@ void APlacementManager::PlacePlayerPawn(ATile* ClickedTile)
     FVector SpawnLocation = ClickedTile->GetPawnSpawnLocation();
     UE_LOG(LogTemp, Warning, TEXT("Posizione di spawn calcolata: %s"), *SpawnLocation.ToString());
 
-    FActorSpawnParameters SpawnParams;
-    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
-    SpawnParams.bNoFail = true;
+    // Unità dal pool (spawnata solo se non ce ne sono di libere)
+    AUnitBase* NewPawn = UUnitPool::Get(this)->Acquire(PlayerPawnType, SpawnLocation);
 
-    // Spawn dell’unità
-    AUnitBase* NewPawn = GetWorld()->SpawnActor<AUnitBase>(PlayerPawnType, SpawnLocation, FRotator::ZeroRotator, SpawnParams);
-    
     if (!NewPawn)
     {
         UE_LOG(LogTemp, Error, TEXT("SpawnActor ha fallito per: %s"), *PlayerPawnType->GetName());
+        return;
     }
 
     // Imposta il nome a seconda del tipo di unità
@@ -155,13 +154,18 @@ void APlacementManager::PlacePlayerPawn(ATile* ClickedTile)
 
     // Aggiorna stato della tile e dell'unità
     ClickedTile->SetHasPawn(true);
+    GridManager->SetUnitTile(NewPawn, GridManager->GetTileIndex(ClickedTile));
     NewPawn->SetIsPlayerController(true);
+    NewPawn->SetTeamID(FUnitRegistry::PlayerTeam);
 
     // Registra la mossa nel TurnManager
     GM->TurnManager->RegisterPlacementMove(NewPawn);
 
-    // Disabilita il bottone corrispondente alla pedina usata
-    if (SelectPawn)
+    // Disabilita il bottone della pedina usata quando la squadra ne ha piazzate quante previsto
+    const bool bRanged = NewPawn->IsRangedAttack();
+    const int32 PlacedOfType = bRanged ? GM->GetUnitRegistry().CountRanged(FUnitRegistry::PlayerTeam)
+        : GM->GetUnitRegistry().Num(FUnitRegistry::PlayerTeam) - GM->GetUnitRegistry().CountRanged(FUnitRegistry::PlayerTeam);
+    if (SelectPawn && PlacedOfType >= GM->GetRosterQuota(bRanged))
     {
         SelectPawn->DisableButtonForPawn(PlayerPawnType);
     }
@@ -207,7 +211,7 @@ void APlacementManager::PlaceAIPawn()
     }
 
     // Sceglie una tile casuale dall'elenco di quelle disponibili
-    int32 RandomIndex = FMath::RandRange(0, AvailableTiles.Num() - 1);
+    int32 RandomIndex = GM->GetMatchRandom().AI.RandRange(0, AvailableTiles.Num() - 1); // Stream AI della partita
     ATile* ChosenTile = AvailableTiles[RandomIndex];
 
     // Controlla che la tile selezionata non sia nulla (per sicurezza)
@@ -220,38 +224,34 @@ void APlacementManager::PlaceAIPawn()
     // Ottiene la posizione di spawn dalla tile selezionata
     FVector SpawnLocation = ChosenTile->GetPawnSpawnLocation();
 
-    // Parametri di spawn per l'attore (unità AI)
-    FActorSpawnParameters SpawnParams;
-    // Forza lo spawn anche in caso di collisioni
-    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    // Decide il tipo di unità IA da spawnare per la squadra di turno:
+    // le unità si alternano partendo dallo Sniper (Sniper, Brawler, Sniper, ...)
+    const int32 Team = GM->TurnManager->GetCurrentTeam();
+    AIPawnType = (GM->GetUnitRegistry().Num(Team) % 2 == 0) ? ASniper::StaticClass() : ABrawler::StaticClass();
 
-    // Decide il tipo di unità IA da spawnare:
-    // Se nessuna IA è ancora stata spawnata → Sniper, altrimenti → Brawler
-    AIPawnType = (GM->AIUnits.Num() == 0) ? ASniper::StaticClass() : ABrawler::StaticClass();
-
-    // Spawna effettivamente l'unità IA nel mondo
-    AUnitBase* AIPawn = GetWorld()->SpawnActor<AUnitBase>(
-        AIPawnType,         // Tipo dell'unità da spawnare (Sniper o Brawler)
-        SpawnLocation,      // Posizione di spawn
-        FRotator::ZeroRotator, // Rotazione iniziale (zero)
-        SpawnParams         // Parametri di spawn definiti sopra
-    );
+    // Prende l'unità IA dal pool (spawnata solo se non ce ne sono di libere)
+    AUnitBase* AIPawn = UUnitPool::Get(this)->Acquire(AIPawnType, SpawnLocation);
 
     // Se lo spawn ha avuto successo...
     if (AIPawn)
     {
         // Imposta il nome visualizzato a schermo per distinguere il tipo
+        const FString TeamName = FSimBoard::GetTeamName(Team);
         if (AIPawn->IsA(ASniper::StaticClass()))
         {
-            AIPawn->UnitDisplayName = TEXT("Sniper (AI)");
+            AIPawn->UnitDisplayName = FString::Printf(TEXT("Sniper (%s)"), *TeamName);
         }
         else if (AIPawn->IsA(ABrawler::StaticClass()))
         {
-            AIPawn->UnitDisplayName = TEXT("Brawler (AI)");
+            AIPawn->UnitDisplayName = FString::Printf(TEXT("Brawler (%s)"), *TeamName);
         }
 
+        // La squadra decide registro, bersagli e ordine dei turni
+        AIPawn->SetTeamID(Team);
+
         // Aggiorna la tile selezionata per indicare che ora contiene un'unità
         ChosenTile->SetHasPawn(true);
+        GridManager->SetUnitTile(AIPawn, GridManager->GetTileIndex(ChosenTile));
 
         // Registra la nuova unità nel TurnManager (per tracciamento turno IA)
         GM->TurnManager->RegisterPlacementMove(AIPawn);
@@ -1,12 +1,14 @@
 #include "TurnManager.h"
 #include "MyGameMode.h"
+#include "GameServices.h"
 #include "BattleManager.h"
 #include "PlacementManager.h"
 #include "PAASchifanoFrancesco/UI/UITurnIndicator.h"
 #include "PAASchifanoFrancesco/UI/StatusGameWidget.h"
 #include "PAASchifanoFrancesco/Grid/GridManager.h"
 #include "PAASchifanoFrancesco/Input/MyPlayerController.h"
-#include "Kismet/GameplayStatics.h"
+#include "PAASchifanoFrancesco/AI/AIPonderer.h"
+#include "PAASchifanoFrancesco/Simulation/SimBoard.h"
 #include "TimerManager.h"
 
 /**
@@ -21,7 +23,7 @@ void UTurnManager::Initialize(AMyGameMode* InGameMode, ABattleManager* InBattleM
     GameMode = InGameMode; // Salva il riferimento al GameMode passato come parametro
     BattleManager = InBattleManager; // Salva il riferimento al BattleManager (usato nella fase di battaglia)
 
-    CurrentPlayer = EPlayer::Player1; // Imposta il giocatore iniziale come Player1
+    SetCurrentTeam(FUnitRegistry::PlayerTeam); // Imposta il giocatore iniziale come Player1
 
     if (GameMode) // Verifica che il GameMode sia valido
     {
@@ -53,7 +55,7 @@ void UTurnManager::StartTurn()
     UpdateTurnUI(); // Aggiorna il widget grafico per mostrare a chi appartiene il turno corrente
 
     // Stampa nel log il nome del giocatore che sta iniziando il turno
-    UE_LOG(LogTemp, Warning, TEXT("[TurnManager] Inizia il turno di: %s"), *UEnum::GetValueAsString(CurrentPlayer));
+    UE_LOG(LogTemp, Warning, TEXT("[TurnManager] Inizia il turno di: %s"), *FSimBoard::GetTeamName(CurrentTeam));
 
     // Controlla se siamo nella fase di piazzamento
     if (GameMode->GetCurrentGamePhase() == EGamePhase::EPlacement)
@@ -67,11 +69,23 @@ void UTurnManager::StartTurn()
             // Recupera il PlacementManager per far piazzare una pedina all'IA
             if (APlacementManager* PM = GameMode->GetPlacementManager())
             {
-                // Imposta un timer di 3 secondi prima di far piazzare la pedina all’IA
-                GameMode->GetWorld()->GetTimerManager().SetTimer(AITurnTimerHandle, [this, PM]()
+                // Imposta un timer di 3 secondi (scalati dalla velocità dell'AI) prima di far piazzare la pedina all’IA
+                const float PlacementDelay = GameMode->GetAIDelay(3.0f);
+                if (PlacementDelay > 0.f)
                 {
-                    PM->PlaceAIPawn(); // Piazzamento effettivo della pedina da parte dell’IA
-                }, 3.0f, false);
+                    GameMode->GetWorld()->GetTimerManager().SetTimer(AITurnTimerHandle, [this, PM]()
+                    {
+                        PM->PlaceAIPawn(); // Piazzamento effettivo della pedina da parte dell’IA
+                    }, PlacementDelay, false);
+                }
+                else
+                {
+                    // Modalità istantanea: piazza al tick successivo per non annidare StartTurn
+                    AITurnTimerHandle = GameMode->GetWorld()->GetTimerManager().SetTimerForNextTick([PM]()
+                    {
+                        PM->PlaceAIPawn();
+                    });
+                }
             }
         }
     }
@@ -87,14 +101,16 @@ void UTurnManager::StartTurn()
         // Se è il turno del player
         if (CurrentPlayer == EPlayer::Player1)
         {
-            // Recupera il controller del giocatore
-            if (APlayerController* PC = UGameplayStatics::GetPlayerController(GameMode, 0))
+            // Recupera il controller del giocatore dal registro dei servizi
+            if (AMyPlayerController* MyPC = UGameServices::Get(GameMode)->GetPlayerController())
             {
-                // Cast al controller personalizzato
-                if (AMyPlayerController* MyPC = Cast<AMyPlayerController>(PC))
-                {
-                    MyPC->SetMovementLocked(false); // Sblocca il movimento per permettere l'interazione
-                }
+                MyPC->SetMovementLocked(false); // Sblocca il movimento per permettere l'interazione
+            }
+
+            // Mentre il player pensa, l'AI Hard pre-calcola le proprie risposte
+            if (GameMode->AILevel == EAILevel::Hard && GameMode->GetAIPonderer())
+            {
+                GameMode->GetAIPonderer()->BeginPondering();
             }
         }
         // Se è il turno dell’IA e il BattleManager è disponibile
@@ -111,8 +127,9 @@ void UTurnManager::StartTurn()
 
 /**
  * Scopo del metodo:
- * Questo metodo termina il turno del giocatore attuale e passa il turno all’altro giocatore (Player1 → AI o AI → Player1).
- * Prima di farlo, pulisce gli highlight dalla griglia e resetta lo stato di tutte le unità del giocatore uscente.
+ * Questo metodo termina il turno della squadra attuale e passa il turno alla successiva ancora in gioco
+ * (con due squadre: Player1 → AI o AI → Player1).
+ * Prima di farlo, pulisce gli highlight dalla griglia e resetta lo stato di tutte le unità della squadra uscente.
  * Dopo un breve delay, avvia il nuovo turno.
  */
 void UTurnManager::EndTurn()
@@ -127,34 +144,45 @@ void UTurnManager::EndTurn()
         GridManager->ClearHighlights(); // Rimuove qualsiasi highlight (es. movimento, attacco)
     }
 
-    // Se il turno attuale è del Player
-    if (CurrentPlayer == EPlayer::Player1)
-    {
-        // Per ogni unità del Player, resetta lo stato di azione (Idle, Moved, Attacked)
-        for (AUnitBase* PlayerUnit : GameMode->PlayerUnits)
-        {
-            PlayerUnit->ResetAction(); // Ritorna lo stato dell'unità a Idle
-        }
+    // Registra la fine del turno nel log dei comandi
+    GameMode->GetCommandLog().AppendEndTurn(CurrentPlayer == EPlayer::Player1, CurrentTeam);
 
-        // Passa il turno all’IA
-        UE_LOG(LogTemp, Warning, TEXT("Cambio turno: Ora è il turno dell'AI."));
-        CurrentPlayer = EPlayer::AI;
-    }
-    else // Se il turno attuale è dell’IA
+    // Le mosse del turno concluso non si possono più annullare
+    ClearUndoHistory();
+
+    // Il pondering si ferma: il piano della radice resta disponibile per PrepareAITurn
+    if (CurrentPlayer == EPlayer::Player1 && GameMode->GetAIPonderer())
     {
-        // Per ogni unità dell’IA, resetta lo stato di azione
-        for (AUnitBase* AIUnit : GameMode->AIUnits)
-        {
-            AIUnit->ResetAction(); // Anche le unità IA tornano a Idle
-        }
+        GameMode->GetAIPonderer()->StopPondering();
+    }
 
-        // Passa il turno al Player
-        UE_LOG(LogTemp, Warning, TEXT("Cambio turno: Ora è il turno del Player."));
-        CurrentPlayer = EPlayer::Player1;
+    // Per ogni unità della squadra uscente, resetta lo stato di azione (Idle, Moved, Attacked)
+    for (AUnitBase* Unit : GameMode->GetUnitRegistry().GetUnits(CurrentTeam))
+    {
+        Unit->ResetAction(); // Ritorna lo stato dell'unità a Idle
     }
 
-    // Attende 1 secondo prima di iniziare il nuovo turno (per chiarezza visiva e transizioni)
-    GameMode->GetWorld()->GetTimerManager().SetTimer( AITurnTimerHandle, this, &UTurnManager::StartTurn, 1.0f, false );
+    // Passa il turno alla prossima squadra con unità in gioco
+    SetCurrentTeam(FindNextTeam());
+    UE_LOG(LogTemp, Warning, TEXT("Cambio turno: Ora è il turno di %s."), *FSimBoard::GetTeamName(CurrentTeam));
+
+    // Il turno concluso viene inviato al peer del lockstep (comandi e checksum, pochi byte)
+    GameMode->PublishLockstepTurn();
+
+    // Autosave all'inizio del nuovo turno (la scrittura del file avviene in background)
+    GameMode->AutosaveMatch();
+
+    // Attende 1 secondo prima di iniziare il nuovo turno (per chiarezza visiva e transizioni).
+    // Il delay segue la velocità dell'AI; con velocità istantanea il turno parte al tick successivo
+    const float TurnDelay = GameMode->GetAIDelay(1.0f);
+    if (TurnDelay > 0.f)
+    {
+        GameMode->GetWorld()->GetTimerManager().SetTimer( AITurnTimerHandle, this, &UTurnManager::StartTurn, TurnDelay, false );
+    }
+    else
+    {
+        AITurnTimerHandle = GameMode->GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UTurnManager::StartTurn);
+    }
 }
 
 /**
@@ -166,18 +194,25 @@ void UTurnManager::EndTurn()
  */
 void UTurnManager::RegisterPlacementMove(AUnitBase* Unit)
 {
-    // Se l'unità è stata piazzata dal Player, la aggiungiamo alla lista PlayerUnits
-    if (CurrentPlayer == EPlayer::Player1)
+    // Registra il piazzamento nel log dei comandi (l'unità è già sulla sua tile)
+    if (AGridManager* GridManager = GameMode->GetGridManager())
     {
-        GameMode->PlayerUnits.Add(Unit);  // Salva la nuova unità del player
+        const int32 TileIndex = GridManager->GetTileIndex(GridManager->FindTileAtLocation(Unit->GetActorLocation()));
+        GameMode->GetCommandLog().AppendPlace(CurrentPlayer == EPlayer::Player1, Unit->IsRangedAttack(), TileIndex, Unit->GetTeamID());
     }
-    else // Altrimenti è dell’IA
+
+    // Registra l'unità nella squadra di chi l'ha piazzata (l'attore ha già TeamID e flag del controllo)
+    FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+    Registry.Add(Unit);
+
+    // Verifica se tutte le squadre hanno completato la propria rosa
+    bool bAllPlaced = true;
+    for (int32 Team = 0; Team < Registry.GetNumTeams(); ++Team)
     {
-        GameMode->AIUnits.Add(Unit);  // Salva la nuova unità dell'IA
+        bAllPlaced &= Registry.Num(Team) >= GameMode->UnitsPerSide;
     }
 
-    // Verifica se entrambe le fazioni hanno piazzato almeno due unità
-    if (GameMode->PlayerUnits.Num() > 1 && GameMode->AIUnits.Num() > 1)
+    if (bAllPlaced)
     {
         // Se sì, allora si può terminare la fase di piazzamento e passare alla battaglia
         if (GameMode && GameMode->GetPlacementManager())
@@ -188,8 +223,8 @@ void UTurnManager::RegisterPlacementMove(AUnitBase* Unit)
     }
     else
     {
-        // Se non tutte le unità sono ancora state piazzate, si passa il turno all’altro giocatore
-        CurrentPlayer = (CurrentPlayer == EPlayer::Player1) ? EPlayer::AI : EPlayer::Player1;
+        // Se non tutte le unità sono ancora state piazzate, si passa il turno alla prossima squadra incompleta
+        SetCurrentTeam(FindNextTeam());
 
         // Si avvia un nuovo turno di piazzamento (AI o Player in base al cambio sopra)
         StartTurn();
@@ -209,6 +244,7 @@ void UTurnManager::RegisterPlacementMove(AUnitBase* Unit)
 void UTurnManager::RegisterPlayerMove(AUnitBase* Unit)
 {
     Unit->SetCurrentAction(EUnitAction::Moved); // Imposta lo stato dell'unità su "Moved"
+    NotifyPonderer(Unit); // Pota l'albero speculativo dell'AI al ramo realmente giocato
     CheckPlayerEndTurn(Unit); // Verifica se è possibile terminare il turno del player
 }
 
@@ -220,7 +256,15 @@ void UTurnManager::RegisterPlayerMove(AUnitBase* Unit)
  */
 void UTurnManager::RegisterPlayerAttack(AUnitBase* Unit)
 {
-    Unit->SetCurrentAction(EUnitAction::Attacked);
+    // Il danno tirato è ormai noto: annullare le mosse precedenti permetterebbe di ritentare il tiro
+    ClearUndoHistory();
+
+    // Un attaccante ucciso dal contrattacco è già nel pool: si verifica solo la fine del turno
+    if (!Unit->IsDead())
+    {
+        Unit->SetCurrentAction(EUnitAction::Attacked);
+    }
+    NotifyPonderer(Unit);
     CheckPlayerEndTurn(Unit);
 }
 
@@ -243,6 +287,9 @@ void UTurnManager::RegisterAIMove(AUnitBase* Unit)
  */
 void UTurnManager::RegisterAIAttack(AUnitBase* Unit)
 {
+    // Un attaccante ucciso dal contrattacco è già nel pool
+    if (Unit->IsDead()) return;
+
     Unit->SetCurrentAction(EUnitAction::Attacked);
 }
 
@@ -256,7 +303,45 @@ void UTurnManager::RegisterAIAttack(AUnitBase* Unit)
  */
 void UTurnManager::SetInitialPlayer(EPlayer StartingPlayer)
 {
-    CurrentPlayer = StartingPlayer;
+    SetCurrentTeam(StartingPlayer == EPlayer::Player1 ? FUnitRegistry::PlayerTeam : FUnitRegistry::AITeam);
+}
+
+/**
+ * Descrizione:
+ * Imposta la squadra di turno. Il giocatore corrente ne deriva: la squadra 0 è il player,
+ * tutte le altre sono giocate dall'IA (BattleManager e PlacementManager leggono la squadra).
+ */
+void UTurnManager::SetCurrentTeam(int32 Team)
+{
+    CurrentTeam = Team;
+    CurrentPlayer = Team == FUnitRegistry::PlayerTeam ? EPlayer::Player1 : EPlayer::AI;
+}
+
+/**
+ * Descrizione:
+ * Scorre le squadre a partire da quella successiva alla corrente. In battaglia la maschera delle
+ * squadre vive del registro evita di contare le unità; in piazzamento si salta chi ha già la rosa completa.
+ * Se nessun'altra squadra può giocare il turno resta alla squadra corrente.
+ */
+int32 UTurnManager::FindNextTeam() const
+{
+    const FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+    const bool bPlacement = GameMode->GetCurrentGamePhase() == EGamePhase::EPlacement;
+    const int32 NumTeams = Registry.GetNumTeams();
+
+    for (int32 Offset = 1; Offset <= NumTeams; ++Offset)
+    {
+        const int32 Team = (CurrentTeam + Offset) % NumTeams;
+        const bool bCanPlay = bPlacement
+            ? Registry.Num(Team) < GameMode->UnitsPerSide
+            : (Registry.GetAliveTeamsMask() & (1u << Team)) != 0;
+
+        if (bCanPlay)
+        {
+            return Team;
+        }
+    }
+    return CurrentTeam;
 }
 
 /**
@@ -273,8 +358,8 @@ void UTurnManager::UpdateTurnUI()
     // Verifica che GameMode e il widget TurnIndicator siano validi
     if (GameMode && GameMode->GetTurnIndicatorWidget())
     {
-        // Determina il nome da mostrare a seconda del giocatore corrente
-        FString PlayerName = (CurrentPlayer == EPlayer::Player1) ? TEXT("Player") : TEXT("AI");
+        // Determina il nome da mostrare a seconda della squadra corrente ("Player", "AI", "AI 2", ...)
+        FString PlayerName = FSimBoard::GetTeamName(CurrentTeam);
 
         // Aggiorna il testo nel widget TurnIndicator
         GameMode->GetTurnIndicatorWidget()->UpdateTurnText(PlayerName);
@@ -312,7 +397,7 @@ void UTurnManager::CheckPlayerEndTurn(AUnitBase* Unit)
     bool bHasIdleUnit = false;   // Almeno una unità è ancora "Idle"
 
     // Itera su tutte le unità del giocatore
-    for (AUnitBase* PlayerUnit : GameMode->PlayerUnits)
+    for (AUnitBase* PlayerUnit : GameMode->GetUnitRegistry().GetPlayerUnits())
     {
         // Ottiene lo stato corrente dell’unità
         EUnitAction Action = PlayerUnit->GetCurrentAction();
@@ -353,4 +438,125 @@ void UTurnManager::CheckPlayerEndTurn(AUnitBase* Unit)
         UE_LOG(LogTemp, Warning, TEXT("Nessuna unità è Idle o Moved. Tutte hanno attaccato. Fine turno automatica."));
         EndTurn();  // Chiama direttamente la fine del turno
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Descrizione:
+ * Notifica al ponderer dell'AI un'azione del player, così che l'albero speculativo
+ * venga ridotto al ramo realmente giocato. Le chiamate per unità dell'IA (es. OnMovementFinished
+ * durante il turno dell'AI) vengono ignorate.
+ *
+ * @param Unit 
+ */
+void UTurnManager::NotifyPonderer(AUnitBase* Unit)
+{
+    if (!GameMode || !GameMode->GetAIPonderer()) return;
+    if (CurrentPlayer != EPlayer::Player1 || !Unit || !Unit->IsPlayerControlled()) return;
+
+    GameMode->GetAIPonderer()->OnPlayerAction();
+}
+
+/**
+ * Descrizione:
+ * Memorizza un movimento del player. Viene chiamato prima dell'animazione,
+ * quando il comando Move è già stato scritto nel log.
+ */
+void UTurnManager::RecordPlayerUndo(FPlayerUndoEntry&& Entry)
+{
+    UndoStack.Add(MoveTemp(Entry));
+    RedoStack.Reset();
+}
+
+void UTurnManager::ClearUndoHistory()
+{
+    UndoStack.Reset();
+    RedoStack.Reset();
+}
+
+/**
+ * Descrizione:
+ * Spostamento senza animazione usato da undo e redo: libera la tile di partenza,
+ * occupa quella di arrivo e posiziona l'unità.
+ */
+bool UTurnManager::TeleportUnit(AUnitBase* Unit, int32 FromTile, int32 ToTile)
+{
+    AGridManager* GridManager = GameMode ? GameMode->GetGridManager() : nullptr;
+    if (!GridManager || !Unit) return false;
+
+    ATile* From = GridManager->GetTileByIndex(FromTile);
+    ATile* To = GridManager->GetTileByIndex(ToTile);
+    if (!From || !To || To->IsObstacle() || To->GetHasPawn()) return false;
+
+    From->SetHasPawn(false);
+    To->SetHasPawn(true);
+    GridManager->SetUnitTile(Unit, ToTile);
+    Unit->SetActorLocation(To->GetPawnSpawnLocation());
+    return true;
+}
+
+/**
+ * Descrizione:
+ * Annulla l'ultimo movimento del player con il comando inverso:
+ * l'unità torna alla tile di partenza, riprende lo stato precedente e il comando Move
+ * viene scartato dal log (la history si aggiorna di conseguenza).
+ */
+bool UTurnManager::UndoPlayerMove()
+{
+    if (!GameMode || CurrentPlayer != EPlayer::Player1 || UndoStack.Num() == 0) return false;
+    if (GameMode->GetCurrentGamePhase() != EGamePhase::EBattle) return false;
+
+    FPlayerUndoEntry Entry = UndoStack.Pop();
+    AUnitBase* Unit = Entry.Unit.Get();
+    if (!Unit || Unit->IsInPool() || Entry.Path.Num() == 0 || !TeleportUnit(Unit, Entry.Path.Last(), Entry.FromTile))
+    {
+        ClearUndoHistory();
+        return false;
+    }
+
+    Unit->SetCurrentAction(Entry.PreviousAction);
+    GameMode->GetCommandLog().Truncate(Entry.CommandIndex);
+
+    if (AGridManager* GridManager = GameMode->GetGridManager())
+    {
+        GridManager->ClearHighlights();
+    }
+
+    // L'unità torna disponibile: il pulsante di fine turno viene ricalcolato
+    OnCanEndTurn.Broadcast(false);
+    NotifyPonderer(Unit);
+    CheckPlayerEndTurn(Unit);
+
+    RedoStack.Add(MoveTemp(Entry));
+    return true;
+}
+
+/**
+ * Descrizione:
+ * Ripete l'ultimo movimento annullato (senza animazione) e lo registra di nuovo nel log.
+ */
+bool UTurnManager::RedoPlayerMove()
+{
+    if (!GameMode || CurrentPlayer != EPlayer::Player1 || RedoStack.Num() == 0) return false;
+    if (GameMode->GetCurrentGamePhase() != EGamePhase::EBattle) return false;
+
+    FPlayerUndoEntry Entry = RedoStack.Pop();
+    AUnitBase* Unit = Entry.Unit.Get();
+    if (!Unit || Unit->IsInPool() || Entry.Path.Num() == 0 || !TeleportUnit(Unit, Entry.FromTile, Entry.Path.Last()))
+    {
+        RedoStack.Reset();
+        return false;
+    }
+
+    FMatchCommandLog& CommandLog = GameMode->GetCommandLog();
+    Entry.CommandIndex = CommandLog.Num();
+    CommandLog.AppendMove(true, Unit->IsRangedAttack(), Entry.FromTile, Entry.Path);
+
+    if (AGridManager* GridManager = GameMode->GetGridManager())
+    {
+        GridManager->ClearHighlights();
+    }
+
+    UndoStack.Add(MoveTemp(Entry));
+    RegisterPlayerMove(Unit);
+    return true;
+}
@@ -18,6 +18,26 @@ class AUnitBase;
  */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCanEndTurn, bool, IsVisible);
 
+/**
+ * Descrizione:
+ * Movimento del player annullabile. L'undo applica il comando inverso (l'unità torna sulla tile
+ * di partenza) e scarta il comando dal log: costa quanto l'azione, senza ricaricare la partita.
+ */
+struct FPlayerUndoEntry
+{
+    TWeakObjectPtr<AUnitBase> Unit;
+
+    /** Tile di partenza e percorso (indici di griglia); la destinazione è l'ultima tile */
+    int32 FromTile = INDEX_NONE;
+    TArray<int32> Path;
+
+    /** Stato dell'unità prima del movimento */
+    EUnitAction PreviousAction = EUnitAction::Idle;
+
+    /** Indice del comando Move nel log dei comandi */
+    int32 CommandIndex = INDEX_NONE;
+};
+
 /**
  * Classe: UTurnManager
  * Descrizione: gestisce il flusso dei turni nel gioco a turni.
@@ -100,17 +120,64 @@ public:
     /**
      * Metodo: SetInitialPlayer
      * Imposta quale giocatore inizia la partita (usato dopo il CoinFlip).
+     * Se inizia l'IA il primo turno è della squadra AITeam.
      */
     void SetInitialPlayer(EPlayer StartingPlayer);
 
+    /**
+     * Metodo: SetCurrentTeam
+     * Imposta la squadra di turno (caricamento di una partita con più squadre IA).
+     */
+    void SetCurrentTeam(int32 Team);
+
+    /**
+     * Metodo: RecordPlayerUndo
+     * Memorizza un movimento del player appena ordinato, così da poterlo annullare.
+     * Un nuovo movimento invalida le azioni annullate (redo).
+     */
+    void RecordPlayerUndo(FPlayerUndoEntry&& Entry);
+
+    /**
+     * Metodi: UndoPlayerMove / RedoPlayerMove
+     * Annullano o ripristinano l'ultimo movimento del player nel turno corrente.
+     * Disponibili solo finché nessun attacco ha rivelato un risultato casuale.
+     */
+    bool UndoPlayerMove();
+    bool RedoPlayerMove();
+
+    bool CanUndo() const { return UndoStack.Num() > 0; }
+    bool CanRedo() const { return RedoStack.Num() > 0; }
+
+    /** Svuota undo e redo (fine turno, attacco, caricamento) */
+    void ClearUndoHistory();
+
     /**
      * Metodo Getter: GetCurrentPlayer
      * Ritorna il giocatore che sta attualmente svolgendo il turno.
      */
     EPlayer GetCurrentPlayer() const { return CurrentPlayer; }
 
+    /**
+     * Metodo Getter: GetCurrentTeam
+     * Squadra di turno: 0 è il player, le altre sono controllate dall'IA.
+     */
+    int32 GetCurrentTeam() const { return CurrentTeam; }
+
 private:
 
+    /**
+     * Metodo: FindNextTeam
+     * Squadra che gioca dopo quella corrente, in ordine di TeamID. In piazzamento salta le squadre
+     * che hanno completato la rosa, in battaglia quelle senza unità vive.
+     */
+    int32 FindNextTeam() const;
+
+    /**
+     * Metodo: NotifyPonderer
+     * Informa il pondering dell'IA che il player ha agito, così da potare l'albero speculativo.
+     */
+    void NotifyPonderer(AUnitBase* Unit);
+
     /** Riferimento al GameMode principale per accedere a unità e fase attuale */
     UPROPERTY()
     AMyGameMode* GameMode;
@@ -119,14 +186,24 @@ private:
     UPROPERTY()
     ABattleManager* BattleManager;
 
-    /** Giocatore corrente (Player1 o AI) */
+    /** Giocatore corrente (Player1 o AI), derivato dalla squadra di turno */
     UPROPERTY()
     EPlayer CurrentPlayer;
 
+    /** Squadra di turno (TeamID delle unità) */
+    int32 CurrentTeam = FUnitRegistry::PlayerTeam;
+
     /** Delegato per la UI che segnala se è possibile terminare il turno */
     UPROPERTY()
     FOnCanEndTurn OnCanEndTurn;
 
+    /** Movimenti del turno corrente che possono essere annullati / ripristinati */
+    TArray<FPlayerUndoEntry> UndoStack;
+    TArray<FPlayerUndoEntry> RedoStack;
+
+    /** Sposta istantaneamente un'unità tra due tile aggiornando le occupazioni */
+    bool TeleportUnit(AUnitBase* Unit, int32 FromTile, int32 ToTile);
+
     /** Timer per gestire il delay dei turni automatici dell’IA */
     FTimerHandle AITurnTimerHandle;
 };
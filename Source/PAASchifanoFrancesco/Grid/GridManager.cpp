@@ -7,9 +7,13 @@
 #include "Tile.h"
 #include "PAASchifanoFrancesco/Core/TurnManager.h"
 #include "PAASchifanoFrancesco/Core/MyGameMode.h"
+#include "PAASchifanoFrancesco/AI/InfluenceMap.h"
 #include "Camera/CameraComponent.h"
 #include "Components/LightComponent.h"
 #include "Engine/DirectionalLight.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Algo/Reverse.h"
 
 /** 
  * Costruttore del GridManager
@@ -17,7 +21,6 @@
  * In questo costruttore si inizializzano tutte le variabili fondamentali per il gestore della griglia:
  * - si disattiva il Tick (non serve aggiornare ad ogni frame),
  * - si inizializzano i puntatori a nullptr,
- * - si genera una percentuale casuale per il numero di ostacoli (per rendere la generazione della griglia non prevedibile),
  * - si crea un componente root vuoto per ancorare le tile della griglia.
  */
 AGridManager::AGridManager()
@@ -27,12 +30,29 @@ AGridManager::AGridManager()
     TurnManager = nullptr;         // Il TurnManager verrà recuperato nel BeginPlay
     bAttackGridVisible = false;    // Nessuna griglia d’attacco è visibile all’avvio
 
-    // Percentuale casuale di ostacoli per ogni nuova partita (fra 30% e 95%)
-    float RandomPercent = FMath::FRandRange(0.3f, 0.95f);
-    ObstaclePercentage = FMath::Clamp(RandomPercent, 0.3f, 0.95f); // Clamp per sicurezza
-
     // Aggiungiamo un componente "root" che fungerà da genitore per tutte le tile
     RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+    // Marker dell'anteprima di movimento (percorso e bersagli)
+    static ConstructorHelpers::FObjectFinder<UStaticMesh> MarkerMeshRef(TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+    PathMarkers = CreateMarkerComponent(TEXT("PathMarkers"), MarkerMeshRef.Object);
+    AttackMarkers = CreateMarkerComponent(TEXT("AttackMarkers"), MarkerMeshRef.Object);
+}
+
+/**
+ * Crea un componente di marker istanziati: niente collisioni né ombre, servono solo come indicatori.
+ */
+UInstancedStaticMeshComponent* AGridManager::CreateMarkerComponent(const FName& Name, UStaticMesh* Mesh)
+{
+    UInstancedStaticMeshComponent* Markers = CreateDefaultSubobject<UInstancedStaticMeshComponent>(Name);
+    Markers->SetupAttachment(RootComponent);
+    Markers->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    Markers->SetCastShadow(false);
+    if (Mesh)
+    {
+        Markers->SetStaticMesh(Mesh);
+    }
+    return Markers;
 }
 
 /** 
@@ -128,6 +148,20 @@ void AGridManager::BeginPlay()
         UE_LOG(LogTemp, Warning, TEXT("Directional Light creata con successo senza ombre!"));
     }
 
+    // Colori dei marker dell'anteprima (azzurro il percorso, rosso i bersagli)
+    const TPair<UInstancedStaticMeshComponent*, FLinearColor> MarkerColors[] = {
+        { PathMarkers, FLinearColor(0.0f, 0.8f, 1.0f) },
+        { AttackMarkers, FLinearColor::Red },
+    };
+    for (const TPair<UInstancedStaticMeshComponent*, FLinearColor>& Marker : MarkerColors)
+    {
+        if (Marker.Key && Marker.Key->GetMaterial(0))
+        {
+            UMaterialInstanceDynamic* Material = Marker.Key->CreateDynamicMaterialInstance(0);
+            Material->SetVectorParameterValue(TEXT("Color"), Marker.Value);
+        }
+    }
+
     // Log di conferma posizione iniziale del GridManager
     UE_LOG(LogTemp, Warning, TEXT("GridManagerCPP - Posizione griglia: %s"), *GetActorLocation().ToString());
 }
@@ -169,28 +203,35 @@ void AGridManager::GenerateGrid()
 
             Tile->SetAsObstacle(true);                // La inizializziamo temporaneamente come ostacolo (verrà aggiornata dopo)
             Tile->SetTileIdentifier(CellIdentifier);  // Assegna un nome identificativo
-            Grid.Add(Tile);                           // Aggiungi la tile alla lista della griglia
+            Tile->SetGridIndex(Grid.Add(Tile));       // Aggiungi la tile alla griglia e salva il suo indice
         }
     }
 
+    ResetOccupancy(); // Nessuna unità sulla nuova griglia
+
     // Log di conferma
     UE_LOG(LogTemp, Warning, TEXT(" Griglia generata con %d celle."), Grid.Num());
 }
 
 /**
  * Seleziona casualmente un sottoinsieme di tile da lasciare libere (non ostacoli).
- * Il numero totale di tile libere è determinato dalla percentuale ObstaclePercentage.
+ * Il numero totale di tile libere è determinato dalla percentuale ObstaclePercentage,
+ * sorteggiata a ogni partita (fra 30% e 95%).
  * Utilizza la DFS per garantire che tutte le celle libere siano collegate tra loro.
+ * Tutte le estrazioni usano lo stream ricevuto: stesso seed, stessa mappa.
  */
-void AGridManager::GenerateObstacles()
+void AGridManager::GenerateObstacles(FRandomStream& Stream)
 {
+    // Percentuale casuale di ostacoli per ogni nuova partita (fra 30% e 95%)
+    ObstaclePercentage = FMath::Clamp(Stream.FRandRange(0.3f, 0.95f), 0.3f, 0.95f); // Clamp per sicurezza
+
     TSet<ATile*> Visited; // Tiene traccia delle tile già visitate dalla DFS
     int32 TotalObstacles = FMath::RoundToInt(Grid.Num() * ObstaclePercentage); // Quante tile saranno ostacoli
 
     // Inizia la DFS dalla prima tile (Grid[0]), solo se la griglia è stata generata
     if (Grid.Num() > 0)
     {
-        DFS(Grid[0], Visited, TotalObstacles);
+        DFS(Grid[0], Visited, TotalObstacles, Stream);
     }
 }
 
@@ -202,8 +243,9 @@ void AGridManager::GenerateObstacles()
  * @param CurrentTile: La tile corrente su cui stiamo lavorando
  * @param Visited: Set delle tile già visitate
  * @param MaxObstacles: Numero massimo di ostacoli che devono rimanere nella griglia
+ * @param Stream: Stream casuale della mappa (ordine dei vicini)
  */
-void AGridManager::DFS(ATile* CurrentTile, TSet<ATile*>& Visited, int32 MaxObstacles)
+void AGridManager::DFS(ATile* CurrentTile, TSet<ATile*>& Visited, int32 MaxObstacles, FRandomStream& Stream)
 {
     // Condizione di terminazione: tile nulla, già visitata, o troppe celle libere
     if (!CurrentTile || Visited.Contains(CurrentTile) || Grid.Num() - Visited.Num() <= MaxObstacles)
@@ -220,14 +262,14 @@ void AGridManager::DFS(ATile* CurrentTile, TSet<ATile*>& Visited, int32 MaxObsta
     // Mischia l'ordine dei vicini per rendere la DFS casuale
     for (int32 i = Neighbors.Num() - 1; i > 0; --i)
     {
-        int32 j = FMath::RandRange(0, i);
+        int32 j = Stream.RandRange(0, i);
         Neighbors.Swap(i, j); // Scambia i con un indice casuale j
     }
 
     // Chiama ricorsivamente DFS su ogni vicino
     for (ATile* Neighbor : Neighbors)
     {
-        DFS(Neighbor, Visited, MaxObstacles);
+        DFS(Neighbor, Visited, MaxObstacles, Stream);
     }
 }
 
@@ -290,6 +332,8 @@ void AGridManager::HighlightTileUnderUnit(AUnitBase* Unit, const FLinearColor& C
  * Calcola e restituisce tutte le tile raggiungibili dall’unità selezionata
  * usando una BFS, tenendo conto del range di movimento.
  * Evita celle ostacolate o già occupate.
+ * Il predecessore di ogni tile raggiunta resta in MovementField: il percorso verso una tile
+ * si ricostruisce poi senza ripetere la ricerca (GetCachedPathToTile).
  *
  * @param SelectedUnit: l’unità che vuole muoversi
  * @return Array di tile valide per il movimento
@@ -297,6 +341,7 @@ void AGridManager::HighlightTileUnderUnit(AUnitBase* Unit, const FLinearColor& C
 TArray<ATile*> AGridManager::GetValidMovementTiles(AUnitBase* SelectedUnit)
 {
     TArray<ATile*> ValidTiles; // Risultato finale
+    MovementField.Unit = nullptr;
 
     // Validazione iniziale: controlla che l’unità sia valida
     if (!SelectedUnit)
@@ -317,6 +362,12 @@ TArray<ATile*> AGridManager::GetValidMovementTiles(AUnitBase* SelectedUnit)
         return ValidTiles;
     }
 
+    const int32 StartIndex = GetTileIndex(StartTile);
+
+    MovementField.Unit = SelectedUnit;
+    MovementField.StartTile = StartIndex;
+    MovementField.Predecessors.Init(INDEX_NONE, Grid.Num());
+
     // Breadth-First Search (BFS) per esplorare le tile vicine
     TQueue<ATile*> Queue;             // Coda per BFS
     TMap<ATile*, int32> VisitedTiles; // Tiene traccia delle distanze
@@ -337,6 +388,8 @@ TArray<ATile*> AGridManager::GetValidMovementTiles(AUnitBase* SelectedUnit)
             continue;
         }
 
+        const int32 CurrentIndex = GetTileIndex(CurrentTile);
+
         // Trova le tile vicine alla tile attuale
         TArray<ATile*> Neighbors = GetNeighbors(CurrentTile);
 
@@ -354,6 +407,7 @@ TArray<ATile*> AGridManager::GetValidMovementTiles(AUnitBase* SelectedUnit)
                 Queue.Enqueue(Neighbor);
                 VisitedTiles.Add(Neighbor, CurrentDistance + 1);
                 ValidTiles.Add(Neighbor); // Aggiungiamo alle celle valide
+                MovementField.Predecessors[GetTileIndex(Neighbor)] = CurrentIndex;
             }
         }
     }
@@ -361,6 +415,73 @@ TArray<ATile*> AGridManager::GetValidMovementTiles(AUnitBase* SelectedUnit)
     return ValidTiles;
 }
 
+/**
+ * Ricostruisce il percorso verso TileIndex risalendo i predecessori della BFS di movimento.
+ * È lo stesso percorso di GetPathToTile: entrambe le BFS visitano i vicini nello stesso ordine.
+ */
+bool AGridManager::GetCachedPathToTile(const AUnitBase* Unit, int32 TileIndex, TArray<ATile*>& OutPath) const
+{
+    OutPath.Reset();
+    if (!Unit || MovementField.Unit != Unit || !MovementField.IsReachable(TileIndex)) return false;
+
+    for (int32 Index = TileIndex; Index != MovementField.StartTile; Index = MovementField.Predecessors[Index])
+    {
+        OutPath.Add(Grid[Index]);
+    }
+    Algo::Reverse(OutPath);
+    return true;
+}
+
+/**
+ * Mostra l'anteprima di movimento verso la tile sotto il cursore:
+ * - un marker su ogni tile del percorso (ricostruito dai predecessori, nessuna ricerca);
+ * - un marker su ogni nemico che l'unità potrebbe attaccare dalla tile di arrivo
+ *   (stessa distanza di GetValidAttackTiles, calcolata solo sulle unità nemiche del registro).
+ * I marker sono istanze di due componenti: aggiornarli non crea né modifica attori.
+ */
+void AGridManager::ShowMovePreview(const AUnitBase* Unit, int32 TileIndex)
+{
+    HideMovePreview();
+
+    TArray<ATile*> Path;
+    if (!GetCachedPathToTile(Unit, TileIndex, Path)) return;
+
+    TArray<FTransform> Transforms;
+    Transforms.Reserve(Path.Num());
+    for (const ATile* Tile : Path)
+    {
+        Transforms.Emplace(FRotator::ZeroRotator, Tile->GetActorLocation() + FVector(0.f, 0.f, 10.f), FVector(0.2f));
+    }
+    PathMarkers->AddInstances(Transforms, false, true);
+
+    if (!Unit->CanAct() || !GameMode) return;
+
+    Transforms.Reset();
+    const FVector Destination = Path.Last()->GetActorLocation();
+    const float AttackDistance = Unit->GetAttackRange() * GetTilePitch();
+    const FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+
+    for (int32 Team = 0; Team < Registry.GetNumTeams(); ++Team)
+    {
+        if (Team == Unit->GetTeamID()) continue;
+
+        for (const AUnitBase* Enemy : Registry.GetUnits(Team))
+        {
+            if (FVector::Dist2D(Enemy->GetActorLocation(), Destination) <= AttackDistance)
+            {
+                Transforms.Emplace(FRotator::ZeroRotator, Enemy->GetActorLocation() + FVector(0.f, 0.f, 120.f), FVector(0.3f));
+            }
+        }
+    }
+    AttackMarkers->AddInstances(Transforms, false, true);
+}
+
+void AGridManager::HideMovePreview()
+{
+    PathMarkers->ClearInstances();
+    AttackMarkers->ClearInstances();
+}
+
 /**
  * Evidenzia le celle su cui l'unità può muoversi (quelle restituite da GetValidMovementTiles)
  * usando un colore blu per la visualizzazione.
@@ -378,6 +499,7 @@ void AGridManager::HighlightMovementTiles(AUnitBase* SelectedUnit)
 
     // Ottieni la lista delle tile valide per il movimento
     TArray<ATile*> ValidTiles = GetValidMovementTiles(SelectedUnit);
+    bMovementGridVisible = true;
 
     // Evidenzia ciascuna tile con colore blu
     for (ATile* Tile : ValidTiles)
@@ -407,6 +529,11 @@ void AGridManager::ClearHighlights()
     }
 
     HighlightedTiles.Empty(); // Svuota la lista
+    bThreatOverlayVisible = false;
+
+    // Senza griglia di movimento non c'è anteprima del percorso
+    bMovementGridVisible = false;
+    HideMovePreview();
 
     // Rimuove l’evidenziazione dalla tile sotto l’unità selezionata
     if (TileUnderSelectedUnit)
@@ -416,6 +543,35 @@ void AGridManager::ClearHighlights()
     }
 }
 
+/**
+ * Mostra sopra la griglia la minaccia che tutte le squadre nemiche di Team esercitano.
+ * Il colore va dal giallo (minaccia bassa) al rosso (minaccia massima del layer);
+ * le tile non minacciate e gli ostacoli restano invariati.
+ * Le tile colorate finiscono in HighlightedTiles, quindi ClearHighlights rimuove anche l'overlay.
+ */
+void AGridManager::ShowThreatOverlay(const FInfluenceMap& Influence, int32 Team)
+{
+    ClearHighlights();
+
+    const float MaxThreat = Influence.GetMaxEnemyThreat(Team);
+    if (MaxThreat <= 0.f) return;
+
+    for (int32 Index = 0; Index < Grid.Num(); ++Index)
+    {
+        ATile* Tile = Grid[Index];
+        if (!IsValid(Tile) || Tile->IsObstacle()) continue;
+
+        const float Threat = Influence.GetEnemyThreat(Team, Index);
+        if (Threat <= KINDA_SMALL_NUMBER) continue;
+
+        const float Alpha = FMath::Clamp(Threat / MaxThreat, 0.f, 1.f);
+        Tile->SetHighlight(true, FMath::Lerp(FLinearColor::Yellow, FLinearColor::Red, Alpha));
+        HighlightedTiles.Add(Tile);
+    }
+
+    bThreatOverlayVisible = true;
+}
+
 /**
  * Trova la tile più vicina alla posizione specificata (di solito quella sotto un’unità).
  * Usa una tolleranza di 50 unità per evitare problemi di precisione con il posizionamento.
@@ -425,19 +581,61 @@ void AGridManager::ClearHighlights()
  */
 ATile* AGridManager::FindTileAtLocation(FVector Location)
 {
-    UE_LOG(LogTemp, Warning, TEXT("Cerco Tile alla posizione: X=%.1f, Y=%.1f"), Location.X, Location.Y);
-
-    for (ATile* Tile : Grid)
+    const int32 Index = GetTileIndexAtLocation(Location);
+    if (Index == INDEX_NONE)
     {
-        if (FVector::Dist2D(Tile->GetActorLocation(), Location) < 50.0f)
-        {
-            UE_LOG(LogTemp, Warning, TEXT("Trovata Tile: %s"), *Tile->GetName());
-            return Tile;
-        }
+        UE_LOG(LogTemp, Error, TEXT("ERRORE: Nessuna Tile trovata alla posizione X=%.1f, Y=%.1f"), Location.X, Location.Y);
+        return nullptr;
     }
+    return Grid[Index];
+}
+
+/**
+ * Le tile sono disposte a passo costante a partire dall'origine (vedi GenerateGrid):
+ * riga e colonna si ottengono arrotondando le coordinate, poi si verifica che la posizione
+ * cada entro 50 unità dal centro della tile (stessa tolleranza della vecchia ricerca lineare).
+ */
+int32 AGridManager::GetTileIndexAtLocation(const FVector& Location) const
+{
+    const float Pitch = GetTilePitch();
+    const int32 Column = FMath::RoundToInt32(Location.X / Pitch);
+    const int32 Row = FMath::RoundToInt32(Location.Y / Pitch);
+    if (Column < 0 || Column >= DimGridX || Row < 0 || Row >= DimGridY) return INDEX_NONE;
 
-    UE_LOG(LogTemp, Error, TEXT("ERRORE: Nessuna Tile trovata alla posizione X=%.1f, Y=%.1f"), Location.X, Location.Y);
-    return nullptr;
+    const int32 Index = Row * DimGridX + Column;
+    if (!Grid.IsValidIndex(Index)) return INDEX_NONE;
+
+    const FVector2D Center(Column * Pitch, Row * Pitch);
+    if (FVector2D::Distance(Center, FVector2D(Location.X, Location.Y)) >= 50.0f) return INDEX_NONE;
+
+    return Index;
+}
+
+/**
+ * Intersezione analitica tra il raggio e il piano delle tile (Z costante), poi conversione in riga/colonna.
+ * Sostituisce il trace fisico contro la collisione di ogni tile.
+ */
+int32 AGridManager::GetTileIndexUnderRay(const FVector& Origin, const FVector& Direction) const
+{
+    if (Grid.Num() == 0 || FMath::IsNearlyZero(Direction.Z)) return INDEX_NONE;
+
+    const double PlaneZ = Grid[0]->GetActorLocation().Z;
+    const double Distance = (PlaneZ - Origin.Z) / Direction.Z;
+    if (Distance < 0.0) return INDEX_NONE; // Piano alle spalle della camera
+
+    // Il cursore seleziona tutta la superficie della tile (quadrato CellSize x CellSize), angoli compresi:
+    // la tolleranza radiale di GetTileIndexAtLocation serve solo a localizzare le unità
+    const FVector Hit = Origin + Direction * Distance;
+    const float Pitch = GetTilePitch();
+    const int32 Column = FMath::RoundToInt32(Hit.X / Pitch);
+    const int32 Row = FMath::RoundToInt32(Hit.Y / Pitch);
+    if (Column < 0 || Column >= DimGridX || Row < 0 || Row >= DimGridY) return INDEX_NONE;
+
+    const float HalfCell = CellSize * 0.5f;
+    if (FMath::Abs(Hit.X - Column * Pitch) > HalfCell || FMath::Abs(Hit.Y - Row * Pitch) > HalfCell) return INDEX_NONE;
+
+    const int32 Index = Row * DimGridX + Column;
+    return Grid.IsValidIndex(Index) ? Index : INDEX_NONE;
 }
 
 /**
@@ -469,19 +667,11 @@ TArray<ATile*> AGridManager::GetValidAttackTiles(AUnitBase* Attacker)
             // I Brawler non possono colpire attraverso ostacoli
             if (!bIsRanged && Tile->IsObstacle()) continue;
 
-            // Cerchiamo un'unità nemica su quella tile
-            for (TActorIterator<AUnitBase> It(GetWorld()); It; ++It)
+            // Cerchiamo un'unità nemica su quella tile (indice di occupazione: le unità nel pool non compaiono)
+            AUnitBase* Target = GetUnitOnTile(Tile);
+            if (Target && Target != Attacker && Target->GetTeamID() != Attacker->GetTeamID())
             {
-                AUnitBase* Target = *It;
-                if (Target && Target != Attacker && Target->IsPlayerControlled() != Attacker->IsPlayerControlled())
-                {
-                    FVector TargetLocation = Target->GetActorLocation();
-                    if (FVector::Dist2D(TargetLocation, Tile->GetActorLocation()) < 50.f)
-                    {
-                        ValidTiles.Add(Tile);
-                        break;
-                    }
-                }
+                ValidTiles.Add(Tile);
             }
         }
     }
@@ -583,6 +773,9 @@ void AGridManager::FinalizeUnitMovement(AUnitBase* Unit, ATile* DestinationTile)
 {
     if (!Unit || !DestinationTile) return;
 
+    // Le posizioni cambiano: la BFS di movimento in cache non è più valida
+    MovementField.Unit = nullptr;
+
     // Libera la vecchia tile
     ATile* OldTile = FindTileAtLocation(Unit->GetActorLocation());
     if (OldTile)
@@ -595,6 +788,7 @@ void AGridManager::FinalizeUnitMovement(AUnitBase* Unit, ATile* DestinationTile)
 
     // Segna la nuova tile come occupata
     DestinationTile->SetHasPawn(true);
+    SetUnitTile(Unit, GetTileIndex(DestinationTile));
 }
 
 /**
@@ -619,24 +813,45 @@ void AGridManager::HighlightAttackGrid(AUnitBase* AttackingUnit)
 }
 
 /**
- * Cerca e restituisce l’unità presente su una determinata tile.
- * Confronta la posizione delle unità con quella della tile.
+ * Restituisce l’unità presente su una determinata tile, letta dall'indice di occupazione.
  *
  * @param Tile: tile su cui cercare
  * @return puntatore all’unità trovata (se presente), altrimenti nullptr
  */
 AUnitBase* AGridManager::GetUnitOnTile(ATile* Tile) const
 {
-    if (!Tile) return nullptr;
+    const int32 Index = GetTileIndex(Tile);
+    return TileOccupants.IsValidIndex(Index) ? TileOccupants[Index] : nullptr;
+}
+
+/**
+ * Sposta l'unità nell'indice di occupazione: la tile precedente (se ancora sua) viene liberata.
+ */
+void AGridManager::SetUnitTile(AUnitBase* Unit, int32 TileIndex)
+{
+    if (!Unit) return;
 
-    for (TActorIterator<AUnitBase> It(GetWorld()); It; ++It)
+    if (const int32* OldIndex = UnitTiles.Find(Unit))
     {
-        AUnitBase* Unit = *It;
-        if (Unit && FVector::Dist2D(Unit->GetActorLocation(), Tile->GetActorLocation()) < 50.f)
+        if (TileOccupants.IsValidIndex(*OldIndex) && TileOccupants[*OldIndex] == Unit)
         {
-            return Unit;
+            TileOccupants[*OldIndex] = nullptr;
         }
+        UnitTiles.Remove(Unit);
+    }
+
+    if (!Grid.IsValidIndex(TileIndex)) return;
+
+    if (TileOccupants.Num() != Grid.Num())
+    {
+        TileOccupants.Init(nullptr, Grid.Num());
     }
+    TileOccupants[TileIndex] = Unit;
+    UnitTiles.Add(Unit, TileIndex);
+}
 
-    return nullptr;
-}
\ No newline at end of file
+void AGridManager::ResetOccupancy()
+{
+    TileOccupants.Init(nullptr, Grid.Num());
+    UnitTiles.Reset();
+}
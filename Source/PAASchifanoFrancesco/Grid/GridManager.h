@@ -11,6 +11,25 @@
 // Forward declaration per evitare include inutili
 class UTurnManager;
 class AUnitBase;
+class FInfluenceMap;
+class UInstancedStaticMeshComponent;
+
+/**
+ * Descrizione:
+ * Risultato della BFS di movimento di un'unità (GetValidMovementTiles), in indici di griglia.
+ * Il predecessore di ogni tile raggiungibile permette di ricostruire il percorso fino a quella tile
+ * risalendo la catena, senza una nuova ricerca: è quello che usa l'anteprima del percorso sotto il cursore.
+ */
+struct FMovementField
+{
+	const AUnitBase* Unit = nullptr;
+	int32 StartTile = INDEX_NONE;
+
+	/** Tile precedente lungo il percorso più breve (INDEX_NONE se non raggiungibile o partenza) */
+	TArray<int32> Predecessors;
+
+	bool IsReachable(int32 Tile) const { return Predecessors.IsValidIndex(Tile) && Predecessors[Tile] != INDEX_NONE; }
+};
 
 /**
  * Descrizione:
@@ -36,24 +55,66 @@ public:
 	// Genera la griglia rettangolare con dimensioni e tile specificate
 	void GenerateGrid();
 
-	// Genera ostacoli casuali mantenendo accessibilità
-	void GenerateObstacles();
+	// Genera ostacoli casuali mantenendo accessibilità (usa lo stream Map della partita)
+	void GenerateObstacles(FRandomStream& Stream);
 
 	// Restituisce l'intera griglia
 	const TArray<ATile*>& GetGridTiles() const { return Grid; }
 
+	// Dimensioni della griglia (colonne e righe)
+	int32 GetGridDimX() const { return DimGridX; }
+	int32 GetGridDimY() const { return DimGridY; }
+
+	// Distanza tra i centri di due tile adiacenti (cella + spaziatura)
+	float GetTilePitch() const { return CellSize + Spacing; }
+
+	// Indice della tile nella griglia (Riga * DimGridX + Colonna), INDEX_NONE se non appartiene alla griglia.
+	// L'indice è salvato sulla tile alla creazione: costo costante
+	int32 GetTileIndex(const ATile* Tile) const
+	{
+		const int32 Index = Tile ? Tile->GetGridIndex() : INDEX_NONE;
+		return Grid.IsValidIndex(Index) && Grid[Index] == Tile ? Index : INDEX_NONE;
+	}
+
+	// Restituisce la tile con l'indice dato, nullptr se fuori dalla griglia
+	ATile* GetTileByIndex(int32 Index) const { return Grid.IsValidIndex(Index) ? Grid[Index] : nullptr; }
+
 	// Calcola le tile raggiungibili per una data unità
 	TArray<ATile*> GetValidMovementTiles(AUnitBase* SelectedUnit);
 
 	// Evidenzia le tile raggiungibili per una unità (in blu)
 	void HighlightMovementTiles(AUnitBase* SelectedUnit);
 
-	// Rimuove ogni evidenziazione (attacco o movimento)
+	// true se la griglia di movimento dell'unità è visibile (anteprima del percorso disponibile)
+	bool IsMovementGridVisibleFor(const AUnitBase* Unit) const { return bMovementGridVisible && MovementField.Unit == Unit; }
+
+	// Percorso verso la tile ricostruito dai predecessori dell'ultima BFS di movimento dell'unità
+	// (costo pari alla lunghezza del percorso); false se la BFS è di un'altra unità o la tile non è raggiungibile
+	bool GetCachedPathToTile(const AUnitBase* Unit, int32 TileIndex, TArray<ATile*>& OutPath) const;
+
+	// Anteprima sotto il cursore: marker istanziati sul percorso verso la tile e sui nemici attaccabili dall'arrivo
+	// (INDEX_NONE o tile non raggiungibile nascondono l'anteprima)
+	void ShowMovePreview(const AUnitBase* Unit, int32 TileIndex);
+	void HideMovePreview();
+
+	// Rimuove ogni evidenziazione (attacco, movimento o minaccia)
 	void ClearHighlights();
 
+	// Colora le tile minacciate dalle squadre nemiche di Team (da giallo a rosso in base al danno atteso)
+	void ShowThreatOverlay(const FInfluenceMap& Influence, int32 Team);
+
+	// Indica se l'overlay di minaccia è attualmente visibile
+	bool IsThreatOverlayVisible() const { return bThreatOverlayVisible; }
+
 	// Restituisce la tile alla posizione fornita (X,Y)
 	ATile* FindTileAtLocation(FVector Location);
 
+	// Indice della tile il cui centro dista meno di 50 dalla posizione (X,Y) (localizzazione delle unità); INDEX_NONE altrimenti
+	int32 GetTileIndexAtLocation(const FVector& Location) const;
+
+	// Tile in cui il raggio (es. quello del cursore) interseca il piano della griglia, su tutta la cella; INDEX_NONE se nessuna
+	int32 GetTileIndexUnderRay(const FVector& Origin, const FVector& Direction) const;
+
 	// Restituisce le tile d'attacco valide per un'unità
 	TArray<ATile*> GetValidAttackTiles(AUnitBase* Attacker);
 
@@ -70,9 +131,39 @@ public:
 	// Evidenzia tutte le tile dove un'unità può attaccare
 	void HighlightAttackGrid(AUnitBase* AttackingUnit);
 
-	// Restituisce eventuale unità presente su una tile
+	// Restituisce eventuale unità presente su una tile (indice di occupazione, nessuna ricerca)
 	AUnitBase* GetUnitOnTile(ATile* Tile) const;
 
+	// Aggiorna l'indice di occupazione: l'unità si trova ora sulla tile (INDEX_NONE = rimossa dalla griglia)
+	void SetUnitTile(AUnitBase* Unit, int32 TileIndex);
+
+	// Tile dell'unità secondo l'indice di occupazione, INDEX_NONE se non è sulla griglia (nessuna ricerca)
+	int32 GetUnitTileIndex(const AUnitBase* Unit) const
+	{
+		const int32* TileIndex = UnitTiles.Find(Unit);
+		return TileIndex ? *TileIndex : INDEX_NONE;
+	}
+
+	// Distanza euclidea al quadrato fra due tile, in celle (come FSimBoard::DistanceSquared)
+	int32 GetTileDistanceSquared(int32 TileA, int32 TileB) const
+	{
+		const int32 DX = TileA % DimGridX - TileB % DimGridX;
+		const int32 DY = TileA / DimGridX - TileB / DimGridX;
+		return DX * DX + DY * DY;
+	}
+
+	// true se le due unità sono su tile adiacenti (non in diagonale): regola del contrattacco,
+	// la stessa della simulazione (DistanceSquared <= 1), usata da anteprima e risoluzione dell'attacco
+	bool AreUnitsAdjacent(const AUnitBase* UnitA, const AUnitBase* UnitB) const
+	{
+		const int32 TileA = GetUnitTileIndex(UnitA);
+		const int32 TileB = GetUnitTileIndex(UnitB);
+		return TileA != INDEX_NONE && TileB != INDEX_NONE && GetTileDistanceSquared(TileA, TileB) <= 1;
+	}
+
+	// Svuota l'indice di occupazione (nuova partita o caricamento)
+	void ResetOccupancy();
+
 	// Calcola un percorso tra due tile (BFS)
 	UFUNCTION()
 	TArray<ATile*> GetPathToTile(AUnitBase* Unit, ATile* Destination);
@@ -115,7 +206,7 @@ private:
 	TArray<ATile*> Grid;
 
 	// Algoritmo DFS per garantire accessibilità tra le tile
-	void DFS(ATile* CurrentTile, TSet<ATile*>& Visited, int32 MaxObstacles);
+	void DFS(ATile* CurrentTile, TSet<ATile*>& Visited, int32 MaxObstacles, FRandomStream& Stream);
 
 	// Restituisce le tile adiacenti ad una data tile
 	TArray<ATile*> GetNeighbors(ATile* Tile);
@@ -131,6 +222,32 @@ private:
 	// Indica se la griglia d'attacco è attualmente visibile
 	bool bAttackGridVisible = false;
 
+	// Indica se l'overlay di minaccia è attualmente visibile
+	bool bThreatOverlayVisible = false;
+
+	// Indica se la griglia di movimento (e quindi l'anteprima del percorso) è visibile
+	bool bMovementGridVisible = false;
+
+	// Ultima BFS di movimento (GetValidMovementTiles)
+	FMovementField MovementField;
+
+	// Marker dell'anteprima: una sola draw call per il percorso e una per i bersagli, nessun attore per tile
+	UPROPERTY(VisibleAnywhere, Category = "Grid")
+	UInstancedStaticMeshComponent* PathMarkers;
+
+	UPROPERTY(VisibleAnywhere, Category = "Grid")
+	UInstancedStaticMeshComponent* AttackMarkers;
+
+	// Crea un componente di marker istanziati senza collisioni
+	UInstancedStaticMeshComponent* CreateMarkerComponent(const FName& Name, UStaticMesh* Mesh);
+
+	// Indice di occupazione: unità ferma su ogni tile e tile di ogni unità.
+	// Aggiornato dove un'unità si ferma su una tile (fine movimento, undo/redo, piazzamento, caricamento) o muore
+	UPROPERTY()
+	TArray<AUnitBase*> TileOccupants;
+
+	TMap<const AUnitBase*, int32> UnitTiles;
+
 	// Lista delle tile nella griglia d’attacco
 	UPROPERTY()
 	TArray<ATile*> AttackGridTiles;
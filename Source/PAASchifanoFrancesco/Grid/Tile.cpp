@@ -49,27 +49,23 @@ ATile::ATile()
 
 /**
  * Metodo chiamato all’avvio della partita.
- * Imposta la collisione della tile e assegna il materiale corretto.
+ * Disattiva la collisione della tile e assegna il materiale corretto.
  */
 void ATile::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Impostazioni di collisione per click con il mouse
-	TileMesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	TileMesh->SetCollisionResponseToAllChannels(ECR_Ignore);
-	TileMesh->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+	// Nessuna collisione: il controller individua la tile sotto il cursore in modo analitico
+	// (AGridManager::GetTileIndexUnderRay), quindi le tile non entrano nella scena fisica
+	TileMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	TileMesh->SetGenerateOverlapEvents(false);
 
-	// Abilita l’input per essere cliccabile
-	EnableInput(GetWorld()->GetFirstPlayerController());
-
 	// Applica lo stato iniziale di ostacolo (se impostato)
 	SetAsObstacle(bIsObstacle);
 }
 
 /**
- * Imposta la tile come ostacolo o no e aggiorna il materiale e il tipo di collisione.
+ * Imposta la tile come ostacolo o no e aggiorna il materiale.
  */
 void ATile::SetAsObstacle(bool NewbIsObstacle)
 {
@@ -77,8 +73,9 @@ void ATile::SetAsObstacle(bool NewbIsObstacle)
 
 	if (bIsObstacle)
 	{
-		// Se è un ostacolo, scegle se usare albero o montagna
-		const bool bUseTree = FMath::RandBool();
+		// Se è un ostacolo, scegle se usare albero o montagna.
+		// Scelta solo estetica: dipende dalla posizione della tile e non consuma gli stream della partita
+		const bool bUseTree = (GetTypeHash(GetActorLocation()) & 1) != 0;
 
 		if (bUseTree && TreeMaterial)
 		{
@@ -93,9 +90,6 @@ void ATile::SetAsObstacle(bool NewbIsObstacle)
 	{
 		TileMesh->SetMaterial(0, NormalMaterial);
 	}
-
-	// Imposta il tipo di oggetto collisione per ostacoli
-	TileMesh->SetCollisionObjectType(bIsObstacle ? ECC_GameTraceChannel1 : ECC_WorldStatic);
 }
 
 /**
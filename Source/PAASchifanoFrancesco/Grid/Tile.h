@@ -52,6 +52,10 @@ public:
 	UFUNCTION(Category = "Tile")
 	FString GetTileIdentifier() const { return TileIdentifier; }
 
+	/** Indice nella griglia (Riga * DimGridX + Colonna), assegnato dal GridManager alla creazione */
+	int32 GetGridIndex() const { return GridIndex; }
+	void SetGridIndex(int32 Index) { GridIndex = Index; }
+
 protected:
 	/** Chiamato quando il gioco inizia o quando l’attore viene spawnato */
 	virtual void BeginPlay() override;
@@ -84,4 +88,7 @@ private:
 
 	/** Identificatore della tile (es. A1, B3...) */
 	FString TileIdentifier;
+
+	/** Indice nella griglia, INDEX_NONE finché la tile non viene aggiunta alla griglia */
+	int32 GridIndex = INDEX_NONE;
 };
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include "PAASchifanoFrancesco/Core/PlacementManager.h"
 #include "PAASchifanoFrancesco/Units/UnitMovementManager.h"
 #include "PAASchifanoFrancesco/Core/TurnManager.h"
+#include "PAASchifanoFrancesco/Core/GameServices.h"
+#include "PAASchifanoFrancesco/Simulation/CombatAnalytics.h"
 #include "Engine/DamageEvents.h"
 
 /**
@@ -36,6 +38,9 @@ void AMyPlayerController::BeginPlay()
     // Ottiene il riferimento al GameMode principale del gioco
     GameMode = Cast<AMyGameMode>(UGameplayStatics::GetGameMode(this));
 
+    // Si registra come controller del giocatore (movimenti, turni e unità lo ottengono da qui)
+    UGameServices::Get(this)->RegisterPlayerController(this);
+
     // Abilita gli eventi di click e di passaggio del mouse sugli oggetti
     bEnableClickEvents = true;
     bEnableMouseOverEvents = true;
@@ -76,6 +81,188 @@ void AMyPlayerController::SetupInputComponent()
 
     // Collega il click destro al metodo che gestisce le azioni secondarie (come attacco)
     InputComponent->BindAction("RightClick", IE_Pressed, this, &AMyPlayerController::OnRightClick);
+
+    // Il tasto T mostra/nasconde la mappa di minaccia dell'AI
+    InputComponent->BindKey(EKeys::T, IE_Pressed, this, &AMyPlayerController::OnToggleThreatOverlay);
+
+    // Z annulla l'ultimo movimento del turno, Y lo ripristina
+    InputComponent->BindKey(EKeys::Z, IE_Pressed, this, &AMyPlayerController::OnUndo);
+    InputComponent->BindKey(EKeys::Y, IE_Pressed, this, &AMyPlayerController::OnRedo);
+}
+
+/**
+ * Aggiorna l'anteprima di movimento una volta per frame, dopo l'elaborazione dell'input.
+ */
+void AMyPlayerController::PlayerTick(float DeltaTime)
+{
+    Super::PlayerTick(DeltaTime);
+
+    ProcessCommandQueue();
+    UpdateMovePreview();
+}
+
+/**
+ * Anteprima di movimento sotto il cursore.
+ * Attiva solo durante il turno del player, con la griglia di movimento dell'unità selezionata visibile.
+ * Viene ridisegnata solo quando il cursore passa su un'altra tile: il percorso si ricostruisce
+ * dai predecessori della BFS già calcolata per la griglia (costo pari alla lunghezza del percorso).
+ */
+void AMyPlayerController::UpdateMovePreview()
+{
+    if (!GameMode || !GameMode->TurnManager || !GridManager) return;
+
+    int32 TileIndex = INDEX_NONE;
+    const bool bActive = !bIsGridLocked && SelectedUnit
+        && GameMode->GetCurrentGamePhase() == EGamePhase::EBattle
+        && GameMode->TurnManager->GetCurrentPlayer() == EPlayer::Player1
+        && GridManager->IsMovementGridVisibleFor(SelectedUnit);
+
+    if (bActive)
+    {
+        if (ATile* Tile = GetTileUnderCursor())
+        {
+            TileIndex = GridManager->GetTileIndex(Tile);
+        }
+    }
+
+    if (TileIndex == PreviewTileIndex) return;
+    PreviewTileIndex = TileIndex;
+
+    if (TileIndex == INDEX_NONE)
+    {
+        GridManager->HideMovePreview();
+    }
+    else
+    {
+        GridManager->ShowMovePreview(SelectedUnit, TileIndex);
+    }
+}
+
+/**
+ * Tile sotto il cursore, senza trace fisici: il cursore viene deproiettato in un raggio
+ * e il GridManager lo interseca con il piano della griglia, ricavando riga e colonna dalle coordinate.
+ */
+ATile* AMyPlayerController::GetTileUnderCursor() const
+{
+    if (!GridManager) return nullptr;
+
+    FVector Origin, Direction;
+    if (!DeprojectMousePositionToWorld(Origin, Direction)) return nullptr;
+
+    return GridManager->GetTileByIndex(GridManager->GetTileIndexUnderRay(Origin, Direction));
+}
+
+/**
+ * Anteprima dell'attacco sull'unità sotto il cursore.
+ * Mostrata solo durante il turno del player, con un'unità selezionata che può ancora attaccare
+ * e un nemico all'interno della sua area d'attacco. L'esito viene letto dalle tabelle
+ * precalcolate di FCombatAnalytics (nessun campionamento).
+ */
+void AMyPlayerController::OnUnitHovered(AUnitBase* Unit)
+{
+    if (!GameMode || !GameMode->TurnManager || !GridManager || !Unit) return;
+    if (GameMode->GetCurrentGamePhase() != EGamePhase::EBattle || GameMode->TurnManager->GetCurrentPlayer() != EPlayer::Player1) return;
+    if (!SelectedUnit || !SelectedUnit->CanAct() || Unit->IsPlayerControlled()) return;
+
+    UStatusGameWidget* StatusGame = GameMode->GetStatusGameWidget();
+    if (!StatusGame) return;
+
+    // Il nemico deve essere attaccabile dalla posizione attuale
+    ATile* TargetTile = GridManager->FindTileAtLocation(Unit->GetActorLocation());
+    if (!GridManager->GetValidAttackTiles(SelectedUnit).Contains(TargetTile)) return;
+
+    // Stessa regola di contrattacco di AUnitBase::AttackUnit
+    const bool bAdjacent = GridManager->AreUnitsAdjacent(SelectedUnit, Unit);
+    const int32 DefenderArchetype = static_cast<int32>(Unit->GetArchetype());
+    const bool bCanCounter = FCombatAnalytics::CanCounter(static_cast<int32>(SelectedUnit->GetArchetype()), DefenderArchetype, bAdjacent);
+
+    FCombatOutcome Outcome;
+    FCombatAnalytics::ComputeOutcome(SelectedUnit->CurrentHealth, SelectedUnit->MinDamage, SelectedUnit->MaxDamage, Unit->CurrentHealth,
+        bCanCounter ? &FCombatAnalytics::GetCounterTable(DefenderArchetype) : nullptr, Outcome);
+    StatusGame->ShowCombatPreview(Outcome);
+}
+
+void AMyPlayerController::OnUnitUnhovered(AUnitBase* Unit)
+{
+    if (GameMode && GameMode->GetStatusGameWidget())
+    {
+        GameMode->GetStatusGameWidget()->HideCombatPreview();
+    }
+}
+
+/**
+ * Mostra o nasconde l'overlay con la minaccia delle squadre AI.
+ * La mappa viene riallineata alla posizione attuale delle unità prima di essere disegnata.
+ */
+void AMyPlayerController::OnToggleThreatOverlay()
+{
+    if (!GameMode || GameMode->GetCurrentGamePhase() != EGamePhase::EBattle) return;
+
+    // Recupera GridManager se non già ottenuto
+    if (!GridManager) GridManager = GameMode->GetGridManager();
+    if (!GridManager) return;
+
+    if (GridManager->IsThreatOverlayVisible())
+    {
+        GridManager->ClearHighlights();
+        return;
+    }
+
+    FInfluenceMap& Influence = GameMode->GetInfluenceMap();
+    Influence.Update(FSimBoard::FromWorld(GameMode));
+    GridManager->ShowThreatOverlay(Influence, FUnitRegistry::PlayerTeam);
+}
+
+/**
+ * Annulla l'ultimo movimento del player (durante un'animazione viene accodato ed eseguito al suo termine).
+ */
+void AMyPlayerController::OnUndo()
+{
+    if (!GameMode || !GameMode->TurnManager) return;
+
+    FPlayerInputCommand Command;
+    Command.Type = EPlayerCommandType::Undo;
+    SubmitCommand(Command);
+}
+
+/**
+ * Ripristina l'ultimo movimento annullato.
+ */
+void AMyPlayerController::OnRedo()
+{
+    if (!GameMode || !GameMode->TurnManager) return;
+
+    FPlayerInputCommand Command;
+    Command.Type = EPlayerCommandType::Redo;
+    SubmitCommand(Command);
+}
+
+/**
+ * Comando da console: salva la partita in corso nello slot indicato.
+ */
+void AMyPlayerController::SaveMatch(const FString& SlotName)
+{
+    if (!GameMode) return;
+
+    const FString Slot = SlotName.IsEmpty() ? TEXT("Quick") : SlotName;
+    if (!GameMode->SaveMatch(Slot))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("SaveMatch: nessuna battaglia in corso da salvare"));
+    }
+}
+
+/**
+ * Comando da console: carica lo slot indicato.
+ * Non è consentito mentre un'unità si sta muovendo; la selezione corrente viene annullata
+ * perché le unità vengono ricreate.
+ */
+void AMyPlayerController::LoadMatch(const FString& SlotName)
+{
+    if (!GameMode || bIsGridLocked) return;
+
+    SelectedUnit = nullptr;
+    ClearCommandQueue();
+    GameMode->LoadMatch(SlotName.IsEmpty() ? TEXT("Quick") : SlotName);
 }
 
 
@@ -91,37 +278,15 @@ void AMyPlayerController::OnLeftClick()
     InputMode.SetConsumeCaptureMouseDown(false); // Permette che il click passi anche attraverso i widget
     SetInputMode(InputMode); // Applica la modalità di input
 
-    // Se la griglia è bloccata (es. in animazione), oppure GameMode o TurnManager non sono validi, esce
-    if (bIsGridLocked || !GameMode || !GameMode->TurnManager) return;
+    // Se GameMode o TurnManager non sono validi, esce
+    // (con la griglia bloccata, es. in animazione, il click viene accodato da SubmitCommand)
+    if (!GameMode || !GameMode->TurnManager) return;
 
     // Se GridManager non è ancora stato inizializzato, lo ottiene dal GameMode
     if (!GridManager) GridManager = GameMode->GetGridManager();
     if (!GridManager) return; // Se non esiste nemmeno dopo, esce
 
-    // Esegue un trace sotto il cursore del mouse per capire su cosa è stato cliccato
-    FHitResult Hit;
-    if (!GetHitResultUnderCursor(ECC_Visibility, false, Hit) || !Hit.GetActor()) return;
-
-    // Ottiene l'attore colpito dal click
-    AActor* HitActor = Hit.GetActor();
-
-    // Controlla in quale fase del gioco ci troviamo
-    switch (GameMode->GetCurrentGamePhase())
-    {
-    case EGamePhase::EPlacement:
-        // Se siamo nella fase di piazzamento, gestisce il click come selezione di una tile per il piazzamento
-            HandlePlacementClick(HitActor);
-        break;
-
-    case EGamePhase::EBattle:
-        // Se siamo nella fase di battaglia, delega la gestione del click alla logica di battaglia
-            HandleBattleClick(HitActor, true); // true = click sinistro
-        break;
-
-    default:
-        // Se siamo in una fase non gestita, non fa nulla
-            break;
-    }
+    SubmitClick(EPlayerCommandType::LeftClick);
 }
 
 /**
@@ -322,8 +487,13 @@ void AMyPlayerController::TryMoveToTile(ATile* ClickedTile)
     // Se la tile cliccata non è valida o l'unità ha già mosso in questo turno, esce
     if (!ValidTiles.Contains(ClickedTile) || SelectedUnit->bHasMovedThisTurn) return;
 
-    // Calcola il percorso dalla posizione attuale alla tile cliccata
-    const TArray<ATile*> Path = GridManager->GetPathToTile(SelectedUnit, ClickedTile);
+    // Percorso dalla posizione attuale alla tile cliccata: lo stesso dell'anteprima,
+    // ricostruito dalla BFS appena eseguita da GetValidMovementTiles
+    TArray<ATile*> Path;
+    if (!GridManager->GetCachedPathToTile(SelectedUnit, GridManager->GetTileIndex(ClickedTile), Path))
+    {
+        Path = GridManager->GetPathToTile(SelectedUnit, ClickedTile);
+    }
 
     // Controlla che il percorso non sia più lungo del range di movimento dell'unità
     if (Path.Num() > SelectedUnit->GetMovementRange())
@@ -336,27 +506,36 @@ void AMyPlayerController::TryMoveToTile(ATile* ClickedTile)
     // Rimuove eventuali evidenziazioni precedenti
     GridManager->ClearHighlights();
 
+    // Prepara l'annullamento: stato precedente, partenza e percorso in indici di griglia
+    FPlayerUndoEntry UndoEntry;
+    UndoEntry.Unit = SelectedUnit;
+    UndoEntry.PreviousAction = SelectedUnit->GetCurrentAction();
+    UndoEntry.CommandIndex = GameMode->GetCommandLog().Num();
+    for (const ATile* Tile : Path)
+    {
+        UndoEntry.Path.Add(GridManager->GetTileIndex(Tile));
+    }
+
     // Imposta l'azione corrente come "Moved"
     SelectedUnit->SetCurrentAction(EUnitAction::Moved);
 
     // Blocca temporaneamente l’input del giocatore
     SetMovementLocked(true);
 
-    // Ordina il movimento dell’unità lungo il percorso calcolato
-    MovementManager->MoveUnit(SelectedUnit, Path, 300.f); // Velocità: 300.f
-
-    // Recupera la tile di partenza
+    // Registra la mossa nel log dei comandi (la tile di partenza va letta prima del movimento)
     ATile* From = GridManager->FindTileAtLocation(SelectedUnit->GetActorLocation());
-    FString FromName = From ? From->GetTileIdentifier() : TEXT("???");
+    GameMode->RecordMove(SelectedUnit, From, Path);
 
-    // Identificativo della tile di destinazione
-    FString ToName = ClickedTile->GetTileIdentifier();
+    UndoEntry.FromTile = GridManager->GetTileIndex(From);
+    GameMode->TurnManager->RecordPlayerUndo(MoveTemp(UndoEntry));
 
-    // Determina il tipo dell'unità per la scrittura nello storico
-    FString UnitType = SelectedUnit->IsRangedAttack() ? TEXT("Sniper") : TEXT("Brawler");
+    // Stato previsto per i comandi che arrivano durante il movimento
+    PendingMoveUnit = SelectedUnit;
+    PendingMoveFrom = GridManager->GetTileIndex(From);
+    PendingMoveTo = GridManager->GetTileIndex(Path.Last());
 
-    // Aggiunge la mossa alla history del turno
-    GameMode->AddMoveToHistory(FString::Printf(TEXT("Player: %s moves from %s to %s"), *UnitType, *FromName, *ToName));
+    // Ordina il movimento dell’unità lungo il percorso calcolato
+    MovementManager->MoveUnit(SelectedUnit, Path, 300.f); // Velocità: 300.f
 }
 
 /*
@@ -375,39 +554,227 @@ void AMyPlayerController::OnRightClick()
     // Se il gioco è finito, forza la chiamata alla gestione del GameOver
     if (GameMode->GetCurrentGamePhase() == EGamePhase::EGameOver)
     {
-        GameMode->HandleGameOver(GameMode->PlayerUnits.Num() == 0 ? TEXT("AI") : TEXT("Player"));
+        GameMode->HandleGameOver(GameMode->GetWinnerName());
     }
 
-    // Se il movimento è bloccato o mancano riferimenti, interrompe
-    if (bIsGridLocked || !GameMode || !GameMode->TurnManager) return;
+    // Se mancano riferimenti, interrompe (con il movimento bloccato il click viene accodato)
+    if (!GameMode || !GameMode->TurnManager) return;
 
     // Recupera GridManager se non già ottenuto
     if (!GridManager) GridManager = GameMode->GetGridManager();
     if (!GridManager) return;
 
-    // Ottiene l’attore cliccato sotto il cursore del mouse
-    FHitResult Hit;
-    if (!GetHitResultUnderCursor(ECC_Visibility, false, Hit) || !Hit.GetActor()) return;
-    AActor* HitActor = Hit.GetActor();
+    SubmitClick(EPlayerCommandType::RightClick);
+}
+
+/**
+ * Il click viene risolto subito sulla tile sotto il cursore; l'unità bersaglio è quella prevista
+ * a fine del movimento in corso (se l'input è libero coincide con quella presente ora).
+ */
+void AMyPlayerController::SubmitClick(EPlayerCommandType Type)
+{
+    ATile* Tile = GetTileUnderCursor();
+    if (!Tile) return;
+
+    FPlayerInputCommand Command;
+    Command.Type = Type;
+    Command.TileIndex = GridManager->GetTileIndex(Tile);
+    Command.Unit = GetProjectedUnitOnTile(Command.TileIndex);
+    Command.bTargetsUnit = Command.Unit.IsValid();
+    SubmitCommand(Command);
+}
+
+/**
+ * Con l'input libero e la coda vuota il comando viene eseguito subito; altrimenti viene accodato
+ * (la coda mantiene l'ordine dei comandi). Si accoda solo durante il turno del player:
+ * i click durante il turno dell'IA vengono ignorati come prima.
+ */
+void AMyPlayerController::SubmitCommand(const FPlayerInputCommand& Command)
+{
+    if (!bIsGridLocked && CommandQueue.Num() == 0)
+    {
+        ExecuteCommand(Command);
+        return;
+    }
+
+    if (GameMode->TurnManager->GetCurrentPlayer() != EPlayer::Player1) return;
+
+    if (CommandQueue.Num() >= MaxQueuedCommands)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Coda dei comandi piena: comando ignorato"));
+        return;
+    }
+
+    // Primo comando accodato: la selezione prevista parte da quella attuale
+    // (a fine movimento l'unità mossa viene deselezionata)
+    if (CommandQueue.Num() == 0)
+    {
+        ProjectedOccupants.Reset();
+        ProjectedSelection = PendingMoveUnit.IsValid() ? nullptr : SelectedUnit;
+    }
+
+    CommandQueue.Add(Command);
+    ProjectQueuedCommand(Command);
+}
+
+/**
+ * Replica sullo stato previsto le regole del click in battaglia: un click sinistro su un'unità del player
+ * la seleziona, un click sinistro su una tile libera muove l'unità selezionata se non ha ancora agito
+ * e la tile è entro il suo range (distanza in tile, senza ostacoli). Se al momento dell'esecuzione
+ * il movimento non avviene, i comandi successivi vengono scartati da ExecuteCommand come prima.
+ * Annulla e ripristina rendono lo stato imprevedibile: la proiezione torna al solo movimento in corso.
+ */
+void AMyPlayerController::ProjectQueuedCommand(const FPlayerInputCommand& Command)
+{
+    if (Command.Type == EPlayerCommandType::Undo || Command.Type == EPlayerCommandType::Redo)
+    {
+        ProjectedOccupants.Reset();
+        ProjectedSelection = nullptr;
+        return;
+    }
+
+    if (Command.Type != EPlayerCommandType::LeftClick || GameMode->GetCurrentGamePhase() != EGamePhase::EBattle) return;
+
+    if (Command.bTargetsUnit)
+    {
+        AUnitBase* ClickedUnit = Command.Unit.Get();
+        if (ClickedUnit && ClickedUnit->IsPlayerControlled())
+        {
+            ProjectedSelection = ClickedUnit;
+        }
+        return;
+    }
+
+    AUnitBase* Unit = ProjectedSelection.Get();
+    ATile* ToTile = GridManager->GetTileByIndex(Command.TileIndex);
+    if (!Unit || !ToTile || ToTile->IsObstacle()) return;
+    if (Unit->GetCurrentAction() != EUnitAction::Idle || Unit->bHasMovedThisTurn) return;
+
+    // Un'unità che ha già un movimento accodato non si muove di nuovo: la partenza è la tile attuale
+    for (const TPair<int32, TWeakObjectPtr<AUnitBase>>& Entry : ProjectedOccupants)
+    {
+        if (Entry.Value.Get() == Unit) return;
+    }
+    const int32 FromIndex = GridManager->GetTileIndex(GridManager->FindTileAtLocation(Unit->GetActorLocation()));
+    if (FromIndex == INDEX_NONE) return;
+
+    const int32 DimX = GridManager->GetGridDimX();
+    const int32 Distance = FMath::Abs(FromIndex % DimX - Command.TileIndex % DimX) + FMath::Abs(FromIndex / DimX - Command.TileIndex / DimX);
+    if (Distance == 0 || Distance > Unit->GetMovementRange()) return;
+
+    ProjectedOccupants.Add(FromIndex, nullptr);
+    ProjectedOccupants.Add(Command.TileIndex, Unit);
+    ProjectedSelection = nullptr;
+}
+
+void AMyPlayerController::ClearCommandQueue()
+{
+    CommandQueue.Reset();
+    ProjectedOccupants.Reset();
+    ProjectedSelection = nullptr;
+}
+
+/**
+ * Il comando accodato è stato validato sullo stato previsto: se al momento dell'esecuzione
+ * sulla tile non c'è l'unità attesa (o ce n'è una inattesa) il comando viene scartato.
+ */
+void AMyPlayerController::ExecuteCommand(const FPlayerInputCommand& Command)
+{
+    if (Command.Type == EPlayerCommandType::Undo || Command.Type == EPlayerCommandType::Redo)
+    {
+        const bool bDone = Command.Type == EPlayerCommandType::Undo
+            ? GameMode->TurnManager->UndoPlayerMove()
+            : GameMode->TurnManager->RedoPlayerMove();
+
+        // La selezione viene azzerata perché le aree evidenziate non sono più valide
+        if (bDone)
+        {
+            SelectedUnit = nullptr;
+            if (GameMode->GetStatusGameWidget())
+            {
+                GameMode->GetStatusGameWidget()->HideCombatPreview();
+            }
+        }
+        return;
+    }
+
+    ATile* Tile = GridManager ? GridManager->GetTileByIndex(Command.TileIndex) : nullptr;
+    if (!Tile) return;
+
+    AUnitBase* Occupant = GridManager->GetUnitOnTile(Tile);
+    if (Command.bTargetsUnit ? Occupant != Command.Unit.Get() : Occupant != nullptr)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Comando scartato: lo stato della tile %s non è quello previsto"), *Tile->GetName());
+        return;
+    }
 
-    // Switch in base alla fase del gioco
+    AActor* HitActor = Occupant ? static_cast<AActor*>(Occupant) : Tile;
     switch (GameMode->GetCurrentGamePhase())
     {
     case EGamePhase::EPlacement:
-        HandlePlacementClick(HitActor); // Click destro durante il piazzamento
+        HandlePlacementClick(HitActor); // Il piazzamento accetta qualsiasi click su una tile
         break;
     case EGamePhase::EBattle:
-        HandleBattleClick(HitActor, false); // Click destro durante la battaglia
+        HandleBattleClick(HitActor, Command.Type == EPlayerCommandType::LeftClick);
         break;
     default:
         break;
     }
 }
 
+/**
+ * Esegue i comandi in coda, in ordine, finché uno di essi non blocca di nuovo l'input
+ * (es. un nuovo movimento): i successivi attendono il suo termine.
+ * Se il turno è passato all'IA i comandi rimasti non sono più validi e vengono scartati.
+ */
+void AMyPlayerController::ProcessCommandQueue()
+{
+    if (CommandQueue.Num() == 0 || bIsGridLocked || !GameMode || !GameMode->TurnManager) return;
+
+    if (GameMode->TurnManager->GetCurrentPlayer() != EPlayer::Player1)
+    {
+        ClearCommandQueue();
+        return;
+    }
+
+    while (CommandQueue.Num() > 0 && !bIsGridLocked)
+    {
+        const FPlayerInputCommand Command = CommandQueue[0];
+        CommandQueue.RemoveAt(0, 1, EAllowShrinking::No);
+        ExecuteCommand(Command);
+    }
+
+    // Coda esaurita: lo stato previsto coincide di nuovo con quello reale
+    if (CommandQueue.Num() == 0)
+    {
+        ProjectedOccupants.Reset();
+        ProjectedSelection = nullptr;
+    }
+}
+
+/**
+ * Stato previsto: prima i movimenti accodati, poi l'unità in movimento (già sulla destinazione,
+ * con la partenza libera); le altre tile sono lette dall'indice di occupazione del GridManager.
+ */
+AUnitBase* AMyPlayerController::GetProjectedUnitOnTile(int32 TileIndex) const
+{
+    if (const TWeakObjectPtr<AUnitBase>* Projected = ProjectedOccupants.Find(TileIndex))
+    {
+        return Projected->Get();
+    }
+
+    if (AUnitBase* MovingUnit = PendingMoveUnit.Get())
+    {
+        if (TileIndex == PendingMoveTo) return MovingUnit;
+        if (TileIndex == PendingMoveFrom) return nullptr;
+    }
+    return GridManager->GetUnitOnTile(GridManager->GetTileByIndex(TileIndex));
+}
+
 /*
 * Descrizione:
 * Gestisce l'attacco vero e proprio tra un'unità Attacker e un'unità Defender.
-* Aggiorna la UI, registra l'evento nello storico e gestisce eventuale contrattacco (solo per Sniper).
+* Le regole (danno, contrattacco) sono quelle di FCombatResolver, condivise con l'IA e la simulazione.
 */
 void AMyPlayerController::ExecuteAttack(AUnitBase* Attacker, AUnitBase* Defender)
 {
@@ -428,69 +795,29 @@ void AMyPlayerController::ExecuteAttack(AUnitBase* Attacker, AUnitBase* Defender
         StatusGame = GameMode->GetStatusGameWidget();
     }
 
+    // L'anteprima non serve più: l'attacco sta per essere risolto
+    if (StatusGame)
+    {
+        StatusGame->HideCombatPreview();
+    }
+
     // Blocca temporaneamente l’input del giocatore
     SetMovementLocked(true);
 
-    // Esegue l’attacco tra le due unità
-    Attacker->AttackUnit(Defender);
-    // Aggiorna la barra della vita del difensore
-    if (StatusGame && !Defender->IsDead())
+    // Esegue l’attacco tra le due unità: danno, contrattacco, history e barre della vita
+    // vengono gestiti da AttackUnit con l'esito calcolato da FCombatResolver
+    Attacker->AttackUnit(Defender, GameMode->GetMatchRandom().Combat);
+
+    // Imposta l’azione corrente come "Attacked"; se il contrattacco ha ucciso l'attaccante
+    // l'attore è già tornato nel pool e il suo stato non va più toccato
+    if (!Attacker->IsDead())
     {
-        StatusGame->UpdateUnitHealth(Defender, Defender->GetHealthPercent());
+        Attacker->SetCurrentAction(EUnitAction::Attacked);
     }
-    
-    // Crea il messaggio da mostrare nello storico
-    ATile* DefenderTile = GridManager->FindTileAtLocation(Defender->GetActorLocation());
-    FString TileName = DefenderTile ? DefenderTile->GetTileIdentifier() : TEXT("???");
-    FString UnitType = Attacker->IsRangedAttack() ? TEXT("Sniper") : TEXT("Brawler");
-    int32 Damage = FMath::RandRange(Attacker->MinDamage, Attacker->MaxDamage); // Simula il danno per la UI
-
-    GameMode->AddMoveToHistory(FString::Printf(TEXT("Player: %s attacks %s damage %d"), *UnitType, *TileName, Damage));
-
-    // Imposta l’azione corrente come "Attacked"
-    Attacker->SetCurrentAction(EUnitAction::Attacked);
 
     // Log dell'attacco
     UE_LOG(LogTemp, Warning, TEXT(" %s ha attaccato %s"), *Attacker->GetName(), *Defender->GetName());
 
-    // Controlla se va eseguito il contrattacco (solo se l'attaccante è uno Sniper e il difensore è ancora vivo)
-    if (Attacker->IsRangedAttack() && !Defender->IsDead())
-    {
-        const bool DefenderIsSniper = Defender->IsRangedAttack();
-        const bool DefenderIsBrawlerClose =
-            !Defender->IsRangedAttack() &&
-            FVector::Dist2D(Attacker->GetActorLocation(), Defender->GetActorLocation()) <= 110.f;
-
-        // Se le condizioni sono rispettate, esegue il contrattacco
-        if (DefenderIsSniper || DefenderIsBrawlerClose)
-        {
-            int32 CounterDamage = FMath::RandRange(1, 3); // Danno contrattacco casuale
-            UE_LOG(LogTemp, Warning, TEXT(" Contrattacco! %s infligge %d danni a %s"), *Defender->GetName(), CounterDamage, *Attacker->GetName());
-
-            // Applica il danno all'attaccante
-            FPointDamageEvent DamageEvent;
-            Attacker->TakeDamage(CounterDamage, DamageEvent, nullptr, Defender);
-
-            // Mostra contrattacco nella history
-            ATile* AttackerTile = GridManager->FindTileAtLocation(Attacker->GetActorLocation());
-            TileName = AttackerTile ? AttackerTile->GetTileIdentifier() : TEXT("???");
-            FString DefenderType = Defender->IsRangedAttack() ? TEXT("Sniper") : TEXT("Brawler");
-
-            GameMode->AddMoveToHistory(FString::Printf(TEXT("AI: %s counterattack %s damage %d"), *DefenderType, *TileName, CounterDamage));
-        }
-
-        // Controlla se l'attaccante è morto dopo il contrattacco
-        if (Attacker->IsDead())
-        {
-            Attacker->Die(Attacker);
-        }
-        else if (StatusGame)
-        {
-            // Aggiorna la barra della vita
-            StatusGame->UpdateUnitHealth(Attacker, Attacker->GetHealthPercent());
-        }
-    }
-
     // Rimuove gli highlight e deseleziona l'unità
     GridManager->ClearHighlights();
     SelectedUnit = nullptr;
@@ -512,6 +839,12 @@ void AMyPlayerController::ExecuteAttack(AUnitBase* Attacker, AUnitBase* Defender
 */
 void AMyPlayerController::OnUnitMovementFinished(AUnitBase* Unit)
 {
+    // Il movimento previsto si è concluso: da qui in poi vale l'indice di occupazione
+    if (PendingMoveUnit.Get() == Unit)
+    {
+        PendingMoveUnit.Reset();
+    }
+
     // Deseleziona l'unità dopo il movimento
     SelectedUnit = nullptr;
 
@@ -15,6 +15,34 @@
 
 class AMyGameMode;
 
+/** Tipo di un comando di input del giocatore */
+enum class EPlayerCommandType : uint8
+{
+	LeftClick,
+	RightClick,
+	Undo,
+	Redo
+};
+
+/**
+ * Descrizione:
+ * Comando di input del giocatore, eseguito subito o accodato se arriva mentre l'input è bloccato
+ * (movimento o attacco in corso). Un click viene risolto quando avviene, sullo stato previsto
+ * a fine movimento: tile cliccata e unità che vi si troverà. Quando viene eseguito, l'unità
+ * deve trovarsi davvero su quella tile, altrimenti il comando viene scartato.
+ */
+struct FPlayerInputCommand
+{
+	EPlayerCommandType Type = EPlayerCommandType::LeftClick;
+
+	/** Tile cliccata (INDEX_NONE per i comandi da tastiera) */
+	int32 TileIndex = INDEX_NONE;
+
+	/** true se sulla tile è prevista un'unità: il click è su di lei e non sulla tile */
+	bool bTargetsUnit = false;
+	TWeakObjectPtr<AUnitBase> Unit;
+};
+
 /**
  * Classe: AMyPlayerController
  * 
@@ -51,6 +79,26 @@ public:
 	UFUNCTION()
 	void OnUnitMovementFinished(AUnitBase* Unit);
 
+	/**
+	 * Metodo: OnUnitHovered / OnUnitUnhovered
+	 * 
+	 * Chiamati da AUnitBase quando il cursore entra o esce da un'unità.
+	 * Se l'unità è un nemico attaccabile dall'unità selezionata, mostra l'anteprima esatta dell'attacco.
+	 */
+	void OnUnitHovered(AUnitBase* Unit);
+	void OnUnitUnhovered(AUnitBase* Unit);
+
+	/**
+	 * Comandi da console: SaveMatch <Slot> / LoadMatch <Slot>
+	 * 
+	 * Salvano e caricano la partita in corso (slot di default "Quick").
+	 */
+	UFUNCTION(Exec)
+	void SaveMatch(const FString& SlotName);
+
+	UFUNCTION(Exec)
+	void LoadMatch(const FString& SlotName);
+
 protected:
 
 	/**
@@ -67,6 +115,13 @@ protected:
 	 */
 	virtual void SetupInputComponent() override;
 
+	/**
+	 * Metodo: PlayerTick
+	 * 
+	 * Aggiorna l'anteprima di movimento sotto il cursore (al massimo una volta per frame).
+	 */
+	virtual void PlayerTick(float DeltaTime) override;
+
 private:
 
 	/** Riferimento al GameMode principale */
@@ -90,9 +145,66 @@ private:
 	/** Funzione associata al click destro del mouse */
 	void OnRightClick();
 
+	/** Tile sotto il cursore (anche se il cursore è sopra un'unità), nullptr se fuori dalla griglia */
+	ATile* GetTileUnderCursor() const;
+
+	/** Mostra il percorso e i bersagli dell'unità selezionata verso la tile sotto il cursore */
+	void UpdateMovePreview();
+
+	/** Tile dell'anteprima attualmente mostrata (INDEX_NONE se nessuna) */
+	int32 PreviewTileIndex = INDEX_NONE;
+
+	/** Mostra/nasconde la mappa di minaccia delle unità AI (tasto T) */
+	void OnToggleThreatOverlay();
+
+	/** Annulla / ripristina l'ultimo movimento del turno (tasti Z e Y) */
+	void OnUndo();
+	void OnRedo();
+
 	/** Esegue un attacco confermato tra un attaccante e un difensore */
 	void ExecuteAttack(AUnitBase* Attacker, AUnitBase* Defender);
 
+	/** Crea il comando per il click sulla tile sotto il cursore e lo invia */
+	void SubmitClick(EPlayerCommandType Type);
+
+	/** Esegue il comando se l'input è libero, altrimenti lo accoda (solo nel turno del player) */
+	void SubmitCommand(const FPlayerInputCommand& Command);
+
+	/** Esegue un comando: click (piazzamento o battaglia), annulla o ripristina */
+	void ExecuteCommand(const FPlayerInputCommand& Command);
+
+	/** Esegue i comandi accodati finché l'input resta libero (chiamato a ogni frame) */
+	void ProcessCommandQueue();
+
+	/** Unità che si troverà sulla tile dopo il movimento in corso e quelli accodati (nullptr se sarà libera) */
+	AUnitBase* GetProjectedUnitOnTile(int32 TileIndex) const;
+
+	/** Aggiorna lo stato previsto con un comando appena accodato (selezione e movimenti del player) */
+	void ProjectQueuedCommand(const FPlayerInputCommand& Command);
+
+	/** Svuota la coda dei comandi e lo stato previsto costruito sui comandi accodati */
+	void ClearCommandQueue();
+
+	/** Comandi arrivati durante il blocco dell'input, in ordine di arrivo */
+	TArray<FPlayerInputCommand, TInlineAllocator<8>> CommandQueue;
+
+	/** Numero massimo di comandi in coda: quelli in eccesso vengono ignorati */
+	static constexpr int32 MaxQueuedCommands = 8;
+
+	/** Movimento del player in corso (stato previsto per i comandi accodati) */
+	TWeakObjectPtr<AUnitBase> PendingMoveUnit;
+	int32 PendingMoveFrom = INDEX_NONE;
+	int32 PendingMoveTo = INDEX_NONE;
+
+	/**
+	 * Tile liberate (nullptr) o occupate dai movimenti accodati, aggiornate a ogni comando accodato.
+	 * Hanno la precedenza sul movimento in corso e sull'indice di occupazione; si svuotano con la coda.
+	 */
+	TMap<int32, TWeakObjectPtr<AUnitBase>, TInlineSetAllocator<8>> ProjectedOccupants;
+
+	/** Unità che risulterà selezionata dopo i comandi accodati */
+	TWeakObjectPtr<AUnitBase> ProjectedSelection;
+
 	/** Riferimento all'unità attualmente selezionata dal giocatore */
 	AUnitBase* SelectedUnit;
 
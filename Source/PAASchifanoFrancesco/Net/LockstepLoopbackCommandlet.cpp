@@ -0,0 +1,93 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "LockstepLoopbackCommandlet.h"
+#include "LockstepSession.h"
+#include "PAASchifanoFrancesco/Simulation/SimMatch.h"
+#include "PAASchifanoFrancesco/Simulation/CombatAnalytics.h"
+
+ULockstepLoopbackCommandlet::ULockstepLoopbackCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+/**
+ * Descrizione:
+ * 1. Gioca una partita simulata per seed
+ * 2. Divide il suo log in turni: ogni piazzamento è un turno a sé, in battaglia un turno
+ *    comprende i comandi fino all'EndTurn della fazione
+ * 3. La sessione della fazione di turno invia i comandi, l'altra li riceve e confronta il checksum
+ */
+int32 ULockstepLoopbackCommandlet::Main(const FString& Params)
+{
+	int32 NumMatches = 10;
+	int32 BaseSeed = 0;
+	FParse::Value(*Params, TEXT("Matches="), NumMatches);
+	FParse::Value(*Params, TEXT("Seed="), BaseSeed);
+	NumMatches = FMath::Max(1, NumMatches);
+
+	FCombatAnalytics::WarmupArchetypes();
+
+	int32 Desyncs = 0;
+	int32 TotalTurns = 0;
+	int64 TotalBytes = 0;
+	int32 MaxPacketBytes = 0;
+
+	for (int32 MatchIndex = 0; MatchIndex < NumMatches; ++MatchIndex)
+	{
+		FSimMatchConfig Config;
+		Config.Seed = BaseSeed + MatchIndex;
+		FSimMatch Match(Config);
+		Match.Play();
+
+		const FMatchCommandLog& SourceLog = Match.GetCommandLog();
+
+		TSharedPtr<FLoopbackTransport> PlayerTransport;
+		TSharedPtr<FLoopbackTransport> AITransport;
+		FLoopbackTransport::CreatePair(PlayerTransport, AITransport);
+
+		FLockstepSession PlayerSession(PlayerTransport.ToSharedRef(), Config.DimX, Config.DimY, Match.GetObstacles());
+		FLockstepSession AISession(AITransport.ToSharedRef(), Config.DimX, Config.DimY, Match.GetObstacles());
+
+		FMatchCommand Command;
+		int32 SegmentStart = 0;
+		for (int32 Index = 0; Index < SourceLog.Num(); ++Index)
+		{
+			if (!SourceLog.Decode(Index, Command)) continue;
+			if (Command.Type != EMatchCommand::Place && Command.Type != EMatchCommand::EndTurn) continue;
+
+			const TConstArrayView<uint8> AllBytes = SourceLog.GetCommandBytes(SegmentStart);
+			const int32 SegmentBytes = SourceLog.GetCommandBytes(Index + 1).Num();
+			const TConstArrayView<uint8> Segment = AllBytes.Left(AllBytes.Num() - SegmentBytes);
+
+			FLockstepSession& Sender = Command.bPlayer ? PlayerSession : AISession;
+			FLockstepSession& Receiver = Command.bPlayer ? AISession : PlayerSession;
+			Sender.SubmitLocalCommands(Segment);
+			Receiver.Poll();
+
+			MaxPacketBytes = FMath::Max(MaxPacketBytes, FLockstepSession::PacketHeaderSize + Segment.Num());
+			++TotalTurns;
+			SegmentStart = Index + 1;
+		}
+
+		const bool bFinalMatch = PlayerSession.GetChecksum() == Match.GetBoard().ComputeStateChecksum()
+			&& AISession.GetChecksum() == Match.GetBoard().ComputeStateChecksum();
+		if (PlayerSession.IsDesynced() || AISession.IsDesynced() || !bFinalMatch)
+		{
+			++Desyncs;
+			UE_LOG(LogTemp, Error, TEXT("LockstepLoopback: seed %d desincronizzato (sequenza %d/%d, board finale %s)"),
+				Config.Seed, PlayerSession.GetDesyncSequence(), AISession.GetDesyncSequence(),
+				bFinalMatch ? TEXT("uguale") : TEXT("diversa"));
+		}
+
+		TotalBytes += PlayerSession.GetTransport().GetBytesSent() + AISession.GetTransport().GetBytesSent();
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("LockstepLoopback: %d partite, %d turni, %d desync"), NumMatches, TotalTurns, Desyncs);
+	UE_LOG(LogTemp, Display, TEXT("  Byte per turno: media %.1f, massimo %d"),
+		static_cast<double>(TotalBytes) / FMath::Max(1, TotalTurns), MaxPacketBytes);
+
+	return Desyncs > 0 ? 1 : 0;
+}
@@ -0,0 +1,29 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LockstepLoopbackCommandlet.generated.h"
+
+/**
+ * Classe: ULockstepLoopbackCommandlet
+ * Descrizione:
+ * Verifica del lockstep senza rete: gioca partite simulate (FSimMatch) e le trasmette turno per turno
+ * tra due FLockstepSession collegate da un FLoopbackTransport. Ogni peer invia solo i comandi dei
+ * propri turni; alla fine controlla che nessun checksum sia divergente e che la board ricostruita
+ * coincida con quella della simulazione. Riporta i byte trasmessi per turno.
+ *
+ * Utilizzo:
+ *   UnrealEditor-Cmd PAASchifanoFrancesco.uproject -run=LockstepLoopback [-Matches=<n>] [-Seed=<seed>]
+ */
+UCLASS()
+class PAASCHIFANOFRANCESCO_API ULockstepLoopbackCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	ULockstepLoopbackCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,124 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "LockstepSession.h"
+#include "PAASchifanoFrancesco/Simulation/MatchReplay.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	constexpr uint8 TurnPacket = 1;
+}
+
+FLockstepSession::FLockstepSession(TSharedRef<ILockstepTransport> InTransport, int32 DimX, int32 DimY, const TBitArray<>& Obstacles)
+	: Transport(InTransport)
+{
+	Board.Init(DimX, DimY);
+	for (int32 Index = 0; Index < Board.NumTiles() && Index < Obstacles.Num(); ++Index)
+	{
+		Board.Obstacles[Index] = Obstacles[Index];
+	}
+	CommandLog.Reset(DimX, DimY);
+}
+
+bool FLockstepSession::ApplyEncoded(TConstArrayView<uint8> EncodedCommands)
+{
+	const int32 FirstCommand = CommandLog.Num();
+	if (CommandLog.AppendEncoded(EncodedCommands) == INDEX_NONE) return false;
+
+	// Stesse regole del replay: i comandi contengono già i danni tirati, nessun dado viene rilanciato
+	FMatchCommand Command;
+	for (int32 Index = FirstCommand; Index < CommandLog.Num(); ++Index)
+	{
+		if (CommandLog.Decode(Index, Command))
+		{
+			FMatchReplay::ApplyCommand(Board, Command);
+		}
+	}
+	return true;
+}
+
+bool FLockstepSession::SubmitLocalCommands(TConstArrayView<uint8> EncodedCommands, TOptional<uint32> StateChecksum)
+{
+	if (EncodedCommands.Num() > MaxPacketCommandBytes || !ApplyEncoded(EncodedCommands))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Lockstep: comandi locali non validi (%d byte)"), EncodedCommands.Num());
+		return false;
+	}
+
+	TArray<uint8> Packet;
+	Packet.Reserve(PacketHeaderSize + EncodedCommands.Num());
+	FMemoryWriter Writer(Packet);
+
+	uint8 Type = TurnPacket;
+	uint16 PacketSequence = static_cast<uint16>(Sequence);
+	uint32 Checksum = StateChecksum.Get(GetChecksum());
+	uint16 Length = static_cast<uint16>(EncodedCommands.Num());
+	Writer << Type;
+	Writer << PacketSequence;
+	Writer << Checksum;
+	Writer << Length;
+
+	// Il corpo è una copia dei byte dei comandi: si accoda direttamente dopo l'intestazione
+	Packet.Append(EncodedCommands.GetData(), EncodedCommands.Num());
+
+	Transport->Send(MoveTemp(Packet));
+	++Sequence;
+	return true;
+}
+
+/**
+ * Descrizione:
+ * Per ogni pacchetto: verifica la sequenza, applica i comandi e confronta il checksum
+ * calcolato localmente con quello del mittente. Alla prima differenza la sessione resta
+ * in stato di desync (le partite successive non sarebbero comunque confrontabili).
+ */
+int32 FLockstepSession::Poll()
+{
+	int32 Applied = 0;
+	TArray<uint8> Packet;
+
+	while (Transport->Receive(Packet))
+	{
+		FMemoryReader Reader(Packet);
+		uint8 Type = 0;
+		uint16 PacketSequence = 0;
+		uint32 RemoteChecksum = 0;
+		uint16 Length = 0;
+		Reader << Type;
+		Reader << PacketSequence;
+		Reader << RemoteChecksum;
+		Reader << Length;
+
+		if (Reader.IsError() || Type != TurnPacket || PacketHeaderSize + Length != Packet.Num())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Lockstep: pacchetto non valido (%d byte)"), Packet.Num());
+			continue;
+		}
+
+		if (PacketSequence != static_cast<uint16>(Sequence))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Lockstep: sequenza %d ricevuta, attesa %d"), PacketSequence, Sequence);
+			continue;
+		}
+
+		if (!ApplyEncoded(TConstArrayView<uint8>(Packet.GetData() + PacketHeaderSize, Length)))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Lockstep: comandi remoti non validi nella sequenza %d"), Sequence);
+			continue;
+		}
+
+		const uint32 LocalChecksum = GetChecksum();
+		if (LocalChecksum != RemoteChecksum && !IsDesynced())
+		{
+			DesyncSequence = Sequence;
+			UE_LOG(LogTemp, Error, TEXT("Lockstep: DESYNC alla sequenza %d (locale %08x, remoto %08x)"), Sequence, LocalChecksum, RemoteChecksum);
+			OnDesync.Broadcast(Sequence, LocalChecksum, RemoteChecksum);
+		}
+
+		++Sequence;
+		++Applied;
+	}
+
+	return Applied;
+}
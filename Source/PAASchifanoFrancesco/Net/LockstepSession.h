@@ -0,0 +1,69 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LockstepTransport.h"
+#include "PAASchifanoFrancesco/Simulation/SimBoard.h"
+#include "PAASchifanoFrancesco/Simulation/MatchCommandLog.h"
+
+// Notifica di desincronizzazione: sequenza del pacchetto, checksum locale e remoto
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnLockstepDesync, int32, uint32, uint32);
+
+/**
+ * Classe: FLockstepSession
+ * Descrizione:
+ * Un peer di una partita in lockstep. I peer non replicano attori: si scambiano solo i comandi
+ * del turno (già codificati da FMatchCommandLog, pochi byte ciascuno) e il checksum della board
+ * dopo averli applicati. Ogni peer applica i comandi alla propria FSimBoard e confronta il checksum:
+ * se differisce la partita è desincronizzata e OnDesync viene notificato.
+ *
+ * Pacchetto di un turno: tipo (1 byte), sequenza (2), checksum (4), lunghezza (2), comandi.
+ * La dimensione dipende solo dal numero di comandi, non dalla griglia.
+ */
+class PAASCHIFANOFRANCESCO_API FLockstepSession
+{
+public:
+	static constexpr int32 PacketHeaderSize = 9;
+
+	/** Byte di comandi al massimo in un pacchetto (la lunghezza è a 16 bit) */
+	static constexpr int32 MaxPacketCommandBytes = MAX_uint16;
+
+	FLockstepSession(TSharedRef<ILockstepTransport> InTransport, int32 DimX, int32 DimY, const TBitArray<>& Obstacles);
+
+	/**
+	 * Applica alla board locale i comandi del turno appena giocato e li invia al peer
+	 * insieme al checksum risultante. StateChecksum, se indicato, sostituisce quello della board
+	 * della sessione: è il checksum dello stato reale (la partita con gli attori), così il peer
+	 * confronta i comandi con ciò che è davvero accaduto e non con la loro stessa riproduzione.
+	 * false se i comandi non sono validi o superano MaxPacketCommandBytes (nulla viene inviato).
+	 */
+	bool SubmitLocalCommands(TConstArrayView<uint8> EncodedCommands, TOptional<uint32> StateChecksum = TOptional<uint32>());
+
+	/** Elabora i pacchetti ricevuti. Restituisce il numero di turni remoti applicati */
+	int32 Poll();
+
+	bool IsDesynced() const { return DesyncSequence != INDEX_NONE; }
+	int32 GetDesyncSequence() const { return DesyncSequence; }
+
+	/** Numero di pacchetti (turni) già applicati, locali e remoti */
+	int32 GetSequence() const { return Sequence; }
+
+	uint32 GetChecksum() const { return Board.ComputeStateChecksum(); }
+	const FSimBoard& GetBoard() const { return Board; }
+	const FMatchCommandLog& GetCommandLog() const { return CommandLog; }
+	const ILockstepTransport& GetTransport() const { return *Transport; }
+
+	FOnLockstepDesync OnDesync;
+
+private:
+	/** Accoda i comandi al log e li applica alla board; false se i byte non sono validi */
+	bool ApplyEncoded(TConstArrayView<uint8> EncodedCommands);
+
+	TSharedRef<ILockstepTransport> Transport;
+	FSimBoard Board;
+	FMatchCommandLog CommandLog;
+
+	int32 Sequence = 0;
+	int32 DesyncSequence = INDEX_NONE;
+};
@@ -0,0 +1,28 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "LockstepTransport.h"
+
+void FLoopbackTransport::CreatePair(TSharedPtr<FLoopbackTransport>& OutA, TSharedPtr<FLoopbackTransport>& OutB)
+{
+	TSharedPtr<FPacketQueue, ESPMode::ThreadSafe> AToB = MakeShared<FPacketQueue, ESPMode::ThreadSafe>();
+	TSharedPtr<FPacketQueue, ESPMode::ThreadSafe> BToA = MakeShared<FPacketQueue, ESPMode::ThreadSafe>();
+
+	OutA = MakeShared<FLoopbackTransport>();
+	OutB = MakeShared<FLoopbackTransport>();
+
+	OutA->Outbox = AToB;
+	OutA->Inbox = BToA;
+	OutB->Outbox = BToA;
+	OutB->Inbox = AToB;
+}
+
+void FLoopbackTransport::Send(TArray<uint8>&& Packet)
+{
+	BytesSent += Packet.Num();
+	Outbox->Enqueue(MoveTemp(Packet));
+}
+
+bool FLoopbackTransport::Receive(TArray<uint8>& OutPacket)
+{
+	return Inbox->Dequeue(OutPacket);
+}
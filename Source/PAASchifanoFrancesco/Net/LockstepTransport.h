@@ -0,0 +1,53 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+
+/**
+ * Classe: ILockstepTransport
+ * Descrizione:
+ * Canale affidabile e ordinato tra due peer del lockstep. Trasporta pacchetti opachi:
+ * il contenuto (comandi e checksum) è definito da FLockstepSession.
+ */
+class PAASCHIFANOFRANCESCO_API ILockstepTransport
+{
+public:
+	virtual ~ILockstepTransport() = default;
+
+	/** Invia un pacchetto al peer remoto */
+	virtual void Send(TArray<uint8>&& Packet) = 0;
+
+	/** Estrae il prossimo pacchetto ricevuto; false se non ce ne sono */
+	virtual bool Receive(TArray<uint8>& OutPacket) = 0;
+
+	/** Byte inviati dall'apertura del canale (per misurare la banda) */
+	int64 GetBytesSent() const { return BytesSent; }
+
+protected:
+	int64 BytesSent = 0;
+};
+
+/**
+ * Classe: FLoopbackTransport
+ * Descrizione:
+ * Trasporto in memoria tra due peer nello stesso processo (test, commandlet, partite locali).
+ * Ogni direzione è una coda lock-free a produttore singolo, quindi i due peer possono
+ * anche girare su thread diversi.
+ */
+class PAASCHIFANOFRANCESCO_API FLoopbackTransport : public ILockstepTransport
+{
+public:
+	/** Crea due estremità collegate: ciò che invia A viene ricevuto da B e viceversa */
+	static void CreatePair(TSharedPtr<FLoopbackTransport>& OutA, TSharedPtr<FLoopbackTransport>& OutB);
+
+	virtual void Send(TArray<uint8>&& Packet) override;
+	virtual bool Receive(TArray<uint8>& OutPacket) override;
+
+private:
+	using FPacketQueue = TQueue<TArray<uint8>, EQueueMode::Spsc>;
+
+	TSharedPtr<FPacketQueue, ESPMode::ThreadSafe> Inbox;
+	TSharedPtr<FPacketQueue, ESPMode::ThreadSafe> Outbox;
+};
@@ -0,0 +1,130 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "AIMatchCommandlet.h"
+#include "SimMatch.h"
+#include "CombatAnalytics.h"
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+
+UAIMatchCommandlet::UAIMatchCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+/**
+ * Converte il nome di un livello di IA (es. "Easy", "Hard") nel valore dell'enum.
+ * Se il nome non è valido restituisce il valore di default.
+ */
+static EAILevel ParseAILevel(const FString& Params, const TCHAR* Key, EAILevel Default)
+{
+	FString LevelName;
+	if (!FParse::Value(*Params, Key, LevelName)) return Default;
+
+	const int64 Value = StaticEnum<EAILevel>()->GetValueByNameString(LevelName);
+	if (Value == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AIMatch: livello IA '%s' non valido, uso il default"), *LevelName);
+		return Default;
+	}
+	return static_cast<EAILevel>(Value);
+}
+
+/**
+ * Descrizione:
+ * 1. Legge i parametri da riga di comando
+ * 2. Gioca le partite in parallelo (una FSimMatch per indice, seed = Seed + indice)
+ * 3. Aggrega i risultati e li serializza in JSON
+ */
+int32 UAIMatchCommandlet::Main(const FString& Params)
+{
+	int32 NumMatches = 100;
+	int32 BaseSeed = 0;
+	FString OutputPath;
+
+	FSimMatchConfig BaseConfig;
+	FParse::Value(*Params, TEXT("Matches="), NumMatches);
+	FParse::Value(*Params, TEXT("Seed="), BaseSeed);
+	FParse::Value(*Params, TEXT("MaxTurns="), BaseConfig.MaxTurns);
+	FParse::Value(*Params, TEXT("UnitsPerSide="), BaseConfig.UnitsPerSide);
+	FParse::Value(*Params, TEXT("Teams="), BaseConfig.NumTeams);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	BaseConfig.Player1Level = ParseAILevel(Params, TEXT("P1="), EAILevel::Hard);
+	BaseConfig.AILevel = ParseAILevel(Params, TEXT("P2="), EAILevel::Hard);
+
+	NumMatches = FMath::Max(1, NumMatches);
+
+	TArray<FSimMatchResult> Results;
+	Results.SetNum(NumMatches);
+
+	// Tabelle di danno pronte prima di entrare nei thread
+	FCombatAnalytics::WarmupArchetypes();
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	ParallelFor(NumMatches, [&Results, &BaseConfig, BaseSeed](int32 MatchIndex)
+	{
+		FSimMatchConfig Config = BaseConfig;
+		Config.Seed = BaseSeed + MatchIndex;
+		Results[MatchIndex] = FSimMatch(Config).Play();
+	});
+
+	const double ElapsedSeconds = FMath::Max(FPlatformTime::Seconds() - StartTime, UE_DOUBLE_SMALL_NUMBER);
+
+	// Aggregazione dei risultati
+	int32 Player1Wins = 0;
+	int32 AIWins = 0;
+	int32 Draws = 0;
+	int64 TotalTurns = 0;
+	int64 TotalDecisions = 0;
+	for (const FSimMatchResult& Result : Results)
+	{
+		if (!Result.bHasWinner)
+		{
+			++Draws;
+		}
+		else if (Result.Winner == EPlayer::Player1)
+		{
+			++Player1Wins;
+		}
+		else
+		{
+			++AIWins;
+		}
+		TotalTurns += Result.Turns;
+		TotalDecisions += Result.Decisions;
+	}
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("matches"), NumMatches);
+	Report->SetNumberField(TEXT("seed"), BaseSeed);
+	Report->SetStringField(TEXT("player1Level"), StaticEnum<EAILevel>()->GetNameStringByValue(static_cast<int64>(BaseConfig.Player1Level)));
+	Report->SetStringField(TEXT("aiLevel"), StaticEnum<EAILevel>()->GetNameStringByValue(static_cast<int64>(BaseConfig.AILevel)));
+	Report->SetNumberField(TEXT("player1WinRate"), static_cast<double>(Player1Wins) / NumMatches);
+	Report->SetNumberField(TEXT("aiWinRate"), static_cast<double>(AIWins) / NumMatches);
+	Report->SetNumberField(TEXT("drawRate"), static_cast<double>(Draws) / NumMatches);
+	Report->SetNumberField(TEXT("averageTurns"), static_cast<double>(TotalTurns) / NumMatches);
+	Report->SetNumberField(TEXT("decisions"), static_cast<double>(TotalDecisions));
+	Report->SetNumberField(TEXT("decisionsPerSecond"), TotalDecisions / ElapsedSeconds);
+	Report->SetNumberField(TEXT("matchesPerSecond"), NumMatches / ElapsedSeconds);
+	Report->SetNumberField(TEXT("elapsedSeconds"), ElapsedSeconds);
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Report, Writer);
+
+	UE_LOG(LogTemp, Display, TEXT("%s"), *Json);
+
+	if (!OutputPath.IsEmpty() && !FFileHelper::SaveStringToFile(Json, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("AIMatch: impossibile scrivere il report in %s"), *OutputPath);
+		return 1;
+	}
+
+	return 0;
+}
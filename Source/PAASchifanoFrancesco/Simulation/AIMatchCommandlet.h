@@ -0,0 +1,30 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AIMatchCommandlet.generated.h"
+
+/**
+ * Classe: UAIMatchCommandlet
+ * Descrizione:
+ * Benchmark headless delle IA: gioca N partite complete (FSimMatch) tra due livelli di IA,
+ * in parallelo su tutti i core, e stampa un report JSON con percentuali di vittoria,
+ * durata media delle partite e decisioni al secondo.
+ *
+ * Utilizzo:
+ *   UnrealEditor-Cmd PAASchifanoFrancesco.uproject -run=AIMatch -Matches=1000 -P1=Easy -P2=Hard
+ *   [-Seed=<seed iniziale>] [-MaxTurns=<limite turni>] [-UnitsPerSide=<n>] [-Teams=<2..4>] [-Output=<file.json>]
+ *   Con più di due squadre P2 controlla tutte le squadre IA; una vittoria di una qualsiasi di esse conta per P2.
+ */
+UCLASS()
+class PAASCHIFANOFRANCESCO_API UAIMatchCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UAIMatchCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,201 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "CombatAnalytics.h"
+#include "PAASchifanoFrancesco/Units/UnitArchetypes.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace
+{
+	/** Cache delle tabelle, indicizzata per (MinDamage, MaxDamage) */
+	struct FDamageTableCache
+	{
+		FRWLock Lock;
+
+		/** TUniquePtr: i riferimenti restituiti restano validi anche quando la mappa cresce */
+		TMap<uint64, TUniquePtr<FDamageTable>> Tables;
+	};
+
+	FDamageTableCache& GetCache()
+	{
+		static FDamageTableCache Cache;
+		return Cache;
+	}
+
+	void BuildDamageTable(int32 MinDamage, int32 MaxDamage, FDamageTable& OutTable)
+	{
+		OutTable.MinDamage = MinDamage;
+		OutTable.MaxDamage = MaxDamage;
+
+		const float Probability = 1.f / (MaxDamage - MinDamage + 1);
+		OutTable.DamagePMF.SetNumZeroed(MaxDamage + 1);
+		for (int32 Damage = MinDamage; Damage <= MaxDamage; ++Damage)
+		{
+			OutTable.DamagePMF[Damage] = Probability;
+		}
+		OutTable.Mean = (MinDamage + MaxDamage) * 0.5f;
+
+		OutTable.KillChance.SetNumZeroed(MaxDamage + 1);
+		OutTable.ExpectedDamage.SetNumZeroed(MaxDamage + 1);
+		for (int32 Health = 0; Health <= MaxDamage; ++Health)
+		{
+			for (int32 Damage = MinDamage; Damage <= MaxDamage; ++Damage)
+			{
+				OutTable.KillChance[Health] += Damage >= Health ? Probability : 0.f;
+				OutTable.ExpectedDamage[Health] += FMath::Min(Damage, Health) * Probability;
+			}
+		}
+	}
+
+	/** Distribuzione concentrata su un solo valore di vita */
+	void MakeDelta(int32 Health, TArray<float>& OutPMF)
+	{
+		OutPMF.SetNumZeroed(Health + 1);
+		OutPMF[Health] = 1.f;
+	}
+}
+
+const FDamageTable& FCombatAnalytics::GetDamageTable(int32 MinDamage, int32 MaxDamage)
+{
+	MinDamage = FMath::Max(0, MinDamage);
+	MaxDamage = FMath::Max(MinDamage, MaxDamage);
+	const uint64 Key = (static_cast<uint64>(MinDamage) << 32) | static_cast<uint32>(MaxDamage);
+
+	FDamageTableCache& Cache = GetCache();
+	{
+		FReadScopeLock ReadLock(Cache.Lock);
+		if (const TUniquePtr<FDamageTable>* Found = Cache.Tables.Find(Key))
+		{
+			return **Found;
+		}
+	}
+
+	FWriteScopeLock WriteLock(Cache.Lock);
+	TUniquePtr<FDamageTable>& Table = Cache.Tables.FindOrAdd(Key);
+	if (!Table)
+	{
+		Table = MakeUnique<FDamageTable>();
+		BuildDamageTable(MinDamage, MaxDamage, *Table);
+	}
+	return *Table;
+}
+
+const FDamageTable& FCombatAnalytics::GetCounterTable(int32 DefenderArchetype)
+{
+	const FUnitArchetype& Defender = FUnitArchetypeTable::Get()[DefenderArchetype];
+	return GetDamageTable(Defender.CounterMinDamage, Defender.CounterMaxDamage);
+}
+
+void FCombatAnalytics::WarmupArchetypes()
+{
+	const FUnitArchetypeTable& Archetypes = FUnitArchetypeTable::Get();
+	for (int32 Index = 0; Index < Archetypes.Num(); ++Index)
+	{
+		GetDamageTable(Archetypes[Index].MinDamage, Archetypes[Index].MaxDamage);
+		GetCounterTable(Index);
+	}
+}
+
+bool FCombatAnalytics::CanCounter(int32 AttackerArchetype, int32 DefenderArchetype, bool bAdjacent)
+{
+	const FUnitArchetypeTable& Archetypes = FUnitArchetypeTable::Get();
+	return Archetypes[AttackerArchetype].bProvokesCounter && (Archetypes[DefenderArchetype].bCountersAtRange || bAdjacent);
+}
+
+/**
+ * Descrizione:
+ * Out[max(0, h - d)] += P(h) * P(d) per ogni coppia (vita, danno) con probabilità non nulla.
+ */
+void FCombatAnalytics::ApplyDamage(const TArray<float>& HealthPMF, const TArray<float>& DamagePMF, TArray<float>& OutHealthPMF)
+{
+	OutHealthPMF.Reset();
+	OutHealthPMF.SetNumZeroed(HealthPMF.Num());
+
+	for (int32 Health = 0; Health < HealthPMF.Num(); ++Health)
+	{
+		const float HealthProbability = HealthPMF[Health];
+		if (HealthProbability <= 0.f) continue;
+
+		// Un'unità già a 0 resta a 0
+		if (Health == 0)
+		{
+			OutHealthPMF[0] += HealthProbability;
+			continue;
+		}
+
+		for (int32 Damage = 0; Damage < DamagePMF.Num(); ++Damage)
+		{
+			if (DamagePMF[Damage] <= 0.f) continue;
+			OutHealthPMF[FMath::Max(0, Health - Damage)] += HealthProbability * DamagePMF[Damage];
+		}
+	}
+}
+
+/**
+ * Descrizione:
+ * 1. Vita del difensore: delta sulla vita iniziale convoluta con il danno dell'attaccante.
+ * 2. Vita dell'attaccante: se il difensore sopravvive e la regola lo consente, delta convoluta
+ *    con il danno del contrattacco, pesata con la probabilità di sopravvivenza del difensore.
+ */
+void FCombatAnalytics::ComputeOutcome(int32 AttackerHealth, int32 MinDamage, int32 MaxDamage, int32 DefenderHealth, const FDamageTable* CounterTable, FCombatOutcome& OutOutcome)
+{
+	AttackerHealth = FMath::Max(0, AttackerHealth);
+	DefenderHealth = FMath::Max(0, DefenderHealth);
+
+	const FDamageTable& Attack = GetDamageTable(MinDamage, MaxDamage);
+
+	TArray<float> Delta;
+	MakeDelta(DefenderHealth, Delta);
+	ApplyDamage(Delta, Attack.DamagePMF, OutOutcome.DefenderHealth);
+
+	OutOutcome.KillChance = OutOutcome.DefenderHealth[0];
+	OutOutcome.ExpectedDamage = Attack.GetExpectedDamage(DefenderHealth);
+
+	MakeDelta(AttackerHealth, OutOutcome.AttackerHealth);
+	OutOutcome.CounterChance = 0.f;
+	OutOutcome.ExpectedCounterDamage = 0.f;
+	OutOutcome.AttackerDeathChance = AttackerHealth == 0 ? 1.f : 0.f;
+
+	if (!CounterTable || DefenderHealth == 0) return;
+
+	const FDamageTable& Counter = *CounterTable;
+	const float CounterChance = 1.f - OutOutcome.KillChance;
+
+	TArray<float> Countered;
+	ApplyDamage(OutOutcome.AttackerHealth, Counter.DamagePMF, Countered);
+
+	for (int32 Health = 0; Health < Countered.Num(); ++Health)
+	{
+		OutOutcome.AttackerHealth[Health] = OutOutcome.AttackerHealth[Health] * (1.f - CounterChance) + Countered[Health] * CounterChance;
+	}
+
+	OutOutcome.CounterChance = CounterChance;
+	OutOutcome.ExpectedCounterDamage = CounterChance * Counter.GetExpectedDamage(AttackerHealth);
+	OutOutcome.AttackerDeathChance = OutOutcome.AttackerHealth[0];
+}
+
+void FCombatAnalytics::ComputeOutcome(const FSimBoard& Board, int32 AttackerIndex, int32 FromTile, int32 DefenderIndex, FCombatOutcome& OutOutcome)
+{
+	const FSimUnit& Attacker = Board.Units[AttackerIndex];
+	const FSimUnit& Defender = Board.Units[DefenderIndex];
+	const bool bAdjacent = Board.DistanceSquared(FromTile, Defender.TileIndex) <= 1;
+
+	const bool bCanCounter = CanCounter(Attacker.Archetype, Defender.Archetype, bAdjacent);
+	ComputeOutcome(Attacker.Health, Attacker.MinDamage, Attacker.MaxDamage, Defender.Health,
+		bCanCounter ? &GetCounterTable(Defender.Archetype) : nullptr, OutOutcome);
+}
+
+float FCombatAnalytics::ComputeFocusFireKillChance(int32 DefenderHealth, TConstArrayView<FIntPoint> DamageRanges)
+{
+	DefenderHealth = FMath::Max(0, DefenderHealth);
+
+	TArray<float> Current;
+	TArray<float> Next;
+	MakeDelta(DefenderHealth, Current);
+
+	for (const FIntPoint& Range : DamageRanges)
+	{
+		ApplyDamage(Current, GetDamageTable(Range.X, Range.Y).DamagePMF, Next);
+		Swap(Current, Next);
+	}
+	return Current[0];
+}
@@ -0,0 +1,110 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SimBoard.h"
+
+/**
+ * Descrizione:
+ * Tabella precalcolata per un intervallo di danno uniforme [MinDamage, MaxDamage].
+ * Per ogni valore di vita del bersaglio fino a MaxDamage contiene probabilità di uccisione
+ * e danno atteso (limitato alla vita); oltre MaxDamage l'uccisione è impossibile e il danno
+ * atteso è la media, quindi la tabella resta piccola (MaxDamage + 1 voci).
+ */
+struct FDamageTable
+{
+	int32 MinDamage = 0;
+	int32 MaxDamage = 0;
+
+	/** Danno medio dell'intervallo */
+	float Mean = 0.f;
+
+	/** PMF del danno: DamagePMF[d] = P(danno = d), per d in [0, MaxDamage] */
+	TArray<float> DamagePMF;
+
+	/** Indicizzate per vita del bersaglio, da 0 a MaxDamage */
+	TArray<float> KillChance;
+	TArray<float> ExpectedDamage;
+
+	float GetKillChance(int32 Health) const
+	{
+		return KillChance.IsValidIndex(Health) ? KillChance[Health] : (Health <= 0 ? 1.f : 0.f);
+	}
+
+	float GetExpectedDamage(int32 Health) const
+	{
+		if (Health <= 0) return 0.f;
+		return ExpectedDamage.IsValidIndex(Health) ? ExpectedDamage[Health] : Mean;
+	}
+};
+
+/**
+ * Descrizione:
+ * Esito esatto di un attacco (con eventuale contrattacco), espresso come distribuzioni
+ * di probabilità della vita finale delle due unità.
+ */
+struct FCombatOutcome
+{
+	/** DefenderHealth[h] = P(vita finale del difensore = h), per h in [0, vita iniziale] */
+	TArray<float> DefenderHealth;
+
+	/** AttackerHealth[h] = P(vita finale dell'attaccante = h), per h in [0, vita iniziale] */
+	TArray<float> AttackerHealth;
+
+	float KillChance = 0.f;
+	float ExpectedDamage = 0.f;
+
+	/** Probabilità che il difensore contrattacchi (sopravvive e la regola lo consente) */
+	float CounterChance = 0.f;
+	float ExpectedCounterDamage = 0.f;
+	float AttackerDeathChance = 0.f;
+};
+
+/**
+ * Classe: FCombatAnalytics
+ * Descrizione:
+ * Calcolo esatto degli esiti di combattimento senza campionamento Monte Carlo.
+ * La vita finale è la convoluzione discreta fra la distribuzione della vita e quella del danno
+ * (con saturazione a 0). Le tabelle per intervallo di danno vengono calcolate una volta
+ * e condivise tra thread (IA, pondering, partite headless, anteprima della UI).
+ */
+class PAASCHIFANOFRANCESCO_API FCombatAnalytics
+{
+public:
+	/** Tabella dell'intervallo indicato, calcolata al primo accesso e poi riutilizzata */
+	static const FDamageTable& GetDamageTable(int32 MinDamage, int32 MaxDamage);
+
+	/** Tabella del contrattacco inflitto dall'archetipo indicato (indice in FUnitArchetypeTable) */
+	static const FDamageTable& GetCounterTable(int32 DefenderArchetype);
+
+	/**
+	 * Costruisce la tabella degli archetipi (sul game thread, che può caricare la DataTable)
+	 * e precalcola le tabelle di attacco e contrattacco di ogni archetipo.
+	 */
+	static void WarmupArchetypes();
+
+	/**
+	 * Convoluzione: distribuzione della vita dopo un colpo con la distribuzione di danno indicata.
+	 * OutHealthPMF ha la stessa lunghezza di HealthPMF; la vita negativa si accumula su 0.
+	 */
+	static void ApplyDamage(const TArray<float>& HealthPMF, const TArray<float>& DamagePMF, TArray<float>& OutHealthPMF);
+
+	/**
+	 * true se il difensore sopravvissuto risponde all'attacco: l'archetipo dell'attaccante provoca
+	 * il contrattacco e il difensore è adiacente o contrattacca anche a distanza.
+	 */
+	static bool CanCounter(int32 AttackerArchetype, int32 DefenderArchetype, bool bAdjacent);
+
+	/** Esito completo di un attacco fra due unità con le statistiche indicate (CounterTable nullo = nessun contrattacco) */
+	static void ComputeOutcome(int32 AttackerHealth, int32 MinDamage, int32 MaxDamage, int32 DefenderHealth, const FDamageTable* CounterTable, FCombatOutcome& OutOutcome);
+
+	/** Esito completo di un attacco sulla board, con l'attaccante posizionato su FromTile */
+	static void ComputeOutcome(const FSimBoard& Board, int32 AttackerIndex, int32 FromTile, int32 DefenderIndex, FCombatOutcome& OutOutcome);
+
+	/**
+	 * Probabilità che più attacchi consecutivi (X = danno minimo, Y = danno massimo)
+	 * uccidano un bersaglio con la vita indicata.
+	 */
+	static float ComputeFocusFireKillChance(int32 DefenderHealth, TConstArrayView<FIntPoint> DamageRanges);
+};
@@ -0,0 +1,45 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "CombatResolver.h"
+#include "CombatAnalytics.h"
+#include "PAASchifanoFrancesco/Units/UnitArchetypes.h"
+
+FCombatResult FCombatResolver::Resolve(const FSimUnit& Attacker, const FSimUnit& Defender, bool bAdjacent, FRandomStream& Stream)
+{
+	FCombatResult Result;
+	Result.AttackerHealth = Attacker.Health;
+
+	Result.Damage = Stream.RandRange(Attacker.MinDamage, Attacker.MaxDamage);
+	Result.DefenderHealth = FMath::Max(0, Defender.Health - Result.Damage);
+	Result.bDefenderKilled = Result.DefenderHealth == 0;
+
+	if (!Result.bDefenderKilled && FCombatAnalytics::CanCounter(Attacker.Archetype, Defender.Archetype, bAdjacent))
+	{
+		const FUnitArchetype& Counter = FUnitArchetypeTable::Get()[Defender.Archetype];
+		Result.bCountered = true;
+		Result.CounterDamage = Stream.RandRange(Counter.CounterMinDamage, Counter.CounterMaxDamage);
+		Result.AttackerHealth = FMath::Max(0, Attacker.Health - Result.CounterDamage);
+		Result.bAttackerKilled = Result.AttackerHealth == 0;
+	}
+
+	return Result;
+}
+
+FCombatResult FCombatResolver::Resolve(const FSimBoard& Board, int32 AttackerIndex, int32 DefenderIndex, FRandomStream& Stream)
+{
+	const FSimUnit& Attacker = Board.Units[AttackerIndex];
+	const FSimUnit& Defender = Board.Units[DefenderIndex];
+	const bool bAdjacent = Board.DistanceSquared(Attacker.TileIndex, Defender.TileIndex) <= 1;
+
+	return Resolve(Attacker, Defender, bAdjacent, Stream);
+}
+
+void FCombatResolver::Apply(FSimBoard& Board, int32 AttackerIndex, int32 DefenderIndex, const FCombatResult& Result)
+{
+	Board.ApplyDamage(DefenderIndex, Result.Damage);
+
+	if (Result.bCountered)
+	{
+		Board.ApplyDamage(AttackerIndex, Result.CounterDamage);
+	}
+}
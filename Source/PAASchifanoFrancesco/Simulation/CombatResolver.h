@@ -0,0 +1,55 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SimBoard.h"
+
+/**
+ * Descrizione:
+ * Esito completo di un attacco: danno inflitto, eventuale contrattacco e vita finale
+ * delle due unità. È l'unico valore che attori e simulazione applicano, quindi
+ * la history mostra esattamente il danno applicato.
+ */
+struct FCombatResult
+{
+	/** Danno inflitto dall'attaccante */
+	int32 Damage = 0;
+
+	/** Vita del difensore dopo l'attacco */
+	int32 DefenderHealth = 0;
+	bool bDefenderKilled = false;
+
+	/** true se il difensore ha contrattaccato */
+	bool bCountered = false;
+	int32 CounterDamage = 0;
+
+	/** Vita dell'attaccante dopo l'eventuale contrattacco */
+	int32 AttackerHealth = 0;
+	bool bAttackerKilled = false;
+};
+
+/**
+ * Classe: FCombatResolver
+ * Descrizione:
+ * Regole di combattimento condivise da partita reale (AUnitBase::AttackUnit) e simulazione
+ * (IA, pondering, partite headless):
+ * 1. Danno uniforme in [MinDamage, MaxDamage].
+ * 2. Se l'archetipo dell'attaccante provoca il contrattacco (Sniper) e il difensore sopravvive,
+ *    il difensore adiacente (o uno Sniper a qualsiasi distanza) contrattacca con danno uniforme
+ *    nell'intervallo di contrattacco del proprio archetipo (FUnitArchetypeTable).
+ * La regola vale per entrambe le fazioni. Tutti i numeri casuali vengono estratti dallo stream
+ * ricevuto, sempre nello stesso ordine: stesso seed, stesso esito.
+ */
+class PAASCHIFANOFRANCESCO_API FCombatResolver
+{
+public:
+	/** Risolve un attacco fra due unità; bAdjacent indica se sono su tile adiacenti */
+	static FCombatResult Resolve(const FSimUnit& Attacker, const FSimUnit& Defender, bool bAdjacent, FRandomStream& Stream);
+
+	/** Risolve un attacco sulla board (l'adiacenza è calcolata dalle tile delle unità) */
+	static FCombatResult Resolve(const FSimBoard& Board, int32 AttackerIndex, int32 DefenderIndex, FRandomStream& Stream);
+
+	/** Applica un esito alla board */
+	static void Apply(FSimBoard& Board, int32 AttackerIndex, int32 DefenderIndex, const FCombatResult& Result);
+};
@@ -0,0 +1,322 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "MatchCommandLog.h"
+#include "SimBoard.h"
+
+namespace
+{
+	// Intestazione di un comando: 4 bit di tipo, i flag di fazione e Sniper, 2 bit di squadra
+	constexpr uint8 TypeMask = 0x0F;
+	constexpr uint8 PlayerFlag = 0x10;
+	constexpr uint8 RangedFlag = 0x20;
+	constexpr int32 TeamShift = 6;
+
+	// Tile non valida nella codifica a 16 bit
+	constexpr uint16 NoTile = 0xFFFF;
+
+	int32 ReadTile(const TArray<uint8>& Bytes, int32& Cursor)
+	{
+		const uint16 Value = static_cast<uint16>(Bytes[Cursor] | (Bytes[Cursor + 1] << 8));
+		Cursor += 2;
+		return Value == NoTile ? INDEX_NONE : Value;
+	}
+}
+
+void FMatchCommandLog::Reset(int32 InDimX, int32 InDimY)
+{
+	Bytes.Reset();
+	Offsets.Reset();
+	DimX = InDimX;
+	DimY = InDimY;
+	++Generation;
+}
+
+void FMatchCommandLog::Truncate(int32 NewNum)
+{
+	if (NewNum < 0 || NewNum >= Offsets.Num()) return;
+
+	Bytes.SetNum(Offsets[NewNum]);
+	Offsets.SetNum(NewNum);
+	++Generation;
+}
+
+void FMatchCommandLog::BeginCommand(EMatchCommand Type, bool bPlayer, bool bRanged, int32 Team)
+{
+	Offsets.Add(Bytes.Num());
+
+	if (Team == INDEX_NONE)
+	{
+		Team = FSimBoard::GetDefaultTeam(bPlayer);
+	}
+
+	uint8 Header = static_cast<uint8>(Type) & TypeMask;
+	if (bPlayer) Header |= PlayerFlag;
+	if (bRanged) Header |= RangedFlag;
+	Header |= FSimBoard::EncodeTeamBits(bPlayer, Team) << TeamShift;
+	WriteByte(Header);
+}
+
+void FMatchCommandLog::WriteTile(int32 TileIndex)
+{
+	const uint16 Value = (TileIndex >= 0 && TileIndex < NoTile) ? static_cast<uint16>(TileIndex) : NoTile;
+	WriteByte(static_cast<uint8>(Value & 0xFF));
+	WriteByte(static_cast<uint8>(Value >> 8));
+}
+
+void FMatchCommandLog::AppendPlace(bool bPlayer, bool bRanged, int32 Tile, int32 Team)
+{
+	BeginCommand(EMatchCommand::Place, bPlayer, bRanged, Team);
+	WriteTile(Tile);
+}
+
+void FMatchCommandLog::AppendMove(bool bPlayer, bool bRanged, int32 FromTile, TConstArrayView<int32> Path, int32 Team)
+{
+	// Il movimento massimo è di poche tile: un byte basta per la lunghezza
+	const int32 Length = FMath::Min(Path.Num(), 255);
+
+	BeginCommand(EMatchCommand::Move, bPlayer, bRanged, Team);
+	WriteTile(FromTile);
+	WriteByte(static_cast<uint8>(Length));
+
+	for (int32 i = 0; i < Length; i++)
+	{
+		WriteTile(Path[i]);
+	}
+}
+
+void FMatchCommandLog::AppendAttack(bool bPlayer, bool bRanged, int32 AttackerTile, int32 TargetTile, int32 Damage, int32 Team)
+{
+	BeginCommand(EMatchCommand::Attack, bPlayer, bRanged, Team);
+	WriteTile(AttackerTile);
+	WriteTile(TargetTile);
+	WriteByte(static_cast<uint8>(FMath::Clamp(Damage, 0, 255)));
+}
+
+void FMatchCommandLog::AppendCounter(bool bPlayer, bool bRanged, int32 DefenderTile, int32 AttackerTile, int32 Damage, int32 Team)
+{
+	BeginCommand(EMatchCommand::Counter, bPlayer, bRanged, Team);
+	WriteTile(DefenderTile);
+	WriteTile(AttackerTile);
+	WriteByte(static_cast<uint8>(FMath::Clamp(Damage, 0, 255)));
+}
+
+void FMatchCommandLog::AppendEndTurn(bool bPlayer, int32 Team)
+{
+	BeginCommand(EMatchCommand::EndTurn, bPlayer, false, Team);
+}
+
+void FMatchCommandLog::AppendDeath(bool bPlayer, bool bRanged, int32 Tile, int32 Team)
+{
+	BeginCommand(EMatchCommand::Death, bPlayer, bRanged, Team);
+	WriteTile(Tile);
+}
+
+bool FMatchCommandLog::GetCommandSize(int32 Offset, int32& OutSize) const
+{
+	if (!Bytes.IsValidIndex(Offset)) return false;
+
+	// Un'intestazione con una squadra non valida rende non validi i byte (log caricati o ricevuti)
+	const uint8 Header = Bytes[Offset];
+	if (FSimBoard::DecodeTeamBits((Header & PlayerFlag) != 0, Header >> TeamShift) == INDEX_NONE) return false;
+
+	switch (static_cast<EMatchCommand>(Bytes[Offset] & TypeMask))
+	{
+	case EMatchCommand::Place:
+	case EMatchCommand::Death:
+		OutSize = 1 + 2;
+		break;
+	case EMatchCommand::Move:
+		if (!Bytes.IsValidIndex(Offset + 3)) return false;
+		OutSize = 1 + 2 + 1 + 2 * Bytes[Offset + 3];
+		break;
+	case EMatchCommand::Attack:
+	case EMatchCommand::Counter:
+		OutSize = 1 + 2 + 2 + 1;
+		break;
+	case EMatchCommand::EndTurn:
+		OutSize = 1;
+		break;
+	default:
+		return false;
+	}
+
+	return Offset + OutSize <= Bytes.Num();
+}
+
+bool FMatchCommandLog::Decode(int32 Index, FMatchCommand& OutCommand) const
+{
+	if (!Offsets.IsValidIndex(Index)) return false;
+
+	int32 Cursor = Offsets[Index];
+	const uint8 Header = Bytes[Cursor++];
+
+	OutCommand = FMatchCommand();
+	OutCommand.Type = static_cast<EMatchCommand>(Header & TypeMask);
+	OutCommand.bPlayer = (Header & PlayerFlag) != 0;
+	OutCommand.bRanged = (Header & RangedFlag) != 0;
+	const int32 Team = FSimBoard::DecodeTeamBits(OutCommand.bPlayer, Header >> TeamShift);
+	if (Team == INDEX_NONE) return false;
+	OutCommand.Team = static_cast<uint8>(Team);
+
+	switch (OutCommand.Type)
+	{
+	case EMatchCommand::Place:
+	case EMatchCommand::Death:
+		OutCommand.Tile = ReadTile(Bytes, Cursor);
+		break;
+	case EMatchCommand::Move:
+	{
+		OutCommand.Tile = ReadTile(Bytes, Cursor);
+		const int32 Length = Bytes[Cursor++];
+		OutCommand.Path.Reserve(Length);
+		for (int32 i = 0; i < Length; i++)
+		{
+			OutCommand.Path.Add(ReadTile(Bytes, Cursor));
+		}
+		break;
+	}
+	case EMatchCommand::Attack:
+	case EMatchCommand::Counter:
+		OutCommand.Tile = ReadTile(Bytes, Cursor);
+		OutCommand.TargetTile = ReadTile(Bytes, Cursor);
+		OutCommand.Value = Bytes[Cursor++];
+		break;
+	default:
+		break;
+	}
+
+	return true;
+}
+
+TConstArrayView<uint8> FMatchCommandLog::GetCommandBytes(int32 FirstCommand) const
+{
+	if (!Offsets.IsValidIndex(FirstCommand)) return TConstArrayView<uint8>();
+
+	const int32 Start = Offsets[FirstCommand];
+	return TConstArrayView<uint8>(Bytes.GetData() + Start, Bytes.Num() - Start);
+}
+
+TConstArrayView<uint8> FMatchCommandLog::GetCommandBytes(int32 FirstCommand, int32 EndCommand) const
+{
+	if (!Offsets.IsValidIndex(FirstCommand) || EndCommand <= FirstCommand) return TConstArrayView<uint8>();
+
+	const int32 Start = Offsets[FirstCommand];
+	const int32 End = EndCommand < Offsets.Num() ? Offsets[EndCommand] : Bytes.Num();
+	return TConstArrayView<uint8>(Bytes.GetData() + Start, End - Start);
+}
+
+int32 FMatchCommandLog::FindBatchEnd(int32 FirstCommand, int32 MaxBytes) const
+{
+	if (!Offsets.IsValidIndex(FirstCommand)) return FirstCommand;
+
+	const int32 Start = Offsets[FirstCommand];
+	int32 End = FirstCommand + 1;
+	while (End < Offsets.Num() && (End + 1 < Offsets.Num() ? Offsets[End + 1] : Bytes.Num()) - Start <= MaxBytes)
+	{
+		++End;
+	}
+	return End;
+}
+
+int32 FMatchCommandLog::AppendEncoded(TConstArrayView<uint8> EncodedCommands)
+{
+	const int32 PreviousBytes = Bytes.Num();
+	const int32 PreviousCommands = Offsets.Num();
+	Bytes.Append(EncodedCommands.GetData(), EncodedCommands.Num());
+
+	int32 Offset = PreviousBytes;
+	while (Offset < Bytes.Num())
+	{
+		int32 Size = 0;
+		if (!GetCommandSize(Offset, Size))
+		{
+			// Byte non validi: ripristina il log com'era
+			Bytes.SetNum(PreviousBytes);
+			Offsets.SetNum(PreviousCommands);
+			return INDEX_NONE;
+		}
+
+		Offsets.Add(Offset);
+		Offset += Size;
+	}
+
+	return Offsets.Num() - PreviousCommands;
+}
+
+bool FMatchCommandLog::RebuildOffsets()
+{
+	Offsets.Reset();
+
+	int32 Offset = 0;
+	while (Offset < Bytes.Num())
+	{
+		int32 Size = 0;
+		if (!GetCommandSize(Offset, Size))
+		{
+			UE_LOG(LogTemp, Error, TEXT("MatchCommandLog: comando non valido all'offset %d"), Offset);
+			Reset(DimX, DimY);
+			return false;
+		}
+
+		Offsets.Add(Offset);
+		Offset += Size;
+	}
+
+	return true;
+}
+
+void FMatchCommandLog::Serialize(FArchive& Ar)
+{
+	Ar << DimX;
+	Ar << DimY;
+	Ar << Bytes;
+
+	if (Ar.IsLoading())
+	{
+		if (!RebuildOffsets())
+		{
+			Ar.SetError();
+		}
+		++Generation;
+	}
+}
+
+FString FMatchCommandLog::GetTileName(int32 TileIndex) const
+{
+	if (TileIndex == INDEX_NONE || DimX <= 0) return TEXT("?");
+
+	const TCHAR RowLetter = static_cast<TCHAR>('A' + TileIndex / DimX);
+	return FString::Printf(TEXT("%c%d"), RowLetter, TileIndex % DimX + 1);
+}
+
+bool FMatchCommandLog::IsHistoryEntry(EMatchCommand Type)
+{
+	return Type == EMatchCommand::Move || Type == EMatchCommand::Attack || Type == EMatchCommand::Counter;
+}
+
+FString FMatchCommandLog::Format(const FMatchCommand& Command) const
+{
+	const FString Side = FSimBoard::GetTeamName(Command.Team);
+	const TCHAR* Unit = Command.bRanged ? TEXT("Sniper") : TEXT("Brawler");
+
+	switch (Command.Type)
+	{
+	case EMatchCommand::Place:
+		return FString::Printf(TEXT("%s: %s placed on %s"), *Side, Unit, *GetTileName(Command.Tile));
+	case EMatchCommand::Move:
+	{
+		const int32 Destination = Command.Path.Num() > 0 ? Command.Path.Last() : Command.Tile;
+		return FString::Printf(TEXT("%s: %s moves from %s to %s"), *Side, Unit, *GetTileName(Command.Tile), *GetTileName(Destination));
+	}
+	case EMatchCommand::Attack:
+		return FString::Printf(TEXT("%s: %s attacks %s damage %d"), *Side, Unit, *GetTileName(Command.TargetTile), Command.Value);
+	case EMatchCommand::Counter:
+		return FString::Printf(TEXT("%s: %s counterattack %s damage %d"), *Side, Unit, *GetTileName(Command.TargetTile), Command.Value);
+	case EMatchCommand::EndTurn:
+		return FString::Printf(TEXT("%s: end turn"), *Side);
+	case EMatchCommand::Death:
+		return FString::Printf(TEXT("%s: %s destroyed on %s"), *Side, Unit, *GetTileName(Command.Tile));
+	default:
+		return FString();
+	}
+}
@@ -0,0 +1,141 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Tipo di un comando registrato durante la partita */
+enum class EMatchCommand : uint8
+{
+	Place,    // Piazzamento di un'unità
+	Move,     // Movimento lungo un percorso
+	Attack,   // Attacco con il danno effettivamente applicato
+	Counter,  // Contrattacco del difensore
+	EndTurn,  // Fine del turno di una fazione
+	Death     // Morte di un'unità
+};
+
+/**
+ * Descrizione:
+ * Comando decodificato. Le unità sono identificate dalla tile che occupano nel momento
+ * del comando (ogni tile contiene al massimo un'unità), così il log non dipende dagli attori.
+ */
+struct FMatchCommand
+{
+	EMatchCommand Type = EMatchCommand::EndTurn;
+
+	/** Fazione che esegue il comando (per Counter è il difensore che risponde) */
+	bool bPlayer = false;
+
+	/** Squadra che esegue il comando (0 per il player) */
+	uint8 Team = 0;
+
+	/** true se l'unità che esegue il comando è uno Sniper */
+	bool bRanged = false;
+
+	/** Tile dell'unità che esegue il comando (partenza per Move) */
+	int32 Tile = INDEX_NONE;
+
+	/** Tile del bersaglio (Attack, Counter) */
+	int32 TargetTile = INDEX_NONE;
+
+	/** Danno applicato (Attack, Counter) */
+	int32 Value = 0;
+
+	/** Percorso del movimento, partenza esclusa (Move) */
+	TArray<int32, TInlineAllocator<8>> Path;
+};
+
+/**
+ * Classe: FMatchCommandLog
+ * Descrizione:
+ * Log binario compatto di tutti i comandi della partita (event sourcing).
+ * Ogni comando occupa pochi byte: tipo, flag (fazione, Sniper, squadra) e tile a 16 bit.
+ * È l'unica fonte per history della UI (formattata solo quando serve), replay,
+ * undo, telemetria e sincronizzazione di rete.
+ */
+class PAASCHIFANOFRANCESCO_API FMatchCommandLog
+{
+public:
+	/** Svuota il log e memorizza le dimensioni della griglia (servono per i nomi delle tile) */
+	void Reset(int32 InDimX, int32 InDimY);
+
+	/** Team = INDEX_NONE: squadra predefinita della fazione (0 player, 1 IA) */
+	void AppendPlace(bool bPlayer, bool bRanged, int32 Tile, int32 Team = INDEX_NONE);
+	void AppendMove(bool bPlayer, bool bRanged, int32 FromTile, TConstArrayView<int32> Path, int32 Team = INDEX_NONE);
+	void AppendAttack(bool bPlayer, bool bRanged, int32 AttackerTile, int32 TargetTile, int32 Damage, int32 Team = INDEX_NONE);
+	void AppendCounter(bool bPlayer, bool bRanged, int32 DefenderTile, int32 AttackerTile, int32 Damage, int32 Team = INDEX_NONE);
+	void AppendEndTurn(bool bPlayer, int32 Team = INDEX_NONE);
+	void AppendDeath(bool bPlayer, bool bRanged, int32 Tile, int32 Team = INDEX_NONE);
+
+	/** Numero di comandi registrati */
+	int32 Num() const { return Offsets.Num(); }
+
+	/** Scarta i comandi da NewNum in poi (undo delle azioni del player) */
+	void Truncate(int32 NewNum);
+
+	/** Cambia a ogni Reset/Truncate: le viste derivate (history) sanno quando ricostruirsi */
+	uint32 GetGeneration() const { return Generation; }
+
+	/** Decodifica il comando di indice Index */
+	bool Decode(int32 Index, FMatchCommand& OutCommand) const;
+
+	/** Byte del log (per replay, salvataggi e rete) */
+	const TArray<uint8>& GetBytes() const { return Bytes; }
+
+	/** Byte dei comandi [FirstCommand, Num()) già codificati (pacchetti di rete) */
+	TConstArrayView<uint8> GetCommandBytes(int32 FirstCommand) const;
+
+	/** Byte dei comandi [FirstCommand, EndCommand) */
+	TConstArrayView<uint8> GetCommandBytes(int32 FirstCommand, int32 EndCommand) const;
+
+	/**
+	 * Fine del gruppo di comandi che parte da FirstCommand e occupa al più MaxBytes byte
+	 * (almeno un comando): i pacchetti di rete hanno una lunghezza massima.
+	 */
+	int32 FindBatchEnd(int32 FirstCommand, int32 MaxBytes) const;
+
+	/**
+	 * Accoda comandi già codificati (ricevuti dalla rete). I byte vengono validati:
+	 * se contengono un comando troncato o sconosciuto il log resta invariato.
+	 * Restituisce il numero di comandi aggiunti, INDEX_NONE se i byte non sono validi.
+	 */
+	int32 AppendEncoded(TConstArrayView<uint8> EncodedCommands);
+
+	int32 GetDimX() const { return DimX; }
+	int32 GetDimY() const { return DimY; }
+
+	/** Serializza dimensioni e byte; in caricamento ricostruisce l'indice dei comandi */
+	void Serialize(FArchive& Ar);
+
+	/** Nome della tile nel formato di AGridManager (es. "C7") */
+	FString GetTileName(int32 TileIndex) const;
+
+	/** true per i comandi mostrati nella history della UI (movimenti e attacchi) */
+	static bool IsHistoryEntry(EMatchCommand Type);
+
+	/** Testo leggibile di un comando, nello stesso formato della history della UI */
+	FString Format(const FMatchCommand& Command) const;
+
+private:
+	/** Scrive l'intestazione comune (tipo + flag) e registra l'offset del comando */
+	void BeginCommand(EMatchCommand Type, bool bPlayer, bool bRanged, int32 Team);
+	void WriteTile(int32 TileIndex);
+	void WriteByte(uint8 Value) { Bytes.Add(Value); }
+
+	/** Ricostruisce Offsets scorrendo Bytes (dopo il caricamento) */
+	bool RebuildOffsets();
+
+	/** Dimensione in byte del corpo di un comando, letta a partire da Offset */
+	bool GetCommandSize(int32 Offset, int32& OutSize) const;
+
+	TArray<uint8> Bytes;
+
+	/** Offset di inizio di ogni comando in Bytes */
+	TArray<int32> Offsets;
+
+	int32 DimX = 0;
+	int32 DimY = 0;
+
+	uint32 Generation = 0;
+};
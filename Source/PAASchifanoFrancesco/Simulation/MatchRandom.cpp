@@ -0,0 +1,36 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "MatchRandom.h"
+
+namespace
+{
+	// Sali distinti per gli stream della partita
+	constexpr uint32 MapSalt = 0x4D415030;    // "MAP0"
+	constexpr uint32 AISalt = 0x41493030;     // "AI00"
+	constexpr uint32 CombatSalt = 0x434D4254; // "CMBT"
+}
+
+void FMatchRandom::Initialize(int32 InSeed)
+{
+	Seed = InSeed;
+	Map.Initialize(DeriveSeed(Seed, MapSalt));
+	AI.Initialize(DeriveSeed(Seed, AISalt));
+	Combat.Initialize(DeriveSeed(Seed, CombatSalt));
+}
+
+int32 FMatchRandom::GenerateSeed()
+{
+	FRandomStream Stream;
+	Stream.GenerateNewSeed();
+	return Stream.GetCurrentSeed();
+}
+
+/**
+ * Descrizione:
+ * Combina seed e sale con HashCombine: stream diversi partono da stati scorrelati
+ * anche per seed di partita consecutivi.
+ */
+int32 FMatchRandom::DeriveSeed(int32 MatchSeed, uint32 Salt)
+{
+	return static_cast<int32>(HashCombine(::GetTypeHash(MatchSeed), Salt));
+}
@@ -0,0 +1,33 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Descrizione:
+ * Generatori casuali di una partita. Un solo seed di partita genera tre stream indipendenti,
+ * così le estrazioni di un sistema non spostano quelle degli altri:
+ * - Map: percentuale di ostacoli, DFS della griglia e lancio della moneta;
+ * - AI: piazzamento delle unità dell'IA e decisioni dell'IA Easy;
+ * - Combat: danni e contrattacchi (FCombatResolver).
+ * Con lo stesso seed (-MatchSeed=N) la partita si ripete identica.
+ */
+struct PAASCHIFANOFRANCESCO_API FMatchRandom
+{
+	/** Seed della partita (da riga di comando, dal menu o generato) */
+	int32 Seed = 0;
+
+	FRandomStream Map;
+	FRandomStream AI;
+	FRandomStream Combat;
+
+	/** Inizializza tutti gli stream a partire dal seed della partita */
+	void Initialize(int32 InSeed);
+
+	/** Seed non deterministico per una nuova partita */
+	static int32 GenerateSeed();
+
+	/** Seed di uno stream derivato dal seed della partita e da un sale diverso per ogni stream */
+	static int32 DeriveSeed(int32 MatchSeed, uint32 Salt);
+};
@@ -0,0 +1,358 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "MatchReplay.h"
+#include "PAASchifanoFrancesco/Units/UnitArchetypes.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	/** Serializzazione compatta di un'unità per i keyframe (l'attore non viene salvato) */
+	void SerializeUnit(FArchive& Ar, FSimUnit& Unit)
+	{
+		Ar << Unit.UnitId;
+		Ar << Unit.TileIndex;
+		Ar << Unit.Health;
+		Ar << Unit.MaxHealth;
+		Ar << Unit.MovementRange;
+		Ar << Unit.AttackRange;
+		Ar << Unit.MinDamage;
+		Ar << Unit.MaxDamage;
+
+		uint8 Flags = (Unit.bRanged ? 1 : 0) | (Unit.bPlayer ? 2 : 0) | (Unit.bHasMoved ? 4 : 0) | (Unit.bHasAttacked ? 8 : 0)
+			| (FSimBoard::EncodeTeamBits(Unit.bPlayer, Unit.Team) << 4);
+		Ar << Flags;
+		Unit.bRanged = (Flags & 1) != 0;
+		Unit.Archetype = static_cast<uint8>(FUnitArchetypeTable::FromRangedFlag(Unit.bRanged));
+		Unit.bPlayer = (Flags & 2) != 0;
+		const int32 Team = FSimBoard::DecodeTeamBits(Unit.bPlayer, Flags >> 4);
+		if (Team == INDEX_NONE)
+		{
+			Ar.SetError();
+		}
+		Unit.Team = static_cast<uint8>(FMath::Max(0, Team));
+		Unit.bHasMoved = (Flags & 4) != 0;
+		Unit.bHasAttacked = (Flags & 8) != 0;
+	}
+
+	/** Unità con le statistiche dell'archetipo dello Sniper o del Brawler (come FSimMatch::PlaceUnits) */
+	FSimUnit MakeArchetypeUnit(const FSimBoard& Board, bool bRanged, bool bPlayer, int32 Team, int32 TileIndex)
+	{
+		FSimUnit Unit = FSimUnit::FromArchetype(static_cast<int32>(FUnitArchetypeTable::FromRangedFlag(bRanged)), Team);
+		Unit.UnitId = Board.Units.Num() + 1;
+		Unit.TileIndex = TileIndex;
+		Unit.bPlayer = bPlayer;
+		return Unit;
+	}
+
+	/** Byte minimi di un keyframe (turno, indice del comando, numero di unità) e di un'unità serializzata */
+	constexpr int64 MinKeyframeBytes = 3 * sizeof(int32);
+	constexpr int64 UnitBytes = 8 * sizeof(int32) + sizeof(uint8);
+
+	/**
+	 * Un conteggio letto dal file è valido se non supera Max e se i byte rimasti bastano a contenerne
+	 * gli elementi: un file corrotto non può far allocare array enormi.
+	 */
+	bool IsValidCount(FArchive& Ar, int32 Count, int64 Max, int64 ElementBytes)
+	{
+		return Count >= 0 && Count <= Max && Count * ElementBytes <= Ar.TotalSize() - Ar.Tell();
+	}
+
+	/** Unità che occupa la tile, INDEX_NONE se libera o fuori griglia */
+	int32 GetOccupant(const FSimBoard& Board, int32 TileIndex)
+	{
+		return Board.IsValidTile(TileIndex) ? Board.Occupants[TileIndex] : INDEX_NONE;
+	}
+}
+
+void FMatchReplay::InitBoard(FSimBoard& OutBoard) const
+{
+	OutBoard.Init(CommandLog.GetDimX(), CommandLog.GetDimY());
+	for (int32 Index = 0; Index < OutBoard.NumTiles() && Index < Obstacles.Num(); ++Index)
+	{
+		OutBoard.Obstacles[Index] = Obstacles[Index];
+	}
+}
+
+/**
+ * Descrizione:
+ * Riproduce l'intero log una sola volta e salva la board all'inizio di ogni KeyframeInterval-esimo turno.
+ */
+void FMatchReplay::Build(int32 InSeed, const TBitArray<>& InObstacles, const FMatchCommandLog& InCommandLog)
+{
+	Seed = InSeed;
+	Obstacles = InObstacles;
+	CommandLog = InCommandLog;
+	Keyframes.Reset();
+
+	FSimBoard Board;
+	InitBoard(Board);
+
+	int32 Turn = 0;
+	Keyframes.Add({ Turn, 0, Board.Units });
+
+	FMatchCommand Command;
+	for (int32 Index = 0; Index < CommandLog.Num(); ++Index)
+	{
+		if (!CommandLog.Decode(Index, Command)) continue;
+
+		ApplyCommand(Board, Command);
+
+		if (Command.Type == EMatchCommand::EndTurn && ++Turn % KeyframeInterval == 0)
+		{
+			Keyframes.Add({ Turn, Index + 1, Board.Units });
+		}
+	}
+
+	NumTurns = Turn + 1;
+}
+
+void FMatchReplay::ApplyCommand(FSimBoard& Board, const FMatchCommand& Command)
+{
+	switch (Command.Type)
+	{
+	case EMatchCommand::Place:
+		if (Board.IsFree(Command.Tile))
+		{
+			Board.AddUnit(MakeArchetypeUnit(Board, Command.bRanged, Command.bPlayer, Command.Team, Command.Tile));
+		}
+		break;
+
+	case EMatchCommand::Move:
+	{
+		const int32 UnitIndex = GetOccupant(Board, Command.Tile);
+		if (UnitIndex != INDEX_NONE && Command.Path.Num() > 0)
+		{
+			Board.MoveUnit(UnitIndex, Command.Path.Last());
+		}
+		break;
+	}
+
+	case EMatchCommand::Attack:
+	case EMatchCommand::Counter:
+	{
+		const int32 AttackerIndex = GetOccupant(Board, Command.Tile);
+		const int32 TargetIndex = GetOccupant(Board, Command.TargetTile);
+		if (AttackerIndex != INDEX_NONE && Command.Type == EMatchCommand::Attack)
+		{
+			Board.Units[AttackerIndex].bHasMoved = true;
+			Board.Units[AttackerIndex].bHasAttacked = true;
+		}
+		if (TargetIndex != INDEX_NONE)
+		{
+			Board.ApplyDamage(TargetIndex, Command.Value);
+		}
+		break;
+	}
+
+	case EMatchCommand::Death:
+	{
+		// Di norma la tile è già libera (ApplyDamage); il comando rende esplicita la rimozione
+		const int32 UnitIndex = GetOccupant(Board, Command.Tile);
+		if (UnitIndex != INDEX_NONE)
+		{
+			Board.ApplyDamage(UnitIndex, Board.Units[UnitIndex].Health);
+		}
+		break;
+	}
+
+	case EMatchCommand::EndTurn:
+		for (FSimUnit& Unit : Board.Units)
+		{
+			if (Unit.Team == Command.Team)
+			{
+				Unit.bHasMoved = false;
+				Unit.bHasAttacked = false;
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+/**
+ * Descrizione:
+ * Parte dall'ultimo keyframe non successivo al turno richiesto e applica solo i comandi
+ * che lo separano dall'inizio del turno (al massimo KeyframeInterval turni).
+ */
+bool FMatchReplay::Seek(int32 Turn, FSimBoard& OutBoard, int32& OutCommandIndex) const
+{
+	if (Keyframes.Num() == 0 || Turn < 0 || Turn >= NumTurns) return false;
+
+	int32 KeyframeIndex = Keyframes.Num() - 1;
+	while (KeyframeIndex > 0 && Keyframes[KeyframeIndex].Turn > Turn)
+	{
+		--KeyframeIndex;
+	}
+	const FReplayKeyframe& Keyframe = Keyframes[KeyframeIndex];
+
+	InitBoard(OutBoard);
+	for (const FSimUnit& Unit : Keyframe.Units)
+	{
+		OutBoard.AddUnit(Unit);
+	}
+
+	int32 CurrentTurn = Keyframe.Turn;
+	OutCommandIndex = Keyframe.CommandIndex;
+
+	FMatchCommand Command;
+	while (CurrentTurn < Turn && OutCommandIndex < CommandLog.Num())
+	{
+		if (CommandLog.Decode(OutCommandIndex, Command))
+		{
+			ApplyCommand(OutBoard, Command);
+			if (Command.Type == EMatchCommand::EndTurn)
+			{
+				++CurrentTurn;
+			}
+		}
+		++OutCommandIndex;
+	}
+
+	return true;
+}
+
+void FMatchReplay::SerializeBody(FArchive& Ar)
+{
+	Ar << Seed;
+	Ar << NumTurns;
+	Ar << Obstacles;
+	CommandLog.Serialize(Ar);
+
+	int32 NumKeyframes = Keyframes.Num();
+	Ar << NumKeyframes;
+	if (Ar.IsLoading())
+	{
+		// Un keyframe ogni KeyframeInterval turni, più quello iniziale
+		if (!IsValidCount(Ar, NumKeyframes, NumTurns / KeyframeInterval + 1, MinKeyframeBytes))
+		{
+			Ar.SetError();
+			return;
+		}
+		Keyframes.SetNum(NumKeyframes);
+	}
+
+	// Ogni unità piazzata occupa una tile diversa: non possono essercene più delle tile
+	const int64 MaxUnits = static_cast<int64>(FMath::Max(0, CommandLog.GetDimX())) * FMath::Max(0, CommandLog.GetDimY());
+
+	for (FReplayKeyframe& Keyframe : Keyframes)
+	{
+		Ar << Keyframe.Turn;
+		Ar << Keyframe.CommandIndex;
+
+		int32 NumUnits = Keyframe.Units.Num();
+		Ar << NumUnits;
+		if (Ar.IsLoading())
+		{
+			if (!IsValidCount(Ar, NumUnits, MaxUnits, UnitBytes))
+			{
+				Ar.SetError();
+				return;
+			}
+			Keyframe.Units.SetNum(NumUnits);
+		}
+
+		for (FSimUnit& Unit : Keyframe.Units)
+		{
+			SerializeUnit(Ar, Unit);
+		}
+	}
+}
+
+bool FMatchReplay::SaveToFile(const FString& Filename)
+{
+	// Corpo non compresso
+	TArray<uint8> Body;
+	FMemoryWriter BodyWriter(Body);
+	SerializeBody(BodyWriter);
+
+	// Compressione Zlib del corpo
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Body.Num());
+	TArray<uint8> Compressed;
+	Compressed.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Zlib, Compressed.GetData(), CompressedSize, Body.GetData(), Body.Num()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay: compressione fallita"));
+		return false;
+	}
+	Compressed.SetNum(CompressedSize);
+
+	// Intestazione + corpo compresso
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+	uint32 FileMagic = Magic;
+	uint16 Version = CurrentVersion;
+	int32 UncompressedSize = Body.Num();
+	Writer << FileMagic;
+	Writer << Version;
+	Writer << UncompressedSize;
+	Writer << CompressedSize;
+	Writer.Serialize(Compressed.GetData(), CompressedSize);
+
+	if (!FFileHelper::SaveArrayToFile(FileData, *Filename))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay: impossibile scrivere %s"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Replay salvato in %s (%d comandi, %d byte)"), *Filename, CommandLog.Num(), FileData.Num());
+	return true;
+}
+
+bool FMatchReplay::LoadFromFile(const FString& Filename)
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *Filename))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay: impossibile leggere %s"), *Filename);
+		return false;
+	}
+
+	FMemoryReader Reader(FileData);
+	uint32 FileMagic = 0;
+	uint16 Version = 0;
+	int32 UncompressedSize = 0;
+	int32 CompressedSize = 0;
+	Reader << FileMagic;
+	Reader << Version;
+	Reader << UncompressedSize;
+	Reader << CompressedSize;
+
+	if (FileMagic != Magic || Version == 0 || Version > CurrentVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay: %s non è un replay valido (versione %d, supportata fino a %d)"), *Filename, Version, CurrentVersion);
+		return false;
+	}
+
+	const int64 BodyOffset = Reader.Tell();
+	if (UncompressedSize < 0 || CompressedSize < 0 || BodyOffset + CompressedSize > FileData.Num())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay: %s è troncato"), *Filename);
+		return false;
+	}
+
+	TArray<uint8> Body;
+	Body.SetNumUninitialized(UncompressedSize);
+	if (!FCompression::UncompressMemory(NAME_Zlib, Body.GetData(), UncompressedSize, FileData.GetData() + BodyOffset, CompressedSize))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Replay: decompressione fallita per %s"), *Filename);
+		return false;
+	}
+
+	FMemoryReader BodyReader(Body);
+	SerializeBody(BodyReader);
+
+	return !BodyReader.IsError();
+}
+
+FString FMatchReplay::MakeReplayFilename(int32 InSeed)
+{
+	const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S"));
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Replays"), FString::Printf(TEXT("Match_%d_%s.replay"), InSeed, *Timestamp));
+}
@@ -0,0 +1,82 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SimBoard.h"
+#include "MatchCommandLog.h"
+
+/**
+ * Descrizione:
+ * Istantanea delle unità all'inizio di un turno. Gli ostacoli non cambiano durante la partita
+ * e sono salvati una sola volta nel replay.
+ */
+struct FReplayKeyframe
+{
+	/** Turno di battaglia (numero di EndTurn già eseguiti) */
+	int32 Turn = 0;
+
+	/** Indice del primo comando del log da applicare dopo l'istantanea */
+	int32 CommandIndex = 0;
+
+	/** Unità della board (anche quelle morte, per mantenere stabili gli indici) */
+	TArray<FSimUnit> Units;
+};
+
+/**
+ * Classe: FMatchReplay
+ * Descrizione:
+ * Replay di una partita: seed, ostacoli, log dei comandi e keyframe periodici della board.
+ * La riproduzione applica i comandi registrati a una FSimBoard, senza eseguire l'IA né tirare dadi.
+ * Per raggiungere un turno si parte dal keyframe precedente e si applicano solo i comandi in mezzo.
+ *
+ * Formato del file (.replay):
+ *   intestazione non compressa: Magic, Version, dimensione originale e compressa del corpo;
+ *   corpo compresso (Zlib): seed, griglia, ostacoli, log dei comandi, keyframe.
+ */
+class PAASCHIFANOFRANCESCO_API FMatchReplay
+{
+public:
+	static constexpr uint32 Magic = 0x52414150; // "PAAR"
+	static constexpr uint16 CurrentVersion = 1;
+
+	/** Un keyframe ogni KeyframeInterval turni */
+	static constexpr int32 KeyframeInterval = 4;
+
+	/** Costruisce il replay dal log di una partita e calcola i keyframe */
+	void Build(int32 InSeed, const TBitArray<>& InObstacles, const FMatchCommandLog& InCommandLog);
+
+	/** Non const: lettura e scrittura condividono SerializeBody (in scrittura lo stato non cambia) */
+	bool SaveToFile(const FString& Filename);
+	bool LoadFromFile(const FString& Filename);
+
+	/**
+	 * Ricostruisce la board all'inizio del turno indicato.
+	 * OutCommandIndex è il primo comando del turno (Num() del log se la partita è finita prima).
+	 */
+	bool Seek(int32 Turn, FSimBoard& OutBoard, int32& OutCommandIndex) const;
+
+	/** Applica un comando alla board (stesse regole della partita: occupazioni, danni, morti) */
+	static void ApplyCommand(FSimBoard& Board, const FMatchCommand& Command);
+
+	int32 GetSeed() const { return Seed; }
+	int32 GetNumTurns() const { return NumTurns; }
+	const FMatchCommandLog& GetCommandLog() const { return CommandLog; }
+	const TArray<FReplayKeyframe>& GetKeyframes() const { return Keyframes; }
+
+	/** Percorso di default del replay di una partita (Saved/Replays) */
+	static FString MakeReplayFilename(int32 InSeed);
+
+private:
+	/** Board vuota con dimensioni e ostacoli della partita */
+	void InitBoard(FSimBoard& OutBoard) const;
+
+	/** Serializza il corpo (seed, griglia, ostacoli, log, keyframe) */
+	void SerializeBody(FArchive& Ar);
+
+	int32 Seed = 0;
+	int32 NumTurns = 0;
+	TBitArray<> Obstacles;
+	FMatchCommandLog CommandLog;
+	TArray<FReplayKeyframe> Keyframes;
+};
@@ -0,0 +1,189 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "MatchSnapshot.h"
+#include "PAASchifanoFrancesco/Core/TurnManager.h"
+#include "PAASchifanoFrancesco/Grid/GridManager.h"
+#include "PAASchifanoFrancesco/Grid/Tile.h"
+#include "PAASchifanoFrancesco/Units/UnitBase.h"
+#include "SimBoard.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+/**
+ * Descrizione:
+ * Copia lo stato necessario a riprendere la partita. Le unità sono salvate nell'ordine del registro
+ * del GameMode, perché l'IA processa le proprie unità in quell'ordine.
+ */
+bool FMatchSnapshot::Capture(AMyGameMode* GameMode, FMatchSnapshot& OutSnapshot)
+{
+	AGridManager* GridManager = GameMode ? GameMode->GetGridManager() : nullptr;
+	UTurnManager* TurnManager = GameMode ? GameMode->GetTurnManager() : nullptr;
+	if (!GridManager || !TurnManager) return false;
+
+	const FMatchRandom& Random = GameMode->GetMatchRandom();
+	OutSnapshot.Seed = Random.Seed;
+	OutSnapshot.MapState = Random.Map.GetCurrentSeed();
+	OutSnapshot.AIState = Random.AI.GetCurrentSeed();
+	OutSnapshot.CombatState = Random.Combat.GetCurrentSeed();
+
+	OutSnapshot.Phase = GameMode->GetCurrentGamePhase();
+	OutSnapshot.CurrentPlayer = TurnManager->GetCurrentPlayer();
+	OutSnapshot.StartingPlayer = GameMode->GetCoinFlipResult();
+	OutSnapshot.CurrentTeam = static_cast<uint8>(TurnManager->GetCurrentTeam());
+	OutSnapshot.NumTeams = static_cast<uint8>(GameMode->GetUnitRegistry().GetNumTeams());
+	OutSnapshot.AILevel = GameMode->AILevel;
+
+	const TArray<ATile*>& Tiles = GridManager->GetGridTiles();
+	OutSnapshot.Obstacles.Init(false, Tiles.Num());
+	for (int32 Index = 0; Index < Tiles.Num(); ++Index)
+	{
+		OutSnapshot.Obstacles[Index] = Tiles[Index] && Tiles[Index]->IsObstacle();
+	}
+
+	OutSnapshot.Units.Reset();
+	auto AddUnits = [&OutSnapshot, GridManager](TConstArrayView<AUnitBase*> Units)
+	{
+		for (const AUnitBase* Unit : Units)
+		{
+			if (!IsValid(Unit) || Unit->IsDead()) continue;
+
+			FMatchSnapshotUnit& SavedUnit = OutSnapshot.Units.AddDefaulted_GetRef();
+			SavedUnit.TileIndex = GridManager->GetTileIndex(GridManager->FindTileAtLocation(Unit->GetActorLocation()));
+			SavedUnit.Health = Unit->CurrentHealth;
+			SavedUnit.bRanged = Unit->IsRangedAttack();
+			SavedUnit.bPlayer = Unit->IsPlayerControlled();
+			SavedUnit.Team = Unit->GetTeamID();
+			SavedUnit.Action = Unit->GetCurrentAction();
+		}
+	};
+	for (int32 Team = 0; Team < OutSnapshot.NumTeams; ++Team)
+	{
+		AddUnits(GameMode->GetUnitRegistry().GetUnits(Team));
+	}
+
+	OutSnapshot.CommandLog = GameMode->GetCommandLog();
+	return true;
+}
+
+void FMatchSnapshot::Serialize(FArchive& Ar, uint16 Version)
+{
+	Ar << Seed;
+	Ar << MapState;
+	Ar << AIState;
+	Ar << CombatState;
+	Ar << Phase;
+	Ar << CurrentPlayer;
+	Ar << StartingPlayer;
+	if (Version >= 2)
+	{
+		Ar << CurrentTeam;
+		Ar << NumTeams;
+	}
+	else
+	{
+		// Salvataggi a due fazioni: la squadra di turno coincide con il giocatore
+		CurrentTeam = CurrentPlayer == EPlayer::Player1 ? 0 : 1;
+		NumTeams = 2;
+	}
+	if (Ar.IsLoading() && (NumTeams < 2 || NumTeams > FSimBoard::MaxTeams || CurrentTeam >= NumTeams))
+	{
+		Ar.SetError();
+	}
+	Ar << AILevel;
+	Ar << Obstacles;
+
+	int32 NumUnits = Units.Num();
+	Ar << NumUnits;
+	if (Ar.IsLoading())
+	{
+		// Le unità vive occupano tile diverse e ognuna occupa UnitBytes byte: un conteggio oltre
+		// le tile della griglia o i byte rimasti è un file corrotto, non va allocato
+		constexpr int64 UnitBytes = sizeof(uint16) + 2 * sizeof(uint8) + sizeof(EUnitAction);
+		if (NumUnits < 0 || NumUnits > Obstacles.Num() || NumUnits * UnitBytes > Ar.TotalSize() - Ar.Tell())
+		{
+			Ar.SetError();
+			return;
+		}
+		Units.SetNum(NumUnits);
+	}
+
+	for (FMatchSnapshotUnit& Unit : Units)
+	{
+		// Tile a 16 bit, vita e flag a 8 bit: 5 byte per unità. La squadra occupa i bit 2-3 dei flag
+		// (a zero nei salvataggi della versione 1, cioè squadra predefinita)
+		uint16 Tile = static_cast<uint16>(Unit.TileIndex);
+		uint8 Health = static_cast<uint8>(FMath::Clamp(Unit.Health, 0, 255));
+		uint8 Flags = (Unit.bRanged ? 1 : 0) | (Unit.bPlayer ? 2 : 0) | (FSimBoard::EncodeTeamBits(Unit.bPlayer, Unit.Team) << 2);
+		Ar << Tile;
+		Ar << Health;
+		Ar << Flags;
+		Ar << Unit.Action;
+
+		Unit.TileIndex = Tile;
+		Unit.Health = Health;
+		Unit.bRanged = (Flags & 1) != 0;
+		Unit.bPlayer = (Flags & 2) != 0;
+		Unit.Team = FSimBoard::DecodeTeamBits(Unit.bPlayer, Flags >> 2);
+		if (Unit.Team == INDEX_NONE || Unit.Team >= NumTeams)
+		{
+			Ar.SetError();
+			Unit.Team = 0;
+		}
+	}
+
+	CommandLog.Serialize(Ar);
+}
+
+void FMatchSnapshot::Save(TArray<uint8>& OutBytes)
+{
+	OutBytes.Reset();
+	FMemoryWriter Writer(OutBytes);
+
+	uint32 FileMagic = Magic;
+	uint16 Version = CurrentVersion;
+	Writer << FileMagic;
+	Writer << Version;
+
+	Serialize(Writer, Version);
+}
+
+bool FMatchSnapshot::Load(const TArray<uint8>& Bytes)
+{
+	FMemoryReader Reader(Bytes);
+
+	uint32 FileMagic = 0;
+	uint16 Version = 0;
+	Reader << FileMagic;
+	Reader << Version;
+
+	if (FileMagic != Magic || Version == 0 || Version > CurrentVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Salvataggio non valido (versione %d, supportata fino a %d)"), Version, CurrentVersion);
+		return false;
+	}
+
+	Serialize(Reader, Version);
+	return !Reader.IsError();
+}
+
+FString FMatchSnapshot::GetSlotFilename(const FString& SlotName)
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SaveGames"), SlotName + TEXT(".match"));
+}
+
+UE::Tasks::FTask FMatchSnapshot::WriteAsync(TArray<uint8>&& Bytes, const FString& Filename, const UE::Tasks::FTask& Previous)
+{
+	return UE::Tasks::Launch(UE_SOURCE_LOCATION, [Bytes = MoveTemp(Bytes), Filename]()
+	{
+		const FString TempFilename = Filename + TEXT(".tmp");
+		if (!FFileHelper::SaveArrayToFile(Bytes, *TempFilename) || !IFileManager::Get().Move(*Filename, *TempFilename))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Salvataggio fallito: %s"), *Filename);
+			return;
+		}
+		UE_LOG(LogTemp, Log, TEXT("Partita salvata in %s (%d byte)"), *Filename, Bytes.Num());
+	}, UE::Tasks::Prerequisites(Previous));
+}
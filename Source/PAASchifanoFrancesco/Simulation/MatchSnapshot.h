@@ -0,0 +1,80 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PAASchifanoFrancesco/Core/MyGameMode.h"
+#include "MatchCommandLog.h"
+#include "Tasks/Task.h"
+
+/**
+ * Descrizione:
+ * Stato di un'unità nel salvataggio: pochi byte, le statistiche derivano dall'archetipo (FUnitArchetypeTable).
+ */
+struct FMatchSnapshotUnit
+{
+	int32 TileIndex = INDEX_NONE;
+	int32 Health = 0;
+	bool bRanged = false;
+	bool bPlayer = false;
+	int32 Team = 0;
+	EUnitAction Action = EUnitAction::Idle;
+};
+
+/**
+ * Classe: FMatchSnapshot
+ * Descrizione:
+ * Istantanea completa di una partita in corso: seed e stato degli stream casuali, fase,
+ * giocatore di turno, ostacoli (un bit per tile), unità e log dei comandi (history).
+ * La cattura avviene sul game thread in pochi microsecondi; la scrittura del file
+ * viene eseguita da un task in background (WriteAsync), così l'autosave non costa frame.
+ */
+struct PAASCHIFANOFRANCESCO_API FMatchSnapshot
+{
+	static constexpr uint32 Magic = 0x53414150; // "PAAS"
+	/** Versione 2: squadra di turno e squadra di ogni unità (partite con più squadre IA) */
+	static constexpr uint16 CurrentVersion = 2;
+
+	/** Seed della partita e stato corrente dei tre stream (FMatchRandom) */
+	int32 Seed = 0;
+	int32 MapState = 0;
+	int32 AIState = 0;
+	int32 CombatState = 0;
+
+	EGamePhase Phase = EGamePhase::EBattle;
+	EPlayer CurrentPlayer = EPlayer::Player1;
+	EPlayer StartingPlayer = EPlayer::Player1;
+	uint8 CurrentTeam = 0;
+	uint8 NumTeams = 2;
+	EAILevel AILevel = EAILevel::Hard;
+
+	/** Un bit per tile: 1 = ostacolo */
+	TBitArray<> Obstacles;
+
+	/** Unità squadra per squadra (il player per primo), nell'ordine del registro del GameMode */
+	TArray<FMatchSnapshotUnit> Units;
+
+	/** Comandi della partita fino al salvataggio (la history viene ricostruita da qui) */
+	FMatchCommandLog CommandLog;
+
+	/** Legge lo stato della partita dal GameMode (solo game thread) */
+	static bool Capture(AMyGameMode* GameMode, FMatchSnapshot& OutSnapshot);
+
+	/** Serializza intestazione e dati in un blob binario (non const: condivide Serialize con Load) */
+	void Save(TArray<uint8>& OutBytes);
+
+	/** Ricostruisce l'istantanea da un blob; false se il blob non è valido */
+	bool Load(const TArray<uint8>& Bytes);
+
+	/** File di uno slot di salvataggio (Saved/SaveGames/<Slot>.match) */
+	static FString GetSlotFilename(const FString& SlotName);
+
+	/**
+	 * Scrive il blob su un worker. La scrittura avviene su un file temporaneo poi rinominato,
+	 * così un salvataggio interrotto non corrompe lo slot. Previous serializza le scritture in coda.
+	 */
+	static UE::Tasks::FTask WriteAsync(TArray<uint8>&& Bytes, const FString& Filename, const UE::Tasks::FTask& Previous);
+
+private:
+	void Serialize(FArchive& Ar, uint16 Version);
+};
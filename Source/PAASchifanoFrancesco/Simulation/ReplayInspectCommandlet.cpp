@@ -0,0 +1,112 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "ReplayInspectCommandlet.h"
+#include "MatchReplay.h"
+
+UReplayInspectCommandlet::UReplayInspectCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+/**
+ * Stampa la board una riga per volta: '#' ostacolo, '.' libera,
+ * S/B unità del player, s/b unità dell'IA.
+ */
+static void PrintBoard(const FSimBoard& Board)
+{
+	for (int32 Row = 0; Row < Board.DimY; ++Row)
+	{
+		FString Line = FString::Printf(TEXT("%c "), static_cast<TCHAR>('A' + Row));
+		for (int32 Col = 0; Col < Board.DimX; ++Col)
+		{
+			const int32 TileIndex = Row * Board.DimX + Col;
+			const int32 UnitIndex = Board.Occupants[TileIndex];
+
+			TCHAR Symbol = Board.Obstacles[TileIndex] ? TEXT('#') : TEXT('.');
+			if (UnitIndex != INDEX_NONE)
+			{
+				const FSimUnit& Unit = Board.Units[UnitIndex];
+				Symbol = Unit.bRanged ? TEXT('S') : TEXT('B');
+				if (!Unit.bPlayer)
+				{
+					Symbol = FChar::ToLower(Symbol);
+				}
+			}
+			Line.AppendChar(Symbol);
+		}
+		UE_LOG(LogTemp, Display, TEXT("%s"), *Line);
+	}
+}
+
+/**
+ * Descrizione:
+ * 1. Carica il replay indicato
+ * 2. Ricostruisce la board all'inizio del turno (-Turn, default 0) tramite il keyframe più vicino
+ * 3. Stampa board, unità e comandi del turno (o dell'intera partita con -AllCommands)
+ */
+int32 UReplayInspectCommandlet::Main(const FString& Params)
+{
+	FString ReplayPath;
+	if (!FParse::Value(*Params, TEXT("Replay="), ReplayPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ReplayInspect: specificare -Replay=<file.replay>"));
+		return 1;
+	}
+
+	int32 Turn = 0;
+	FParse::Value(*Params, TEXT("Turn="), Turn);
+	const bool bAllCommands = FParse::Param(*Params, TEXT("AllCommands"));
+
+	FMatchReplay Replay;
+	if (!Replay.LoadFromFile(ReplayPath))
+	{
+		return 1;
+	}
+
+	const FMatchCommandLog& CommandLog = Replay.GetCommandLog();
+	UE_LOG(LogTemp, Display, TEXT("Replay %s: seed %d, griglia %dx%d, %d turni, %d comandi, %d keyframe"),
+		*ReplayPath, Replay.GetSeed(), CommandLog.GetDimX(), CommandLog.GetDimY(),
+		Replay.GetNumTurns(), CommandLog.Num(), Replay.GetKeyframes().Num());
+
+	Turn = FMath::Clamp(Turn, 0, Replay.GetNumTurns() - 1);
+
+	const double StartTime = FPlatformTime::Seconds();
+	FSimBoard Board;
+	int32 CommandIndex = 0;
+	if (!Replay.Seek(Turn, Board, CommandIndex))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ReplayInspect: impossibile raggiungere il turno %d"), Turn);
+		return 1;
+	}
+	const double SeekMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	UE_LOG(LogTemp, Display, TEXT("Inizio del turno %d (comando %d), ricostruito in %.3f ms:"), Turn, CommandIndex, SeekMs);
+	PrintBoard(Board);
+
+	for (const FSimUnit& Unit : Board.Units)
+	{
+		UE_LOG(LogTemp, Display, TEXT("  %s %s su %s: vita %d/%d"),
+			*FSimBoard::GetTeamName(Unit.Team), Unit.bRanged ? TEXT("Sniper") : TEXT("Brawler"),
+			*CommandLog.GetTileName(Unit.TileIndex), Unit.Health, Unit.MaxHealth);
+	}
+
+	// Comandi del turno (fino al prossimo EndTurn compreso) oppure l'intera partita
+	const int32 FirstCommand = bAllCommands ? 0 : CommandIndex;
+	FMatchCommand Command;
+	for (int32 Index = FirstCommand; Index < CommandLog.Num(); ++Index)
+	{
+		if (!CommandLog.Decode(Index, Command)) continue;
+
+		UE_LOG(LogTemp, Display, TEXT("  [%d] %s"), Index, *CommandLog.Format(Command));
+
+		if (!bAllCommands && Command.Type == EMatchCommand::EndTurn)
+		{
+			break;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,28 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ReplayInspectCommandlet.generated.h"
+
+/**
+ * Classe: UReplayInspectCommandlet
+ * Descrizione:
+ * Ispezione di un replay (FMatchReplay) senza aprire la partita: stampa intestazione e keyframe,
+ * ricostruisce la board all'inizio del turno richiesto e ne elenca unità e comandi.
+ *
+ * Utilizzo:
+ *   UnrealEditor-Cmd PAASchifanoFrancesco.uproject -run=ReplayInspect -Replay=<file.replay>
+ *   [-Turn=<turno>] [-AllCommands]
+ */
+UCLASS()
+class PAASCHIFANOFRANCESCO_API UReplayInspectCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UReplayInspectCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
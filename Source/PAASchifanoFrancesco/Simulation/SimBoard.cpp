@@ -0,0 +1,428 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "SimBoard.h"
+#include "PAASchifanoFrancesco/Core/MyGameMode.h"
+#include "PAASchifanoFrancesco/Grid/GridManager.h"
+#include "PAASchifanoFrancesco/Grid/Tile.h"
+#include "PAASchifanoFrancesco/Units/UnitBase.h"
+#include "PAASchifanoFrancesco/Units/UnitArchetypes.h"
+#include "Algo/Reverse.h"
+
+/**
+ * Descrizione:
+ * Copia i dati di gioco di un attore. Lo stato del turno viene dall'azione corrente:
+ * un'unità non più Idle ha mosso, un'unità che non può agire ha anche attaccato.
+ */
+FSimUnit FSimUnit::FromActor(AUnitBase* Unit)
+{
+	FSimUnit SimUnit;
+	SimUnit.UnitId = Unit->GetUniqueID();
+	SimUnit.Health = Unit->CurrentHealth;
+	SimUnit.MaxHealth = Unit->MaxHealth;
+	SimUnit.MovementRange = Unit->GetMovementRange();
+	SimUnit.AttackRange = Unit->GetAttackRange();
+	SimUnit.MinDamage = Unit->MinDamage;
+	SimUnit.MaxDamage = Unit->MaxDamage;
+	SimUnit.Archetype = static_cast<uint8>(Unit->GetArchetype());
+	SimUnit.bRanged = Unit->IsRangedAttack();
+	SimUnit.bPlayer = Unit->IsPlayerControlled();
+	SimUnit.Team = static_cast<uint8>(Unit->GetTeamID());
+	SimUnit.bHasMoved = Unit->GetCurrentAction() != EUnitAction::Idle;
+	SimUnit.bHasAttacked = !Unit->CanAct();
+	SimUnit.Actor = Unit;
+	return SimUnit;
+}
+
+FSimUnit FSimUnit::FromArchetype(int32 ArchetypeIndex, int32 Team)
+{
+	const FUnitArchetype& Stats = FUnitArchetypeTable::Get()[ArchetypeIndex];
+
+	FSimUnit SimUnit;
+	SimUnit.Health = Stats.MaxHealth;
+	SimUnit.MaxHealth = Stats.MaxHealth;
+	SimUnit.MovementRange = Stats.MovementRange;
+	SimUnit.AttackRange = Stats.AttackRange;
+	SimUnit.MinDamage = Stats.MinDamage;
+	SimUnit.MaxDamage = Stats.MaxDamage;
+	SimUnit.Archetype = static_cast<uint8>(ArchetypeIndex);
+	SimUnit.bRanged = Stats.bRanged;
+	SimUnit.bPlayer = Team == 0;
+	SimUnit.Team = static_cast<uint8>(Team);
+	return SimUnit;
+}
+
+/**
+ * Descrizione:
+ * Crea una board partendo dallo stato attuale della scena.
+ * Le unità del player vengono aggiunte per prime e poi quelle dell'IA, nello stesso ordine
+ * delle liste del GameMode: in questo modo le scelte "prima unità trovata" coincidono con il gioco reale.
+ */
+FSimBoard FSimBoard::FromWorld(AMyGameMode* GameMode)
+{
+	FSimBoard Board;
+
+	AGridManager* GridManager = GameMode ? GameMode->GetGridManager() : nullptr;
+	if (!GridManager)
+	{
+		UE_LOG(LogTemp, Error, TEXT("FSimBoard::FromWorld: GridManager non disponibile"));
+		return Board;
+	}
+
+	Board.Init(GridManager->GetGridDimX(), GridManager->GetGridDimY());
+
+	// Copia gli ostacoli dalla griglia reale
+	const TArray<ATile*>& Tiles = GridManager->GetGridTiles();
+	for (int32 Index = 0; Index < Tiles.Num() && Index < Board.NumTiles(); ++Index)
+	{
+		Board.Obstacles[Index] = Tiles[Index] && Tiles[Index]->IsObstacle();
+	}
+
+	// Copia le unità squadra per squadra (prima il player): le statistiche arrivano dalle colonne
+	// del registro, dall'attore solo la posizione e lo stato del turno
+	static_assert(FUnitRegistry::MaxTeams == FSimBoard::MaxTeams, "Registro e board devono ammettere le stesse squadre");
+	const FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+	for (int32 Team = 0; Team < Registry.GetNumTeams(); ++Team)
+	{
+		const FUnitRegistry::FColumns& Columns = Registry.GetColumns(Team);
+		for (int32 Index = 0; Index < Columns.Num(); ++Index)
+		{
+			AUnitBase* Unit = Columns.Actors[Index];
+			if (!IsValid(Unit) || Columns.Health[Index] <= 0) continue;
+
+			FSimUnit SimUnit;
+			SimUnit.UnitId = Unit->GetUniqueID();
+			SimUnit.TileIndex = GridManager->GetTileIndex(GridManager->FindTileAtLocation(Unit->GetActorLocation()));
+			SimUnit.Health = Columns.Health[Index];
+			SimUnit.MaxHealth = Columns.MaxHealth[Index];
+			SimUnit.MovementRange = Columns.MovementRange[Index];
+			SimUnit.AttackRange = Columns.AttackRange[Index];
+			SimUnit.MinDamage = Columns.MinDamage[Index];
+			SimUnit.MaxDamage = Columns.MaxDamage[Index];
+			SimUnit.Archetype = static_cast<uint8>(Unit->GetArchetype());
+			SimUnit.bRanged = Columns.Ranged[Index];
+			SimUnit.bPlayer = Team == FUnitRegistry::PlayerTeam;
+			SimUnit.Team = static_cast<uint8>(Team);
+			SimUnit.bHasMoved = Unit->GetCurrentAction() != EUnitAction::Idle;
+			SimUnit.bHasAttacked = !Unit->CanAct();
+			SimUnit.Actor = Unit;
+
+			if (Board.IsValidTile(SimUnit.TileIndex))
+			{
+				Board.AddUnit(SimUnit);
+			}
+		}
+	}
+
+	return Board;
+}
+
+/**
+ * Inizializza una griglia vuota DimX x DimY senza ostacoli e senza unità.
+ */
+void FSimBoard::Init(int32 InDimX, int32 InDimY)
+{
+	DimX = InDimX;
+	DimY = InDimY;
+	Obstacles.Init(false, NumTiles());
+	Occupants.Init(INDEX_NONE, NumTiles());
+	Units.Reset();
+
+	UnitTiles.Init(false, NumTiles());
+	for (TBitArray<>& Tiles : TeamTiles)
+	{
+		Tiles.Init(false, NumTiles());
+	}
+}
+
+/**
+ * Aggiunge un'unità alla board e segna la tile come occupata.
+ */
+int32 FSimBoard::AddUnit(const FSimUnit& Unit)
+{
+	const int32 Index = Units.Add(Unit);
+	if (IsValidTile(Unit.TileIndex) && Unit.IsAlive())
+	{
+		Occupants[Unit.TileIndex] = Index;
+		UnitTiles[Unit.TileIndex] = true;
+		TeamTiles[Unit.Team][Unit.TileIndex] = true;
+	}
+	return Index;
+}
+
+bool FSimBoard::IsFree(int32 TileIndex) const
+{
+	return IsValidTile(TileIndex) && !Obstacles[TileIndex] && Occupants[TileIndex] == INDEX_NONE;
+}
+
+/**
+ * Restituisce le tile adiacenti (giù, su, destra, sinistra).
+ * L'ordine è lo stesso di AGridManager::GetNeighbors così che le BFS producano gli stessi percorsi.
+ */
+int32 FSimBoard::GetNeighbors(int32 TileIndex, int32 OutNeighbors[4]) const
+{
+	const int32 Row = GetRow(TileIndex);
+	const int32 Col = GetColumn(TileIndex);
+	int32 Count = 0;
+
+	if (Row + 1 < DimY) OutNeighbors[Count++] = (Row + 1) * DimX + Col; // In basso
+	if (Row - 1 >= 0)   OutNeighbors[Count++] = (Row - 1) * DimX + Col; // In alto
+	if (Col + 1 < DimX) OutNeighbors[Count++] = Row * DimX + (Col + 1); // A destra
+	if (Col - 1 >= 0)   OutNeighbors[Count++] = Row * DimX + (Col - 1); // A sinistra
+
+	return Count;
+}
+
+int32 FSimBoard::DistanceSquared(int32 TileA, int32 TileB) const
+{
+	const int32 DX = GetColumn(TileA) - GetColumn(TileB);
+	const int32 DY = GetRow(TileA) - GetRow(TileB);
+	return DX * DX + DY * DY;
+}
+
+/**
+ * BFS limitata al range di movimento: stessa logica di AGridManager::GetValidMovementTiles.
+ * Ostacoli e tile occupate non sono attraversabili.
+ */
+void FSimBoard::GetReachableTiles(int32 UnitIndex, TArray<int32>& OutTiles) const
+{
+	OutTiles.Reset();
+	if (!Units.IsValidIndex(UnitIndex)) return;
+
+	const FSimUnit& Unit = Units[UnitIndex];
+	if (!IsValidTile(Unit.TileIndex)) return;
+
+	TArray<int32> Distance;
+	Distance.Init(INDEX_NONE, NumTiles());
+
+	TArray<int32> Queue;
+	Queue.Reserve(64);
+	Queue.Add(Unit.TileIndex);
+	Distance[Unit.TileIndex] = 0;
+
+	for (int32 Head = 0; Head < Queue.Num(); ++Head)
+	{
+		const int32 Current = Queue[Head];
+		if (Distance[Current] >= Unit.MovementRange) continue;
+
+		int32 Neighbors[4];
+		const int32 Count = GetNeighbors(Current, Neighbors);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const int32 Next = Neighbors[i];
+			if (Distance[Next] != INDEX_NONE || !IsFree(Next)) continue;
+
+			Distance[Next] = Distance[Current] + 1;
+			Queue.Add(Next);
+			OutTiles.Add(Next);
+		}
+	}
+}
+
+/**
+ * BFS senza limite di passi: stessa logica di AGridManager::GetPathToTile.
+ * La destinazione è ammessa anche se occupata (serve per camminare verso un nemico).
+ */
+bool FSimBoard::FindPath(int32 FromTile, int32 ToTile, TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+	if (!IsValidTile(FromTile) || !IsValidTile(ToTile)) return false;
+
+	TArray<int32> CameFrom;
+	CameFrom.Init(INDEX_NONE, NumTiles());
+
+	TBitArray<> Visited(false, NumTiles());
+	TArray<int32> Queue;
+	Queue.Reserve(NumTiles());
+	Queue.Add(FromTile);
+	Visited[FromTile] = true;
+
+	bool bPathFound = false;
+	for (int32 Head = 0; Head < Queue.Num(); ++Head)
+	{
+		const int32 Current = Queue[Head];
+		if (Current == ToTile)
+		{
+			bPathFound = true;
+			break;
+		}
+
+		int32 Neighbors[4];
+		const int32 Count = GetNeighbors(Current, Neighbors);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const int32 Next = Neighbors[i];
+			const bool bIsOccupied = Occupants[Next] != INDEX_NONE;
+			if (Visited[Next] || Obstacles[Next] || (bIsOccupied && Next != ToTile)) continue;
+
+			Visited[Next] = true;
+			CameFrom[Next] = Current;
+			Queue.Add(Next);
+		}
+	}
+
+	if (!bPathFound) return false;
+
+	// Ricostruisce il percorso andando a ritroso
+	for (int32 Current = ToTile; Current != FromTile && Current != INDEX_NONE; Current = CameFrom[Current])
+	{
+		OutPath.Add(Current);
+	}
+	Algo::Reverse(OutPath);
+	return true;
+}
+
+/**
+ * Il raggio d'attacco è euclideo (come in AGridManager::GetValidAttackTiles, che confronta
+ * la distanza 2D con AttackRange * dimensione cella).
+ */
+bool FSimBoard::CanAttackFrom(int32 AttackerIndex, int32 FromTile, int32 TargetIndex) const
+{
+	if (!Units.IsValidIndex(AttackerIndex) || !Units.IsValidIndex(TargetIndex)) return false;
+
+	const FSimUnit& Attacker = Units[AttackerIndex];
+	const FSimUnit& Target = Units[TargetIndex];
+	if (!Attacker.IsAlive() || !Target.IsAlive() || !IsValidTile(Target.TileIndex) || !IsEnemyTile(Attacker.Team, Target.TileIndex)) return false;
+
+	return DistanceSquared(FromTile, Target.TileIndex) <= Attacker.AttackRange * Attacker.AttackRange;
+}
+
+int32 FSimBoard::FindFirstAttackable(int32 AttackerIndex) const
+{
+	if (!Units.IsValidIndex(AttackerIndex)) return INDEX_NONE;
+
+	// Solo i nemici (bitset della squadra), visitati in ordine di indice come la lista del BattleManager
+	TArray<int32, TInlineAllocator<16>> Enemies;
+	GetEnemyUnits(Units[AttackerIndex].Team, Enemies);
+
+	const int32 FromTile = Units[AttackerIndex].TileIndex;
+	for (int32 Index : Enemies)
+	{
+		if (CanAttackFrom(AttackerIndex, FromTile, Index))
+		{
+			return Index;
+		}
+	}
+	return INDEX_NONE;
+}
+
+int32 FSimBoard::FindNearestEnemy(int32 UnitIndex) const
+{
+	if (!Units.IsValidIndex(UnitIndex)) return INDEX_NONE;
+
+	const FSimUnit& Unit = Units[UnitIndex];
+	TArray<int32, TInlineAllocator<16>> Enemies;
+	GetEnemyUnits(Unit.Team, Enemies);
+
+	int32 Nearest = INDEX_NONE;
+	int32 MinDistance = MAX_int32;
+	for (int32 Index : Enemies)
+	{
+		const int32 Distance = DistanceSquared(Unit.TileIndex, Units[Index].TileIndex);
+		if (Distance < MinDistance)
+		{
+			MinDistance = Distance;
+			Nearest = Index;
+		}
+	}
+	return Nearest;
+}
+
+int32 FSimBoard::FindUnitByActor(const AUnitBase* Actor) const
+{
+	// Un attore nullo coinciderebbe con i puntatori deboli scaduti
+	if (!Actor) return INDEX_NONE;
+
+	return Units.IndexOfByPredicate([Actor](const FSimUnit& Unit) { return Unit.Actor.Get() == Actor; });
+}
+
+void FSimBoard::MoveUnit(int32 UnitIndex, int32 ToTile)
+{
+	if (!Units.IsValidIndex(UnitIndex) || !IsValidTile(ToTile)) return;
+
+	FSimUnit& Unit = Units[UnitIndex];
+	if (IsValidTile(Unit.TileIndex) && Occupants[Unit.TileIndex] == UnitIndex)
+	{
+		Occupants[Unit.TileIndex] = INDEX_NONE;
+		UnitTiles[Unit.TileIndex] = false;
+		TeamTiles[Unit.Team][Unit.TileIndex] = false;
+	}
+
+	Unit.TileIndex = ToTile;
+	Unit.bHasMoved = true;
+	Occupants[ToTile] = UnitIndex;
+	UnitTiles[ToTile] = true;
+	TeamTiles[Unit.Team][ToTile] = true;
+}
+
+void FSimBoard::ApplyDamage(int32 UnitIndex, int32 Damage)
+{
+	if (!Units.IsValidIndex(UnitIndex)) return;
+
+	FSimUnit& Unit = Units[UnitIndex];
+	Unit.Health = FMath::Max(0, Unit.Health - Damage);
+
+	// Un'unità morta libera la propria tile
+	if (!Unit.IsAlive() && IsValidTile(Unit.TileIndex) && Occupants[Unit.TileIndex] == UnitIndex)
+	{
+		Occupants[Unit.TileIndex] = INDEX_NONE;
+		UnitTiles[Unit.TileIndex] = false;
+		TeamTiles[Unit.Team][Unit.TileIndex] = false;
+	}
+}
+
+FString FSimBoard::GetTeamName(int32 Team)
+{
+	if (Team == 0) return TEXT("Player");
+	if (Team == 1) return TEXT("AI");
+	return FString::Printf(TEXT("AI %d"), Team);
+}
+
+uint32 FSimBoard::GetAliveTeamsMask() const
+{
+	uint32 Mask = 0;
+	for (int32 Team = 0; Team < MaxTeams; ++Team)
+	{
+		if (TeamTiles[Team].Find(true) != INDEX_NONE)
+		{
+			Mask |= 1u << Team;
+		}
+	}
+	return Mask;
+}
+
+/**
+ * Le tile di una squadra sono un sottoinsieme di quelle occupate, quindi lo XOR
+ * lascia esattamente le tile dei nemici: una sola passata a parole di 32 bit.
+ */
+void FSimBoard::GetEnemyTiles(int32 Team, TBitArray<>& OutTiles) const
+{
+	OutTiles = UnitTiles;
+	OutTiles.CombineWithBitwiseXOR(TeamTiles[Team], EBitwiseOperatorFlags::MaintainSize);
+}
+
+uint32 FSimBoard::ComputePositionHash() const
+{
+	uint32 Hash = GetTypeHash(NumTiles());
+	for (const FSimUnit& Unit : Units)
+	{
+		if (!Unit.IsAlive()) continue;
+		Hash = HashCombine(Hash, GetTypeHash(Unit.UnitId));
+		Hash = HashCombine(Hash, GetTypeHash(Unit.TileIndex));
+	}
+	return Hash;
+}
+
+uint32 FSimBoard::ComputeStateChecksum() const
+{
+	// Le unità vive vengono visitate in ordine di tile: board con le stesse unità in ordine diverso
+	// (mondo in ordine di registro, replay in ordine di piazzamento) hanno lo stesso checksum
+	uint32 Checksum = GetTypeHash(NumTiles());
+	for (TConstSetBitIterator<> It(UnitTiles); It; ++It)
+	{
+		const FSimUnit& Unit = Units[Occupants[It.GetIndex()]];
+		const uint32 Packed = (static_cast<uint32>(Unit.TileIndex) << 16) | (static_cast<uint32>(Unit.Health & 0xFF) << 8)
+			| (static_cast<uint32>(Unit.Team) << 2) | (Unit.bPlayer ? 2u : 0u) | (Unit.bRanged ? 1u : 0u);
+		Checksum = HashCombine(Checksum, Packed);
+	}
+	return Checksum;
+}
@@ -0,0 +1,192 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Forward declarations per evitare dipendenze dagli attori
+class AMyGameMode;
+class AUnitBase;
+
+/**
+ * Descrizione:
+ * Copia compatta di un'unità usata dalla simulazione (IA, pondering, partite headless).
+ * Contiene solo i dati necessari alle regole di gioco. Il puntatore debole all'attore
+ * serve esclusivamente a tradurre un piano simulato nelle azioni reali della partita.
+ */
+struct FSimUnit
+{
+	/** Identificativo stabile dell'unità (usato per confrontare stati diversi) */
+	int32 UnitId = INDEX_NONE;
+
+	/** Tile occupata (indice Riga * DimX + Colonna) */
+	int32 TileIndex = INDEX_NONE;
+
+	/** Statistiche di combattimento */
+	int32 Health = 0;
+	int32 MaxHealth = 0;
+	int32 MovementRange = 0;
+	int32 AttackRange = 0;
+	int32 MinDamage = 0;
+	int32 MaxDamage = 0;
+
+	/** Indice dell'archetipo in FUnitArchetypeTable (regole e danno del contrattacco) */
+	uint8 Archetype = 0;
+
+	/** true per lo Sniper (attacco a distanza) */
+	bool bRanged = false;
+
+	/** true se l'unità appartiene al giocatore umano */
+	bool bPlayer = false;
+
+	/** Squadra (0 = Player1, 1 = AI; con più squadre le successive sono fazioni IA) */
+	uint8 Team = 0;
+
+	/** Stato del turno: ha già mosso / ha già attaccato */
+	bool bHasMoved = false;
+	bool bHasAttacked = false;
+
+	/** Attore corrispondente (nullo nelle partite simulate senza mondo) */
+	TWeakObjectPtr<AUnitBase> Actor;
+
+	bool IsAlive() const { return Health > 0; }
+
+	/** Copia statistiche, fazione e stato del turno di un attore (TileIndex resta da assegnare) */
+	static FSimUnit FromActor(AUnitBase* Unit);
+
+	/** Unità a vita piena con le statistiche dell'archetipo indicato (UnitId e TileIndex restano da assegnare) */
+	static FSimUnit FromArchetype(int32 ArchetypeIndex, int32 Team);
+};
+
+/**
+ * Descrizione:
+ * Rappresentazione della griglia e delle unità indipendente dagli attori.
+ * Replica le stesse regole di AGridManager (BFS di movimento, percorso, raggio d'attacco)
+ * lavorando su indici interi, così può essere copiata ed esplorata dall'IA senza toccare la scena.
+ */
+struct FSimBoard
+{
+	/** Numero massimo di squadre in una partita */
+	static constexpr int32 MaxTeams = 4;
+
+	/** Squadra predefinita delle partite a due fazioni */
+	static int32 GetDefaultTeam(bool bPlayer) { return bPlayer ? 0 : 1; }
+
+	/**
+	 * Squadra in 2 bit per i formati binari (log, replay, salvataggi). Il player è sempre la squadra 0,
+	 * quindi per le altre si salva Team - 1: i dati a due fazioni scritti prima delle squadre restano validi.
+	 */
+	static uint8 EncodeTeamBits(bool bPlayer, int32 Team) { return bPlayer ? 0 : static_cast<uint8>(FMath::Clamp(Team - 1, 0, 3)); }
+	static int32 DecodeTeamBits(bool bPlayer, uint8 Bits)
+	{
+		// I byte arrivano da file e dalla rete: una squadra oltre MaxTeams non è valida
+		const int32 Team = bPlayer ? 0 : 1 + (Bits & 3);
+		return Team < MaxTeams ? Team : INDEX_NONE;
+	}
+
+	/** Nome della squadra nei testi ("Player", "AI", "AI 2", ...) */
+	static FString GetTeamName(int32 Team);
+
+	/** Dimensioni della griglia */
+	int32 DimX = 0;
+	int32 DimY = 0;
+
+	/** Un bit per tile: 1 = ostacolo */
+	TBitArray<> Obstacles;
+
+	/** Per ogni tile, indice in Units dell'unità che la occupa (INDEX_NONE se libera) */
+	TArray<int32> Occupants;
+
+	/** Tutte le unità (le unità morte restano nell'array con Health = 0) */
+	TArray<FSimUnit> Units;
+
+	/**
+	 * Un bit per tile occupata da un'unità viva: in totale e per squadra.
+	 * Le query per squadra sono operazioni sui bitset, il loro costo non cresce con il numero di squadre.
+	 */
+	TBitArray<> UnitTiles;
+	TBitArray<> TeamTiles[MaxTeams];
+
+	/** Costruisce la board leggendo GridManager e liste di unità del GameMode */
+	static FSimBoard FromWorld(AMyGameMode* GameMode);
+
+	/** Inizializza una griglia vuota senza ostacoli */
+	void Init(int32 InDimX, int32 InDimY);
+
+	/** Aggiunge un'unità e occupa la sua tile. Restituisce l'indice assegnato */
+	int32 AddUnit(const FSimUnit& Unit);
+
+	int32 NumTiles() const { return DimX * DimY; }
+	int32 GetColumn(int32 TileIndex) const { return TileIndex % DimX; }
+	int32 GetRow(int32 TileIndex) const { return TileIndex / DimX; }
+	bool IsValidTile(int32 TileIndex) const { return TileIndex >= 0 && TileIndex < NumTiles(); }
+
+	/** true se la tile non è un ostacolo e non è occupata */
+	bool IsFree(int32 TileIndex) const;
+
+	/** Riempie le tile adiacenti nello stesso ordine di AGridManager::GetNeighbors (giù, su, destra, sinistra) */
+	int32 GetNeighbors(int32 TileIndex, int32 OutNeighbors[4]) const;
+
+	/** Distanza euclidea al quadrato fra due tile, in celle */
+	int32 DistanceSquared(int32 TileA, int32 TileB) const;
+
+	/** Tile raggiungibili entro il range di movimento (esclusa la tile di partenza) */
+	void GetReachableTiles(int32 UnitIndex, TArray<int32>& OutTiles) const;
+
+	/** Percorso BFS dalla tile From alla tile To (esclusa la partenza), come AGridManager::GetPathToTile */
+	bool FindPath(int32 FromTile, int32 ToTile, TArray<int32>& OutPath) const;
+
+	/** true se l'attaccante, posizionato su FromTile, ha il bersaglio entro il raggio d'attacco */
+	bool CanAttackFrom(int32 AttackerIndex, int32 FromTile, int32 TargetIndex) const;
+
+	/** Primo nemico attaccabile dalla posizione attuale (stesso ordine di TryAIAttack) */
+	int32 FindFirstAttackable(int32 AttackerIndex) const;
+
+	/** Nemico più vicino in linea d'aria (come ABattleManager::FindNearestEnemy) */
+	int32 FindNearestEnemy(int32 UnitIndex) const;
+
+	/** Sposta un'unità aggiornando le occupazioni */
+	void MoveUnit(int32 UnitIndex, int32 ToTile);
+
+	/** Applica un danno; se l'unità muore libera la tile */
+	void ApplyDamage(int32 UnitIndex, int32 Damage);
+
+	/** Un bit per ogni squadra che ha ancora unità vive */
+	uint32 GetAliveTeamsMask() const;
+
+	/** true se la tile è occupata da un nemico della squadra */
+	bool IsEnemyTile(int32 Team, int32 TileIndex) const { return UnitTiles[TileIndex] && !TeamTiles[Team][TileIndex]; }
+
+	/** Tile occupate dai nemici della squadra: tutte le unità meno quelle della squadra */
+	void GetEnemyTiles(int32 Team, TBitArray<>& OutTiles) const;
+
+	/** Indici delle unità nemiche vive della squadra, in ordine crescente (lo stesso ordine di Units) */
+	template <typename AllocatorType>
+	void GetEnemyUnits(int32 Team, TArray<int32, AllocatorType>& OutUnits) const
+	{
+		TBitArray<> EnemyTiles;
+		GetEnemyTiles(Team, EnemyTiles);
+
+		OutUnits.Reset();
+		for (TConstSetBitIterator<> It(EnemyTiles); It; ++It)
+		{
+			OutUnits.Add(Occupants[It.GetIndex()]);
+		}
+		OutUnits.Sort();
+	}
+
+	/** Indice dell'unità corrispondente all'attore, INDEX_NONE se non è sulla board */
+	int32 FindUnitByActor(const AUnitBase* Actor) const;
+
+	/**
+	 * Hash delle posizioni delle unità vive.
+	 * Non include la vita: le scelte dell'IA Hard dipendono solo da posizioni e unità presenti.
+	 */
+	uint32 ComputePositionHash() const;
+
+	/**
+	 * Checksum dello stato di gioco (posizioni, vita e fazione delle unità vive).
+	 * Indipendente da UnitId e attori: due peer che applicano gli stessi comandi ottengono lo stesso valore.
+	 */
+	uint32 ComputeStateChecksum() const;
+};
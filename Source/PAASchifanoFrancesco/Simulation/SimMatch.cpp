@@ -0,0 +1,265 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "SimMatch.h"
+#include "PAASchifanoFrancesco/AI/AIPlanner.h"
+#include "CombatResolver.h"
+#include "PAASchifanoFrancesco/Units/UnitArchetypes.h"
+
+FSimMatch::FSimMatch(const FSimMatchConfig& InConfig)
+	: Config(InConfig)
+{
+	Random.Initialize(InConfig.Seed);
+}
+
+/**
+ * Descrizione:
+ * Esegue in sequenza le stesse fasi del GameMode: ostacoli, coin flip, piazzamento e battaglia.
+ * Mappa e lancio della moneta usano lo stream Map nello stesso ordine del GameMode,
+ * quindi con lo stesso seed (-MatchSeed) la mappa coincide con quella della partita reale.
+ */
+FSimMatchResult FSimMatch::Play()
+{
+	Result = FSimMatchResult();
+	Board.Init(Config.DimX, Config.DimY);
+	CommandLog.Reset(Config.DimX, Config.DimY);
+
+	GenerateObstacles();
+	FlipCoin();
+	PlaceUnits();
+	PlayBattle();
+
+	return Result;
+}
+
+void FSimMatch::FlipCoin()
+{
+	Result.StartingPlayer = Random.Map.RandRange(0, 1) == 0 ? EPlayer::Player1 : EPlayer::AI;
+}
+
+/**
+ * Descrizione:
+ * Tutte le tile partono come ostacolo; la DFS dalla tile 0 le libera finché
+ * il numero di ostacoli rimasti non scende alla percentuale sorteggiata (30% - 95%).
+ */
+void FSimMatch::GenerateObstacles()
+{
+	for (int32 TileIndex = 0; TileIndex < Board.NumTiles(); ++TileIndex)
+	{
+		Board.Obstacles[TileIndex] = true;
+	}
+
+	const float ObstaclePercentage = Random.Map.FRandRange(0.3f, 0.95f);
+	const int32 TotalObstacles = FMath::RoundToInt(Board.NumTiles() * ObstaclePercentage);
+
+	TBitArray<> Visited(false, Board.NumTiles());
+	int32 VisitedCount = 0;
+	if (Board.NumTiles() > 0)
+	{
+		DFS(0, Visited, VisitedCount, TotalObstacles);
+	}
+}
+
+void FSimMatch::DFS(int32 TileIndex, TBitArray<>& Visited, int32& VisitedCount, int32 MaxObstacles)
+{
+	// Condizione di terminazione: tile già visitata o abbastanza celle libere
+	if (Visited[TileIndex] || Board.NumTiles() - VisitedCount <= MaxObstacles)
+	{
+		return;
+	}
+
+	Visited[TileIndex] = true;
+	++VisitedCount;
+	Board.Obstacles[TileIndex] = false;
+
+	int32 Neighbors[4];
+	const int32 Count = Board.GetNeighbors(TileIndex, Neighbors);
+
+	// Mischia l'ordine dei vicini per rendere la DFS casuale
+	for (int32 i = Count - 1; i > 0; --i)
+	{
+		Swap(Neighbors[i], Neighbors[Random.Map.RandRange(0, i)]);
+	}
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		DFS(Neighbors[i], Visited, VisitedCount, MaxObstacles);
+	}
+}
+
+/**
+ * Descrizione:
+ * Come in RegisterPlacementMove, le squadre si alternano partendo da chi ha vinto il coin flip
+ * (se vince l'IA parte la squadra 1). Ogni squadra piazza Sniper e Brawler alternati su tile libere casuali (logica di PlaceAIPawn),
+ * fino a UnitsPerSide unità.
+ */
+void FSimMatch::PlaceUnits()
+{
+	const FUnitArchetypeTable& Archetypes = FUnitArchetypeTable::Get();
+
+	const int32 NumTeams = FMath::Clamp(Config.NumTeams, 2, FSimBoard::MaxTeams);
+	const uint32 AllTeams = (1u << NumTeams) - 1;
+
+	int32 Team = Result.StartingPlayer == EPlayer::Player1 ? 0 : 1;
+	int32 Placed[FSimBoard::MaxTeams] = {};
+
+	// Bit acceso = la squadra deve ancora completare la rosa
+	const int32 UnitsPerSide = FMath::Max(1, Config.UnitsPerSide);
+	uint32 PendingTeams = AllTeams;
+	while (PendingTeams != 0)
+	{
+		TArray<int32> AvailableTiles;
+		for (int32 TileIndex = 0; TileIndex < Board.NumTiles(); ++TileIndex)
+		{
+			if (Board.IsFree(TileIndex))
+			{
+				AvailableTiles.Add(TileIndex);
+			}
+		}
+
+		if (AvailableTiles.Num() == 0) return;
+
+		const int32 TileIndex = AvailableTiles[Random.AI.RandRange(0, AvailableTiles.Num() - 1)];
+		const int32 Archetype = Placed[Team] % Archetypes.Num();
+		Board.AddUnit(MakeUnit(Archetype, Team, TileIndex));
+		CommandLog.AppendPlace(Team == 0, Archetypes[Archetype].bRanged, TileIndex, Team);
+
+		if (++Placed[Team] >= UnitsPerSide)
+		{
+			PendingTeams &= ~(1u << Team);
+		}
+		Team = FindNextTeam(Team, PendingTeams);
+	}
+}
+
+void FSimMatch::PlayBattle()
+{
+	int32 Team = Result.StartingPlayer == EPlayer::Player1 ? 0 : 1;
+
+	while (Result.Turns < Config.MaxTurns)
+	{
+		PlayTurn(Team);
+		CommandLog.AppendEndTurn(Team == 0, Team);
+		++Result.Turns;
+
+		// Una sola squadra con unità vive: è la vincitrice
+		const uint32 AliveTeams = Board.GetAliveTeamsMask();
+		if ((AliveTeams & (AliveTeams - 1)) == 0)
+		{
+			Result.bHasWinner = AliveTeams != 0;
+			Result.WinningTeam = AliveTeams != 0 ? FMath::CountTrailingZeros(AliveTeams) : INDEX_NONE;
+			Result.Winner = Result.WinningTeam == 0 ? EPlayer::Player1 : EPlayer::AI;
+			return;
+		}
+
+		// Fine turno: le unità della squadra tornano Idle
+		for (FSimUnit& Unit : Board.Units)
+		{
+			if (Unit.Team == Team)
+			{
+				Unit.bHasMoved = false;
+				Unit.bHasAttacked = false;
+			}
+		}
+		Team = FindNextTeam(Team, AliveTeams);
+	}
+}
+
+int32 FSimMatch::FindNextTeam(int32 Team, uint32 TeamsMask) const
+{
+	for (int32 Offset = 1; Offset <= FSimBoard::MaxTeams; ++Offset)
+	{
+		const int32 Candidate = (Team + Offset) % FSimBoard::MaxTeams;
+		if (TeamsMask & (1u << Candidate))
+		{
+			return Candidate;
+		}
+	}
+	return Team;
+}
+
+/**
+ * Descrizione:
+ * Ogni unità viva della squadra viene pianificata sulla board corrente (quindi vede
+ * gli effetti reali delle azioni precedenti) e gli attacchi decisi vengono risolti subito.
+ */
+void FSimMatch::PlayTurn(int32 Team)
+{
+	const EAILevel Level = Team == 0 ? Config.Player1Level : Config.AILevel;
+
+	for (int32 UnitIndex = 0; UnitIndex < Board.Units.Num(); ++UnitIndex)
+	{
+		if (!Board.Units[UnitIndex].IsAlive() || Board.Units[UnitIndex].Team != Team) continue;
+
+		// Le mappe di minaccia vengono riallineate solo per le unità cambiate dall'ultima decisione
+		Influence.Update(Board);
+
+		// Il pianificatore sposta l'unità sulla board: la tile di partenza serve al log
+		const int32 FromTile = Board.Units[UnitIndex].TileIndex;
+
+		FAIUnitOrder Order;
+		if (Level == EAILevel::Easy)
+		{
+			FAIPlanner::PlanEasyUnit(Board, UnitIndex, Random.AI, Order);
+		}
+		else if (Level == EAILevel::Utility)
+		{
+			FAIPlanner::PlanUtilityUnit(Board, UnitIndex, Order, &Influence);
+		}
+		else
+		{
+			FAIPlanner::PlanHardUnit(Board, UnitIndex, Order, &Influence);
+		}
+		++Result.Decisions;
+
+		if (Order.Path.Num() > 0)
+		{
+			CommandLog.AppendMove(Team == 0, Board.Units[UnitIndex].bRanged, FromTile, Order.Path, Team);
+		}
+
+		const int32 Target = Order.PreMoveTarget != INDEX_NONE ? Order.PreMoveTarget : Order.PostMoveTarget;
+		if (Target != INDEX_NONE)
+		{
+			ResolveAttack(UnitIndex, Target);
+		}
+
+		// Nessun nemico rimasto: la squadra ha vinto
+		if (Board.GetAliveTeamsMask() == (1u << Team)) return;
+	}
+}
+
+/**
+ * Descrizione:
+ * Stesse regole della partita reale: l'esito viene calcolato da FCombatResolver
+ * con lo stream della partita e poi applicato alla board.
+ */
+void FSimMatch::ResolveAttack(int32 AttackerIndex, int32 TargetIndex)
+{
+	const FCombatResult Combat = FCombatResolver::Resolve(Board, AttackerIndex, TargetIndex, Random.Combat);
+
+	// Log scritto prima di applicare il risultato, finché entrambe le unità occupano la propria tile
+	const FSimUnit& Attacker = Board.Units[AttackerIndex];
+	const FSimUnit& Target = Board.Units[TargetIndex];
+	CommandLog.AppendAttack(Attacker.bPlayer, Attacker.bRanged, Attacker.TileIndex, Target.TileIndex, Combat.Damage, Attacker.Team);
+	if (Combat.bDefenderKilled)
+	{
+		CommandLog.AppendDeath(Target.bPlayer, Target.bRanged, Target.TileIndex, Target.Team);
+	}
+	else if (Combat.bCountered)
+	{
+		CommandLog.AppendCounter(Target.bPlayer, Target.bRanged, Target.TileIndex, Attacker.TileIndex, Combat.CounterDamage, Target.Team);
+		if (Combat.bAttackerKilled)
+		{
+			CommandLog.AppendDeath(Attacker.bPlayer, Attacker.bRanged, Attacker.TileIndex, Attacker.Team);
+		}
+	}
+
+	FCombatResolver::Apply(Board, AttackerIndex, TargetIndex, Combat);
+}
+
+FSimUnit FSimMatch::MakeUnit(int32 ArchetypeIndex, int32 Team, int32 TileIndex)
+{
+	FSimUnit Unit = FSimUnit::FromArchetype(ArchetypeIndex, Team);
+	Unit.UnitId = Board.Units.Num() + 1;
+	Unit.TileIndex = TileIndex;
+	return Unit;
+}
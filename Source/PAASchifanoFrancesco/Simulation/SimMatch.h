@@ -0,0 +1,128 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PAASchifanoFrancesco/Core/MyGameMode.h"
+#include "SimBoard.h"
+#include "PAASchifanoFrancesco/AI/InfluenceMap.h"
+#include "MatchRandom.h"
+#include "MatchCommandLog.h"
+
+/**
+ * Descrizione:
+ * Parametri di una partita simulata tra IA.
+ * Le squadre seguono le stesse regole della partita reale (FCombatResolver),
+ * ma anche le decisioni della squadra 0 ("Player1") sono prese da un'IA.
+ */
+struct FSimMatchConfig
+{
+	/** Livello dell'IA che controlla la fazione Player1 */
+	EAILevel Player1Level = EAILevel::Hard;
+
+	/** Livello dell'IA che controlla le altre squadre */
+	EAILevel AILevel = EAILevel::Hard;
+
+	/** Squadre in partita (2 .. FSimBoard::MaxTeams, come AMyGameMode::NumTeams) */
+	int32 NumTeams = 2;
+
+	/** Dimensioni della griglia */
+	int32 DimX = 25;
+	int32 DimY = 25;
+
+	/** Unità per fazione, alternando Sniper e Brawler (come AMyGameMode::UnitsPerSide) */
+	int32 UnitsPerSide = 2;
+
+	/** Numero massimo di turni prima di dichiarare il pareggio */
+	int32 MaxTurns = 200;
+
+	/** Seed della partita: stesso seed, stessa partita */
+	int32 Seed = 0;
+};
+
+/**
+ * Descrizione:
+ * Risultato di una partita simulata.
+ */
+struct FSimMatchResult
+{
+	/** Giocatore che ha vinto il lancio della moneta */
+	EPlayer StartingPlayer = EPlayer::Player1;
+
+	/** true se la partita è terminata con un vincitore (false = limite di turni raggiunto) */
+	bool bHasWinner = false;
+
+	/** Vincitore (valido solo se bHasWinner): Player1 se ha vinto la squadra 0 */
+	EPlayer Winner = EPlayer::Player1;
+
+	/** Squadra vincitrice (valida solo se bHasWinner) */
+	int32 WinningTeam = INDEX_NONE;
+
+	/** Turni di battaglia giocati */
+	int32 Turns = 0;
+
+	/** Numero di decisioni prese dalle IA (una per unità per turno) */
+	int32 Decisions = 0;
+};
+
+/**
+ * Classe: FSimMatch
+ * Descrizione:
+ * Gioca una partita completa sulla FSimBoard, senza attori, widget né timer:
+ * lancio della moneta, generazione degli ostacoli (DFS come AGridManager),
+ * piazzamento alternato delle unità e battaglia a turni.
+ * Ogni partita usa i propri stream (FMatchRandom), quindi più partite possono essere
+ * eseguite in parallelo su thread diversi.
+ */
+class PAASCHIFANOFRANCESCO_API FSimMatch
+{
+public:
+	explicit FSimMatch(const FSimMatchConfig& InConfig);
+
+	/** Gioca la partita dall'inizio alla fine e ne restituisce il risultato */
+	FSimMatchResult Play();
+
+	/** Board nello stato corrente (a fine partita: stato finale) */
+	const FSimBoard& GetBoard() const { return Board; }
+
+	/** Comandi della partita, nello stesso formato della partita reale (replay, lockstep) */
+	const FMatchCommandLog& GetCommandLog() const { return CommandLog; }
+
+	/** Ostacoli generati per la partita (validi dopo Play) */
+	const TBitArray<>& GetObstacles() const { return Board.Obstacles; }
+
+private:
+	/** Fase di lancio della moneta */
+	void FlipCoin();
+
+	/** Genera gli ostacoli lasciando libera un'area connessa (come AGridManager::GenerateObstacles) */
+	void GenerateObstacles();
+
+	/** Visita DFS con ordine dei vicini casuale: ogni tile visitata diventa libera */
+	void DFS(int32 TileIndex, TBitArray<>& Visited, int32& VisitedCount, int32 MaxObstacles);
+
+	/** Fase di piazzamento: le squadre piazzano a turno le proprie unità, alternando Sniper e Brawler */
+	void PlaceUnits();
+
+	/** Fase di battaglia: ruota i turni tra le squadre vive finché ne resta una sola */
+	void PlayBattle();
+
+	/** Turno di una squadra: ogni unità viva decide e agisce, nello stesso ordine del BattleManager */
+	void PlayTurn(int32 Team);
+
+	/** Squadra che gioca dopo Team tra quelle nella maschera (come UTurnManager::FindNextTeam) */
+	int32 FindNextTeam(int32 Team, uint32 TeamsMask) const;
+
+	/** Risolve un attacco con FCombatResolver (danno casuale ed eventuale contrattacco) */
+	void ResolveAttack(int32 AttackerIndex, int32 TargetIndex);
+
+	/** Crea un'unità con le statistiche dell'archetipo indicato (indice in FUnitArchetypeTable) */
+	FSimUnit MakeUnit(int32 ArchetypeIndex, int32 Team, int32 TileIndex);
+
+	FSimMatchConfig Config;
+	FMatchRandom Random;
+	FSimBoard Board;
+	FInfluenceMap Influence;
+	FSimMatchResult Result;
+	FMatchCommandLog CommandLog;
+};
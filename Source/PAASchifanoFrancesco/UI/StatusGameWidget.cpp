@@ -1,6 +1,7 @@
 #include "StatusGameWidget.h" // Include dell'header della classe
 #include "PAASchifanoFrancesco/Core/MyGameMode.h" // Per accedere al GameMode
 #include "PAASchifanoFrancesco/Core/TurnManager.h" // Per accedere al TurnManager
+#include "PAASchifanoFrancesco/Simulation/CombatAnalytics.h" // Esito esatto degli attacchi
 #include "Components/Border.h"         // Widget contenitore grafico
 #include "Components/Button.h"         // Per il pulsante "End Turn"
 #include "Components/TextBlock.h"      // Per il nome dell'unità
@@ -24,6 +25,8 @@ void UStatusGameWidget::NativeConstruct()
 		EndButton->SetVisibility(ESlateVisibility::Hidden); // Nasconde
 		EndButton->OnClicked.AddDynamic(this, &UStatusGameWidget::OnClickedEndTurn); // Collega evento
 	}
+
+	HideCombatPreview(); // Nessuna anteprima finché il cursore non è su un nemico
 }
 
 /**
@@ -194,4 +197,29 @@ void UStatusGameWidget::RemoveUnitStatus(AUnitBase* Unit)
 	}
 
 	UnitHealthBars.Remove(Unit); // Rimuove dal dizionario
-}
\ No newline at end of file
+}
+/**
+ * Mostra l'anteprima dell'attacco nel testo opzionale CombatPreviewText.
+ * Il calcolo avviene una volta sola quando cambia l'unità sotto il cursore, non a ogni frame.
+ */
+void UStatusGameWidget::ShowCombatPreview(const FCombatOutcome& Outcome)
+{
+	if (!CombatPreviewText) return;
+
+	FString Preview = FString::Printf(TEXT("Kill %.0f%% | Damage %.1f"), Outcome.KillChance * 100.f, Outcome.ExpectedDamage);
+	if (Outcome.CounterChance > 0.f)
+	{
+		Preview += FString::Printf(TEXT(" | Counter %.0f%% (%.1f)"), Outcome.CounterChance * 100.f, Outcome.ExpectedCounterDamage);
+	}
+
+	CombatPreviewText->SetText(FText::FromString(Preview));
+	CombatPreviewText->SetVisibility(ESlateVisibility::HitTestInvisible);
+}
+
+void UStatusGameWidget::HideCombatPreview()
+{
+	if (CombatPreviewText)
+	{
+		CombatPreviewText->SetVisibility(ESlateVisibility::Collapsed);
+	}
+}
@@ -22,6 +22,7 @@ class UButton;
 class UTextBlock;
 class UVerticalBox;
 class UProgressBar;
+struct FCombatOutcome;
 
 /**
  * Classe che rappresenta il widget visivo per lo stato del gioco,
@@ -72,6 +73,15 @@ public:
 	 */
 	void RemoveUnitStatus(AUnitBase* Unit);
 
+	/**
+	 * Mostra l'anteprima di un attacco (probabilità di uccisione, danno atteso, rischio di contrattacco).
+	 * @param Outcome - esito esatto calcolato da FCombatAnalytics.
+	 */
+	void ShowCombatPreview(const FCombatOutcome& Outcome);
+
+	/** Nasconde l'anteprima dell'attacco */
+	void HideCombatPreview();
+
 protected:
 	/** Riferimento al pulsante di fine turno, assegnato via Blueprint (BindWidget) */
 	UPROPERTY(meta = (BindWidget))
@@ -85,6 +95,10 @@ protected:
 	UPROPERTY(meta = (BindWidget))
 	UVerticalBox* UnitStatusBox;
 
+	/** Testo (opzionale) con l'anteprima dell'attacco sull'unità sotto il cursore */
+	UPROPERTY(meta = (BindWidgetOptional))
+	UTextBlock* CombatPreviewText;
+
 private:
 	/**
 	 * Mappa che collega ogni unità a una coppia di widget:
@@ -48,6 +48,10 @@ void UUICOinFlip::NativeConstruct()
 	if (ButtonHard)
 		ButtonHard->OnClicked.AddDynamic(this, &UUICOinFlip::OnHardClicked);
 
+	// Collega il pulsante "Utility" all'evento OnUtilityClicked (se presente nel widget)
+	if (ButtonUtility)
+		ButtonUtility->OnClicked.AddDynamic(this, &UUICOinFlip::OnUtilityClicked);
+
 	// Se esistono l’immagine della moneta e l’animazione, imposta la velocità
 	if (CoinImage && FlipAnimation)
 	{
@@ -81,6 +85,19 @@ void UUICOinFlip::OnHardClicked()
 	}
 }
 
+/**
+ * Metodo: OnUtilityClicked
+ * Descrizione: Gestisce il click sul pulsante "Utility", imposta l'IA a punteggio e avanza alla fase di piazzamento.
+ */
+void UUICOinFlip::OnUtilityClicked()
+{
+	if (GameMode)
+	{
+		GameMode->AILevel = EAILevel::Utility;                // Imposta la difficoltà dell’IA
+		GameMode->SetGamePhase(EGamePhase::EPlacement);       // Passa alla fase di piazzamento
+	}
+}
+
 /**
  * Metodo: SetFlipAnimationSpeed
  * Descrizione: Riproduce l’animazione della moneta alla velocità specificata.
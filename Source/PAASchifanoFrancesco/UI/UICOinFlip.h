@@ -51,6 +51,13 @@ public:
 	UFUNCTION()
 	void OnHardClicked();
 
+	/**
+	 * Metodo chiamato quando il pulsante "Utility" viene premuto.
+	 * Imposta la difficoltà su "Utility" e passa alla fase di piazzamento.
+	 */
+	UFUNCTION()
+	void OnUtilityClicked();
+
 	/**
 	 * Imposta la velocità dell’animazione della moneta.
 	 * @param Speed Velocità con cui riprodurre l’animazione (più alto = più veloce).
@@ -71,6 +78,10 @@ protected:
 	UPROPERTY(meta = (BindWidget))
 	UButton* ButtonHard;
 
+	/** Pulsante (opzionale) per selezionare l'IA "Utility" */
+	UPROPERTY(meta = (BindWidgetOptional))
+	UButton* ButtonUtility;
+
 	/** Immagine che rappresenta graficamente la moneta */
 	UPROPERTY(meta = (BindWidget))
 	UImage* CoinImage;
@@ -3,9 +3,36 @@
 #include "UIMainMenu.h"
 #include "Components/Button.h"
 #include "Components/TextBlock.h"
+#include "Components/EditableTextBox.h"
 #include "PAASchifanoFrancesco/Core/MyGameMode.h"
 #include "Kismet/GameplayStatics.h"
 
+namespace
+{
+	/**
+	 * Seed intero in base 10: segno opzionale seguito da sole cifre, entro l'intervallo di int32.
+	 * Testo vuoto, decimali ("1.5"), il solo segno e valori fuori intervallo vengono rifiutati.
+	 */
+	bool TryParseSeed(const FString& Text, int32& OutSeed)
+	{
+		const int32 FirstDigit = Text.StartsWith(TEXT("-")) ? 1 : 0;
+		const int32 NumDigits = Text.Len() - FirstDigit;
+		if (NumDigits < 1 || NumDigits > 10) return false;
+
+		for (int32 Index = FirstDigit; Index < Text.Len(); ++Index)
+		{
+			if (!FChar::IsDigit(Text[Index])) return false;
+		}
+
+		// Al massimo 10 cifre: il valore entra in int64 e l'intervallo di int32 si verifica dopo
+		int64 Value = 0;
+		if (!LexTryParseString(Value, *Text) || Value < MIN_int32 || Value > MAX_int32) return false;
+
+		OutSeed = static_cast<int32>(Value);
+		return true;
+	}
+}
+
 void UUIMainMenu::NativeConstruct()
 {
 	Super::NativeConstruct();
@@ -26,6 +53,18 @@ void UUIMainMenu::OnStartGameClicked()
 	AMyGameMode* GameMode = Cast<AMyGameMode>(UGameplayStatics::GetGameMode(this));
 	if (GameMode)
 	{
+		// Seed scelto dal giocatore: la partita (mappa, IA, danni) si ripete identica
+		const FString SeedText = SeedInput ? SeedInput->GetText().ToString().TrimStartAndEnd() : FString();
+		int32 Seed = 0;
+		if (TryParseSeed(SeedText, Seed))
+		{
+			GameMode->SetMatchSeed(Seed);
+		}
+		else if (!SeedText.IsEmpty())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Seed \"%s\" non valido: la partita mantiene il seed attuale"), *SeedText);
+		}
+
 		RemoveFromParent();
 		GameMode->SetGamePhase(EGamePhase::ECoinFlip);
 	}
@@ -9,6 +9,7 @@
 
 class UButton;
 class UTextBlock;
+class UEditableTextBox;
 
 UCLASS()
 class PAASCHIFANOFRANCESCO_API UUIMainMenu : public UUserWidget
@@ -24,6 +25,10 @@ public:
     UPROPERTY(BlueprintReadOnly, meta = (BindWidget))
     UButton* StartGameButton;
 
+    // Casella (opzionale) per inserire il seed della partita: vuota = seed casuale
+    UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional))
+    UEditableTextBox* SeedInput;
+
     // Funzione che viene chiamata quando il widget viene costruito
     virtual void NativeConstruct() override;
 
@@ -4,6 +4,7 @@
 #include "Components/TextBlock.h"
 #include "Components/VerticalBox.h"
 #include "Kismet/GameplayStatics.h"
+#include "PAASchifanoFrancesco/Simulation/MatchCommandLog.h"
 
 void UUITurnIndicator::NativeConstruct()
 {
@@ -20,6 +21,7 @@ void UUITurnIndicator::NativeConstruct()
 	{
 		HistoryBox->ClearChildren();
 	}
+	DisplayedCommands = 0;
 
 	// Collega il pulsante Info al suo handler
 	if (InfoButton)
@@ -36,6 +38,47 @@ void UUITurnIndicator::UpdateTurnText(FString PlayerName)
 	}
 }
 
+void UUITurnIndicator::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	RefreshHistory();
+}
+
+void UUITurnIndicator::SetCommandLog(const FMatchCommandLog* InCommandLog)
+{
+	CommandLog = InCommandLog;
+	DisplayedCommands = 0;
+
+	if (HistoryBox)
+	{
+		HistoryBox->ClearChildren();
+	}
+}
+
+void UUITurnIndicator::RefreshHistory()
+{
+	if (!CommandLog || !HistoryBox) return;
+
+	// Il log è stato svuotato, accorciato o ricaricato (nuova partita, undo): ricostruisce la vista
+	if (CommandLog->GetGeneration() != DisplayedGeneration || CommandLog->Num() < DisplayedCommands)
+	{
+		HistoryBox->ClearChildren();
+		DisplayedCommands = 0;
+		DisplayedGeneration = CommandLog->GetGeneration();
+	}
+
+	// Formatta solo i comandi arrivati dall'ultimo aggiornamento
+	FMatchCommand Command;
+	for (; DisplayedCommands < CommandLog->Num(); DisplayedCommands++)
+	{
+		if (CommandLog->Decode(DisplayedCommands, Command) && FMatchCommandLog::IsHistoryEntry(Command.Type))
+		{
+			AddHistoryEntry(CommandLog->Format(Command));
+		}
+	}
+}
+
 void UUITurnIndicator::AddHistoryEntry(const FString& Entry)
 {
 	if (!HistoryBox) return; // Controllo sicurezza
@@ -8,6 +8,7 @@ class UButton;
 class UTextBlock;
 class UVerticalBox;
 class UInfoWidget;
+class FMatchCommandLog;
 
 UCLASS()
 class PAASCHIFANOFRANCESCO_API UUITurnIndicator : public UUserWidget
@@ -21,11 +22,18 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void AddHistoryEntry(const FString& Entry);
 
+	// La history mostra i comandi del log: il testo viene formattato solo per le righe nuove
+	void SetCommandLog(const FMatchCommandLog* InCommandLog);
+
 	UPROPERTY(EditDefaultsOnly, Category = "Widgets")
 	TSubclassOf<class UInfoWidget> InfoWidgetClass;
 
 protected:
 	virtual void NativeConstruct() override;
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+
+	// Allinea HistoryBox al log (aggiunge le righe dei comandi non ancora mostrati)
+	void RefreshHistory();
 
 	UFUNCTION()
 	void OnInfoButtonClicked();
@@ -42,4 +50,9 @@ protected:
 private:
 	UPROPERTY()
 	UInfoWidget* InfoWidgetInstance;
+
+	// Log dei comandi (posseduto dal GameMode) e numero di comandi già visitati
+	const FMatchCommandLog* CommandLog = nullptr;
+	int32 DisplayedCommands = 0;
+	uint32 DisplayedGeneration = 0;
 };
\ No newline at end of file
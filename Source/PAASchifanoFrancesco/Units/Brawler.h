@@ -7,7 +7,7 @@
 /**
  * Classe ABrawler
  * Rappresenta l’unità corpo a corpo controllata dal giocatore o dall’IA.
- * Estende la classe AUnitBase e personalizza mesh, materiale, e statistiche.
+ * Estende la classe AUnitBase indicando l'archetipo: statistiche, mesh e materiali vengono da FUnitArchetypeTable.
  */
 UCLASS()
 class PAASCHIFANOFRANCESCO_API ABrawler : public AUnitBase
@@ -16,12 +16,4 @@ class PAASCHIFANOFRANCESCO_API ABrawler : public AUnitBase
 
 public:
 	ABrawler();
-
-protected:
-	virtual void BeginPlay() override;
-
-private:
-	// Puntatori alle risorse Mesh e Material
-	UStaticMesh* Mesh;
-	UMaterialInterface* Material;
 };
@@ -0,0 +1,96 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "MovementReservationTable.h"
+
+int32 FMovementReservationTable::FindStartDelay(uint32 Owner, int32 FromTile, TConstArrayView<int32> Path, int32 StartStep, int32 MaxDelay) const
+{
+	for (int32 Delay = 0; Delay <= MaxDelay; ++Delay)
+	{
+		const int32 Departure = StartStep + Delay;
+		bool bFree = IsFree(Owner, FromTile, MIN_int32, Departure);
+
+		// L'i-esima tile del percorso viene raggiunta al passo Departure + i + 1
+		for (int32 Index = 0; bFree && Index < Path.Num(); ++Index)
+		{
+			const int32 Step = Departure + Index + 1;
+			const bool bGoal = Index == Path.Num() - 1;
+			bFree = IsFree(Owner, Path[Index], Step, bGoal ? MAX_int32 : Step);
+		}
+
+		if (bFree)
+		{
+			return Delay;
+		}
+	}
+	return INDEX_NONE;
+}
+
+void FMovementReservationTable::Reserve(uint32 Owner, int32 FromTile, TConstArrayView<int32> Path, int32 StartStep)
+{
+	AddHold(Owner, FromTile, MIN_int32, StartStep);
+
+	for (int32 Index = 0; Index < Path.Num(); ++Index)
+	{
+		const int32 Step = StartStep + Index + 1;
+		const bool bGoal = Index == Path.Num() - 1;
+		AddHold(Owner, Path[Index], Step, bGoal ? MAX_int32 : Step);
+	}
+
+	LastTransitStep = FMath::Max(LastTransitStep, StartStep + Path.Num());
+}
+
+void FMovementReservationTable::ReserveTimeline(uint32 Owner, TConstArrayView<int32> Timeline, int32 FirstStep)
+{
+	const int32 Last = Timeline.Num() - 1;
+	for (int32 Index = 0; Index <= Last; ++Index)
+	{
+		const int32 Step = FirstStep + Index;
+		AddHold(Owner, Timeline[Index], Index == 0 ? MIN_int32 : Step, Index == Last ? MAX_int32 : Step);
+	}
+
+	LastTransitStep = FMath::Max(LastTransitStep, FirstStep + Last);
+}
+
+void FMovementReservationTable::Release(uint32 Owner)
+{
+	for (auto It = Holds.CreateIterator(); It; ++It)
+	{
+		It.Value().RemoveAllSwap([Owner](const FHold& Hold) { return Hold.Owner == Owner; });
+		if (It.Value().Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FMovementReservationTable::Reset()
+{
+	Holds.Reset();
+	LastTransitStep = 0;
+}
+
+bool FMovementReservationTable::IsFree(uint32 Owner, int32 Tile, int32 FromStep, int32 ToStep) const
+{
+	const TArray<FHold, TInlineAllocator<4>>* TileHolds = Holds.Find(Tile);
+	if (!TileHolds) return true;
+
+	for (const FHold& Hold : *TileHolds)
+	{
+		if (Hold.Owner == Owner) continue;
+
+		// Margine di un passo: 64 bit per non andare in overflow con gli intervalli aperti
+		if (int64(Hold.FromStep) <= int64(ToStep) + 1 && int64(FromStep) <= int64(Hold.ToStep) + 1)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FMovementReservationTable::AddHold(uint32 Owner, int32 Tile, int32 FromStep, int32 ToStep)
+{
+	FHold& Hold = Holds.FindOrAdd(Tile).AddDefaulted_GetRef();
+	Hold.Owner = Owner;
+	Hold.FromStep = FromStep;
+	Hold.ToStep = ToStep;
+}
@@ -0,0 +1,64 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Classe: FMovementReservationTable
+ * Descrizione:
+ * Tabella di prenotazione (tile, timestep) per i movimenti contemporanei.
+ * Il tempo è diviso in passi: a ogni passo un'unità in movimento entra nella tile successiva del percorso.
+ * Ogni prenotazione è un intervallo di passi su una tile:
+ * - tile di partenza: dall'inizio fino al passo in cui l'unità parte (l'unità aspetta lì);
+ * - tile intermedie: il solo passo di attraversamento;
+ * - destinazione: dal passo di arrivo in poi.
+ *
+ * Due intervalli di unità diverse sulla stessa tile devono essere separati da almeno un passo:
+ * così si escludono sia le collisioni sulla stessa tile sia gli scambi di posizione e gli inseguimenti
+ * (un'unità che entra in una tile mentre l'altra ne sta uscendo).
+ */
+class PAASCHIFANOFRANCESCO_API FMovementReservationTable
+{
+public:
+	/**
+	 * Primo ritardo (in passi, da 0 a MaxDelay) con cui l'unità può partire al passo StartStep + ritardo
+	 * senza entrare in conflitto con le prenotazioni esistenti; INDEX_NONE se non esiste.
+	 */
+	int32 FindStartDelay(uint32 Owner, int32 FromTile, TConstArrayView<int32> Path, int32 StartStep, int32 MaxDelay) const;
+
+	/** Prenota partenza, percorso e destinazione di un movimento che inizia al passo StartStep */
+	void Reserve(uint32 Owner, int32 FromTile, TConstArrayView<int32> Path, int32 StartStep);
+
+	/**
+	 * Prenota una sequenza di tile passo per passo: Timeline[i] è occupata al passo FirstStep + i,
+	 * la prima tile da sempre e l'ultima per sempre. Tile ripetute = attese (usato dalla pianificazione cooperativa).
+	 */
+	void ReserveTimeline(uint32 Owner, TConstArrayView<int32> Timeline, int32 FirstStep);
+
+	/** true se l'intervallo [FromStep, ToStep] sulla tile non tocca prenotazioni di altre unità */
+	bool IsFree(uint32 Owner, int32 Tile, int32 FromStep, int32 ToStep) const;
+
+	/** Rimuove tutte le prenotazioni dell'unità */
+	void Release(uint32 Owner);
+
+	/** Ultimo passo finito prenotato (le destinazioni non contano): dopo, restano solo unità ferme */
+	int32 GetLastTransitStep() const { return LastTransitStep; }
+
+	void Reset();
+
+private:
+	struct FHold
+	{
+		uint32 Owner = 0;
+		int32 FromStep = 0;
+		int32 ToStep = 0;
+	};
+
+	void AddHold(uint32 Owner, int32 Tile, int32 FromStep, int32 ToStep);
+
+	/** Prenotazioni per tile: poche per tile, la ricerca lineare è sufficiente */
+	TMap<int32, TArray<FHold, TInlineAllocator<4>>> Holds;
+
+	int32 LastTransitStep = 0;
+};
@@ -2,42 +2,32 @@
 
 #include "MyMovementComponent.h"
 #include "PAASchifanoFrancesco/Grid/GridManager.h"
-#include "PAASchifanoFrancesco/Core/MyGameMode.h"
+#include "PAASchifanoFrancesco/Core/GameServices.h"
 #include "UnitBase.h"
-#include "Kismet/GameplayStatics.h"
 #include "GameFramework/Actor.h"
 
 UMyMovementComponent::UMyMovementComponent()
 {
-	PrimaryComponentTick.bCanEverTick = true; // Abilita il Tick per aggiornare il movimento
-	bIsMoving = false;                        // Inizialmente non si sta muovendo
-	MovementSpeed = 300.f;                    // Velocità di default
-	CurrentTargetIndex = 0;                   // Nessun indice attivo all’inizio
-}
-
-void UMyMovementComponent::BeginPlay()
-{
-	Super::BeginPlay();
+	PrimaryComponentTick.bCanEverTick = false; // Il movimento avanza nel tick di AUnitMovementManager
+	bIsMoving = false;                         // Inizialmente non si sta muovendo
 }
 
 /**
- * Metodo che avvia un movimento lungo un certo percorso.
- * Imposta le variabili interne e abilita lo stato di movimento.
+ * Metodo che segna l'inizio di un movimento lungo un certo percorso.
+ * Salva il percorso e notifica lo stato di movimento all'unità proprietaria.
  */
-void UMyMovementComponent::StartMovement(const TArray<ATile*>& Path, float Speed)
+void UMyMovementComponent::BeginMovement(const TArray<ATile*>& Path)
 {
 	if (Path.Num() == 0)
 	{
-		UE_LOG(LogTemp, Error, TEXT("StartMovement: Path vuoto!"));
+		UE_LOG(LogTemp, Error, TEXT("BeginMovement: Path vuoto!"));
 		return;
 	}
 
-	MovementPath = Path;           // Salva il percorso
-	MovementSpeed = Speed;         // Imposta la velocità
-	CurrentTargetIndex = 0;        // Parte dal primo punto
-	bIsMoving = true;              // Movimento in corso
-	
-	UE_LOG(LogTemp, Warning, TEXT("Inizio movimento su %d tiles con velocità %.1f"), Path.Num(), Speed);
+	MovementPath = Path; // Salva il percorso
+	bIsMoving = true;    // Movimento in corso
+
+	UE_LOG(LogTemp, Warning, TEXT("Inizio movimento su %d tiles"), Path.Num());
 
 	// Notifica lo stato di movimento alla UnitBase proprietaria
 	if (AUnitBase* Unit = Cast<AUnitBase>(GetOwner()))
@@ -47,59 +37,56 @@ void UMyMovementComponent::StartMovement(const TArray<ATile*>& Path, float Speed
 }
 
 /**
- * Metodo chiamato ogni frame se il componente è attivo.
- * Gestisce il movimento fluido tra una tile e l’altra del percorso.
+ * Conclude il movimento: aggiorna lo stato dell'unità e della tile finale
+ * e notifica il completamento a chi è in ascolto.
  */
-void UMyMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UMyMovementComponent::FinishMovement()
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-	// Se il movimento non è attivo o il path è finito, esce
-	if (!bIsMoving || MovementPath.Num() == 0 || CurrentTargetIndex >= MovementPath.Num())
-		return;
-
-	AActor* Owner = GetOwner();
-	if (!Owner) return;
+	bIsMoving = false;
 
-	// Posizione attuale e posizione target della prossima tile
-	FVector CurrentLocation = Owner->GetActorLocation();
-	FVector TargetLocation = MovementPath[CurrentTargetIndex]->GetPawnSpawnLocation();
-
-	// Calcola nuova posizione con interpolazione lineare costante
-	FVector NewLocation = FMath::VInterpConstantTo(CurrentLocation, TargetLocation, DeltaTime, MovementSpeed);
-	Owner->SetActorLocation(NewLocation); // Aggiorna la posizione attuale
-
-	// Se è vicino abbastanza al target, passa alla prossima tile
-	if (FVector::Dist(NewLocation, TargetLocation) < 5.f)
+	if (AUnitBase* Unit = Cast<AUnitBase>(GetOwner()))
 	{
-		CurrentTargetIndex++;
+		Unit->bIsMoving = false;
+	}
 
-		// Se ha raggiunto l’ultima tile → fine movimento
-		if (CurrentTargetIndex >= MovementPath.Num())
+	// Aggiorna lo stato della tile finale nel GridManager
+	if (const UGameServices* Services = UGameServices::Get(this))
+	{
+		if (AGridManager* GridManager = Services->GetGridManager())
 		{
-			bIsMoving = false;
-
-			if (AUnitBase* Unit = Cast<AUnitBase>(GetOwner()))
+			if (MovementPath.Num() > 0)
 			{
-				Unit->bIsMoving = false;
+				ATile* LastTile = MovementPath.Last();
+				GridManager->FinalizeUnitMovement(Cast<AUnitBase>(GetOwner()), LastTile);
 			}
+		}
+	}
 
-			// Aggiorna lo stato della tile finale nel GridManager
-			if (AMyGameMode* GM = Cast<AMyGameMode>(UGameplayStatics::GetGameMode(this)))
-			{
-				if (AGridManager* GridManager = GM->GetGridManager())
-				{
-					if (MovementPath.Num() > 0)
-					{
-						ATile* LastTile = MovementPath.Last();
-						GridManager->FinalizeUnitMovement(Cast<AUnitBase>(Owner), LastTile);
-					}
-				}
-			}
+	// Notifica a chi ascolta che il movimento è terminato
+	UE_LOG(LogTemp, Warning, TEXT("Broadcast: movimento completato in UMyMovementComponent"));
+	OnMovementCompleted.Broadcast(Cast<AUnitBase>(GetOwner()));
+}
 
-			// Notifica a chi ascolta che il movimento è terminato
-			UE_LOG(LogTemp, Warning, TEXT("Broadcast: movimento completato in UMyMovementComponent"));
-			OnMovementCompleted.Broadcast();
+void UMyMovementComponent::CancelMovement()
+{
+	bIsMoving = false;
+
+	AUnitBase* Unit = Cast<AUnitBase>(GetOwner());
+	if (Unit)
+	{
+		Unit->bIsMoving = false;
+	}
+
+	// La destinazione era stata segnata come occupata alla partenza: si libera se nessuna unità vi è registrata
+	if (const UGameServices* Services = UGameServices::Get(this))
+	{
+		AGridManager* GridManager = Services->GetGridManager();
+		ATile* LastTile = MovementPath.Num() > 0 ? MovementPath.Last() : nullptr;
+		if (GridManager && LastTile && !GridManager->GetUnitOnTile(LastTile))
+		{
+			LastTile->SetHasPawn(false);
 		}
 	}
-}
\ No newline at end of file
+
+	MovementPath.Reset();
+}
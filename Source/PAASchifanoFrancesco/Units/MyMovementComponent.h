@@ -7,17 +7,21 @@
 #include "PAASchifanoFrancesco/Grid/Tile.h"
 #include "MyMovementComponent.generated.h"
 
+class AUnitBase;
+
 /**
  * Delegato dinamico che notifica il completamento del movimento di un'unità.
  * Viene utilizzato da altri manager (es. PlayerController o BattleManager).
+ * Parametro: l'unità proprietaria del componente, così chi ascolta più movimenti sa quale è terminato.
  */
-DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnMovementCompleted);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMovementCompleted, AUnitBase*, MovedUnit);
 
 /**
  * Descrizione:
- * Componente associato a una unità (`AUnitBase`) che gestisce il movimento
- * lungo un percorso definito (array di `ATile*`). Il movimento è interpolato
- * in modo fluido e lineare.
+ * Componente associato a una unità (`AUnitBase`) che descrive il movimento in corso
+ * lungo un percorso definito (array di `ATile*`).
+ * Il componente non ha tick: l'interpolazione di tutte le unità in movimento viene eseguita
+ * in un unico ciclo da AUnitMovementManager, quindi un'unità ferma non costa nulla per frame.
  */
 UCLASS()
 class PAASCHIFANOFRANCESCO_API UMyMovementComponent : public UActorComponent
@@ -26,39 +30,33 @@ class PAASCHIFANOFRANCESCO_API UMyMovementComponent : public UActorComponent
 
 public:
 
-	/** Costruttore di default. Imposta tick abilitato e variabili iniziali */
+	/** Costruttore di default. Disattiva il tick e imposta le variabili iniziali */
 	UMyMovementComponent();
 
 	/**
-	 * Avvia il movimento lungo il percorso specificato con una determinata velocità.
+	 * Segna l'inizio di un movimento lungo il percorso (chiamato da AUnitMovementManager).
 	 * @param Path - Lista di tile da seguire
-	 * @param Speed - Velocità costante del movimento
 	 */
-	void StartMovement(const TArray<ATile*>& Path, float Speed);
+	void BeginMovement(const TArray<ATile*>& Path);
 
-	/** Delegato notificato alla fine del movimento */
-	UPROPERTY(BlueprintAssignable)
-	FOnMovementCompleted OnMovementCompleted;
+	/** Conclude il movimento sull'ultima tile del percorso e notifica OnMovementCompleted */
+	void FinishMovement();
 
-protected:
+	/** Interrompe il movimento senza raggiungere la destinazione, che torna libera (nessuna notifica) */
+	void CancelMovement();
 
-	/** Metodo chiamato automaticamente quando il gioco inizia */
-	virtual void BeginPlay() override;
+	/** true se l'unità sta percorrendo un percorso */
+	bool IsMoving() const { return bIsMoving; }
 
-	/** Tick eseguito ogni frame per aggiornare la posizione dell’unità */
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	/** Delegato notificato alla fine del movimento */
+	UPROPERTY(BlueprintAssignable)
+	FOnMovementCompleted OnMovementCompleted;
 
 private:
 
-	/** Percorso da seguire, array di tile */
+	/** Percorso in corso, array di tile */
 	TArray<ATile*> MovementPath;
 
-	/** Velocità di movimento costante */
-	float MovementSpeed;
-
-	/** Indice della tile target attualmente in corso */
-	int32 CurrentTargetIndex;
-
 	/** Indica se un movimento è attualmente in corso */
 	bool bIsMoving;
-};
\ No newline at end of file
+};
@@ -0,0 +1,154 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "PathSpline.h"
+#include "Math/VectorRegister.h"
+
+namespace
+{
+	/** Punto della curva Catmull-Rom uniforme tra P1 e P2 */
+	FVector CatmullRom(const FVector& P0, const FVector& P1, const FVector& P2, const FVector& P3, float T)
+	{
+		const float T2 = T * T;
+		const float T3 = T2 * T;
+		return 0.5f * ((2.f * P1) + (P2 - P0) * T + (2.f * P0 - 5.f * P1 + 4.f * P2 - P3) * T2 + (3.f * P1 - P0 - 3.f * P2 + P3) * T3);
+	}
+}
+
+/**
+ * Descrizione:
+ * 1. Campiona densamente la curva (SamplesPerSegment punti per tratto) e accumula la lunghezza dell'arco.
+ * 2. Ricampiona a passo costante: per ogni distanza i * SampleSpacing cerca il tratto denso che la contiene
+ *    (la scansione avanza in modo monotono, quindi la costruzione è lineare nel numero di campioni).
+ * Gli estremi vengono duplicati, così la curva parte e finisce esattamente sulle tile.
+ * I punti ripetuti vengono saltati (un nodo doppio farebbe un cappio nella Catmull-Rom),
+ * ma ognuno riceve la distanza del proprio nodo, così chi esegue il movimento sa dove fermarsi.
+ */
+void FPathSpline::Build(const FVector& Start, TConstArrayView<FVector> Points)
+{
+	Samples.Reset();
+	PointDistances.Reset();
+	Length = 0.f;
+
+	TArray<FVector, TInlineAllocator<16>> Controls;
+	TArray<int32, TInlineAllocator<16>> PointControls;
+	Controls.Add(Start);
+	for (const FVector& Point : Points)
+	{
+		if (!Point.Equals(Controls.Last()))
+		{
+			Controls.Add(Point);
+		}
+		PointControls.Add(Controls.Num() - 1);
+	}
+
+	if (Controls.Num() < 2)
+	{
+		Samples.Add(Start);
+		PointDistances.SetNumZeroed(Points.Num());
+		return;
+	}
+
+	// Campionamento denso con lunghezze cumulative
+	TArray<FVector, TInlineAllocator<128>> Dense;
+	TArray<float, TInlineAllocator<128>> DenseDistance;
+	Dense.Add(Controls[0]);
+	DenseDistance.Add(0.f);
+
+	const int32 LastControl = Controls.Num() - 1;
+	for (int32 Segment = 0; Segment < LastControl; ++Segment)
+	{
+		const FVector& P0 = Controls[FMath::Max(Segment - 1, 0)];
+		const FVector& P1 = Controls[Segment];
+		const FVector& P2 = Controls[Segment + 1];
+		const FVector& P3 = Controls[FMath::Min(Segment + 2, LastControl)];
+
+		for (int32 Sample = 1; Sample <= SamplesPerSegment; ++Sample)
+		{
+			const FVector Point = CatmullRom(P0, P1, P2, P3, static_cast<float>(Sample) / SamplesPerSegment);
+			DenseDistance.Add(DenseDistance.Last() + FVector::Dist(Dense.Last(), Point));
+			Dense.Add(Point);
+		}
+	}
+
+	Length = DenseDistance.Last();
+	for (const int32 Control : PointControls)
+	{
+		PointDistances.Add(DenseDistance[Control * SamplesPerSegment]);
+	}
+
+	if (Length <= KINDA_SMALL_NUMBER)
+	{
+		Samples.Add(Controls.Last());
+		return;
+	}
+
+	// Ricampionamento a distanza costante (stesso numero di campioni della curva densa)
+	const int32 NumSamples = Dense.Num();
+	SampleSpacing = Length / (NumSamples - 1);
+	InvSampleSpacing = 1.f / SampleSpacing;
+	Samples.SetNumUninitialized(NumSamples);
+
+	int32 DenseIndex = 0;
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		const float Distance = FMath::Min(Index * SampleSpacing, Length);
+		while (DenseIndex < Dense.Num() - 2 && DenseDistance[DenseIndex + 1] < Distance)
+		{
+			++DenseIndex;
+		}
+
+		const float SegmentLength = DenseDistance[DenseIndex + 1] - DenseDistance[DenseIndex];
+		const float Alpha = SegmentLength > 0.f ? (Distance - DenseDistance[DenseIndex]) / SegmentLength : 0.f;
+		Samples[Index] = FMath::Lerp(Dense[DenseIndex], Dense[DenseIndex + 1], FMath::Clamp(Alpha, 0.f, 1.f));
+	}
+	Samples.Last() = Controls.Last();
+}
+
+FVector FPathSpline::Evaluate(float Distance) const
+{
+	const float Position = FMath::Clamp(Distance, 0.f, Length) * InvSampleSpacing;
+	const int32 Index = FMath::Min(FMath::FloorToInt32(Position), Samples.Num() - 1);
+	const int32 Next = FMath::Min(Index + 1, Samples.Num() - 1);
+	return FMath::Lerp(Samples[Index], Samples[Next], Position - Index);
+}
+
+/**
+ * Descrizione:
+ * L'avanzamento delle distanze è un'operazione identica su tutte le corsie e viene eseguito
+ * con VectorMultiplyAdd su blocchi di 4 movimenti; la coda (meno di 4) è scalare.
+ */
+void FPathSpline::AdvanceBatch(TArrayView<float> Distances, TConstArrayView<float> Speeds, float DeltaTime)
+{
+	const int32 Num = Distances.Num();
+	check(Speeds.Num() == Num);
+
+	const VectorRegister4Float Delta = VectorSetFloat1(DeltaTime);
+
+	int32 Index = 0;
+	for (; Index + 4 <= Num; Index += 4)
+	{
+		const VectorRegister4Float Distance = VectorLoad(&Distances[Index]);
+		const VectorRegister4Float Speed = VectorLoad(&Speeds[Index]);
+		VectorStore(VectorMultiplyAdd(Speed, Delta, Distance), &Distances[Index]);
+	}
+	for (; Index < Num; ++Index)
+	{
+		Distances[Index] += Speeds[Index] * DeltaTime;
+	}
+}
+
+/**
+ * Descrizione:
+ * La lettura della tabella richiede un accesso diverso per ogni curva, quindi resta per movimento,
+ * ma costa un indice e un'interpolazione.
+ */
+void FPathSpline::EvaluateBatch(TConstArrayView<const FPathSpline*> Splines, TConstArrayView<float> Distances, TArrayView<FVector> OutPositions)
+{
+	const int32 Num = Splines.Num();
+	check(Distances.Num() == Num && OutPositions.Num() == Num);
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		OutPositions[Index] = Splines[Index]->Evaluate(Distances[Index]);
+	}
+}
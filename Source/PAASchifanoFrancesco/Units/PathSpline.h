@@ -0,0 +1,54 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Classe: FPathSpline
+ * Descrizione:
+ * Percorso di un movimento trasformato una sola volta in una curva Catmull-Rom che passa per i centri
+ * delle tile (gli angoli vengono arrotondati invece di fermarsi sul centro).
+ * Alla costruzione la curva viene ricampionata a distanza costante lungo l'arco: la tabella risultante
+ * permette di ottenere la posizione a una certa distanza percorsa in O(1), con un'interpolazione
+ * tra due campioni, senza controlli di distanza per frame.
+ */
+class PAASCHIFANOFRANCESCO_API FPathSpline
+{
+public:
+	/** Campioni della curva per ogni tratto tra due tile, usati per misurare la lunghezza dell'arco */
+	static constexpr int32 SamplesPerSegment = 8;
+
+	/**
+	 * Costruisce la curva dalla posizione di partenza e dai punti del percorso.
+	 * Punti consecutivi uguali (attese sulla stessa tile) formano un solo nodo della curva.
+	 */
+	void Build(const FVector& Start, TConstArrayView<FVector> Points);
+
+	/** Posizione dopo Distance unità percorse (valori fuori da [0, Length] restano agli estremi) */
+	FVector Evaluate(float Distance) const;
+
+	/** Lunghezza totale della curva */
+	float GetLength() const { return Length; }
+
+	/** Distanza lungo la curva del punto PointIndex passato a Build (0 = primo punto dopo la partenza) */
+	float GetPointDistance(int32 PointIndex) const { return PointDistances[PointIndex]; }
+
+	bool IsValid() const { return Samples.Num() > 0; }
+
+	/** Avanza in blocco le distanze: Distances[i] += Speeds[i] * DeltaTime, 4 corsie per volta con i registri vettoriali */
+	static void AdvanceBatch(TArrayView<float> Distances, TConstArrayView<float> Speeds, float DeltaTime);
+
+	/** Scrive in OutPositions la posizione di ogni curva alla distanza corrispondente (stessa lunghezza delle viste) */
+	static void EvaluateBatch(TConstArrayView<const FPathSpline*> Splines, TConstArrayView<float> Distances, TArrayView<FVector> OutPositions);
+
+private:
+	/** Campioni equidistanti lungo l'arco: Samples[i] si trova a distanza i * SampleSpacing */
+	TArray<FVector> Samples;
+	float SampleSpacing = 1.f;
+	float InvSampleSpacing = 1.f;
+	float Length = 0.f;
+
+	/** Distanza lungo la curva di ogni punto del percorso */
+	TArray<float, TInlineAllocator<8>> PointDistances;
+};
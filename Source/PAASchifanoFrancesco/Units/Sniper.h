@@ -11,12 +11,4 @@ class PAASCHIFANOFRANCESCO_API ASniper : public AUnitBase
 
 public:
 	ASniper();
-
-protected:
-	virtual void BeginPlay() override;
-
-private:
-	// Puntatori alle risorse Mesh e Material
-	UStaticMesh* Mesh;
-	UMaterialInterface* Material;
 };
@@ -0,0 +1,191 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "UnitArchetypes.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	/** Valori predefiniti, usati quando né la DataTable né il file JSON sono disponibili */
+	FUnitArchetypeRow MakeDefaultRow(EUnitArchetype Archetype)
+	{
+		FUnitArchetypeRow Row;
+		Row.Mesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Plane.Plane")));
+		Row.CounterMinDamage = 1;
+		Row.CounterMaxDamage = 3;
+
+		if (Archetype == EUnitArchetype::Sniper)
+		{
+			Row.MaxHealth = 20;            // Unità fragile
+			Row.MovementRange = 3;
+			Row.AttackRange = 10;          // Gittata molto ampia
+			Row.MinDamage = 4;
+			Row.MaxDamage = 8;
+			Row.bRanged = true;
+			Row.bProvokesCounter = true;   // Chi subisce un colpo dello Sniper risponde
+			Row.bCountersAtRange = true;   // Uno Sniper risponde a uno Sniper anche da lontano
+			Row.MeshScale = FVector(1.2f);
+			Row.PlayerMaterial = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/Material/PlayerSniper.PlayerSniper")));
+			Row.AIMaterial = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/Material/AISniper.AISniper")));
+		}
+		else
+		{
+			Row.MaxHealth = 40;
+			Row.MovementRange = 6;
+			Row.AttackRange = 1;           // Solo adiacente
+			Row.MinDamage = 1;
+			Row.MaxDamage = 6;
+			Row.MeshScale = FVector(1.6f);
+			Row.PlayerMaterial = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/Material/PlayerBrawler.PlayerBrawler")));
+			Row.AIMaterial = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/Material/AIBrawler.AIBrawler")));
+		}
+		return Row;
+	}
+
+	uint8 ToByte(int32 Value)
+	{
+		return static_cast<uint8>(FMath::Clamp(Value, 0, MAX_uint8));
+	}
+
+	/** Oggetto "archetypes" del file JSON degli archetipi, nullo se il file manca o non è valido */
+	TSharedPtr<FJsonObject> LoadJsonArchetypes()
+	{
+		const FString Filename = FPaths::Combine(FPaths::ProjectContentDir(), FUnitArchetypeTable::DefaultJsonFile);
+		FString Text;
+		if (!FFileHelper::LoadFileToString(Text, *Filename))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("UnitArchetypes: %s non trovato, uso i valori predefiniti"), *Filename);
+			return nullptr;
+		}
+
+		TSharedPtr<FJsonObject> Root;
+		const TSharedPtr<FJsonObject>* Archetypes = nullptr;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Root) || !Root.IsValid()
+			|| !Root->TryGetObjectField(TEXT("archetypes"), Archetypes))
+		{
+			UE_LOG(LogTemp, Error, TEXT("UnitArchetypes: %s non è valido, uso i valori predefiniti"), *Filename);
+			return nullptr;
+		}
+		return *Archetypes;
+	}
+
+	/** Sovrascrive i campi presenti nell'oggetto JSON; quelli assenti mantengono il valore della riga */
+	void ReadJsonRow(const FJsonObject& Json, FUnitArchetypeRow& Row)
+	{
+		Json.TryGetNumberField(TEXT("maxHealth"), Row.MaxHealth);
+		Json.TryGetNumberField(TEXT("movementRange"), Row.MovementRange);
+		Json.TryGetNumberField(TEXT("attackRange"), Row.AttackRange);
+		Json.TryGetNumberField(TEXT("minDamage"), Row.MinDamage);
+		Json.TryGetNumberField(TEXT("maxDamage"), Row.MaxDamage);
+		Json.TryGetBoolField(TEXT("ranged"), Row.bRanged);
+		Json.TryGetBoolField(TEXT("provokesCounter"), Row.bProvokesCounter);
+		Json.TryGetBoolField(TEXT("countersAtRange"), Row.bCountersAtRange);
+		Json.TryGetNumberField(TEXT("counterMinDamage"), Row.CounterMinDamage);
+		Json.TryGetNumberField(TEXT("counterMaxDamage"), Row.CounterMaxDamage);
+
+		double MeshScale = 0.0;
+		if (Json.TryGetNumberField(TEXT("meshScale"), MeshScale))
+		{
+			Row.MeshScale = FVector(MeshScale);
+		}
+
+		FString Path;
+		if (Json.TryGetStringField(TEXT("mesh"), Path))
+		{
+			Row.Mesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(Path));
+		}
+		if (Json.TryGetStringField(TEXT("playerMaterial"), Path))
+		{
+			Row.PlayerMaterial = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(Path));
+		}
+		if (Json.TryGetStringField(TEXT("aiMaterial"), Path))
+		{
+			Row.AIMaterial = TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(Path));
+		}
+	}
+}
+
+const FUnitArchetypeTable& FUnitArchetypeTable::Get()
+{
+	static const FUnitArchetypeTable Table;
+	return Table;
+}
+
+/**
+ * Descrizione:
+ * Ogni archetipo parte dai valori predefiniti. Se la DataTable esiste le sue righe li sostituiscono,
+ * altrimenti vengono letti i campi del file JSON distribuito con il gioco (DefaultJsonFile).
+ * Le voci con nomi sconosciuti vengono segnalate e ignorate.
+ */
+FUnitArchetypeTable::FUnitArchetypeTable()
+{
+	const UEnum* ArchetypeEnum = StaticEnum<EUnitArchetype>();
+	const UDataTable* DataTable = LoadObject<UDataTable>(nullptr, DefaultTablePath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+	if (DataTable && DataTable->GetRowStruct() != FUnitArchetypeRow::StaticStruct())
+	{
+		UE_LOG(LogTemp, Error, TEXT("UnitArchetypes: %s non usa righe FUnitArchetypeRow, uso i valori predefiniti"), DefaultTablePath);
+		DataTable = nullptr;
+	}
+
+	const TSharedPtr<FJsonObject> JsonArchetypes = DataTable ? nullptr : LoadJsonArchetypes();
+	for (int32 Index = 0; Index < Num(); ++Index)
+	{
+		FUnitArchetypeRow Row = MakeDefaultRow(static_cast<EUnitArchetype>(Index));
+		const TSharedPtr<FJsonObject>* JsonRow = nullptr;
+		if (JsonArchetypes && JsonArchetypes->TryGetObjectField(ArchetypeEnum->GetNameStringByIndex(Index), JsonRow))
+		{
+			ReadJsonRow(**JsonRow, Row);
+		}
+		SetArchetype(static_cast<EUnitArchetype>(Index), Row);
+	}
+
+	if (JsonArchetypes)
+	{
+		for (const TPair<FString, TSharedPtr<FJsonValue>>& Entry : JsonArchetypes->Values)
+		{
+			const int64 Value = ArchetypeEnum->GetValueByNameString(Entry.Key);
+			if (Value == INDEX_NONE || Value >= Num())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("UnitArchetypes: voce %s ignorata (archetipo sconosciuto)"), *Entry.Key);
+			}
+		}
+	}
+
+	if (!DataTable) return;
+
+	DataTable->ForeachRow<FUnitArchetypeRow>(TEXT("FUnitArchetypeTable"), [this, ArchetypeEnum](const FName& RowName, const FUnitArchetypeRow& Row)
+	{
+		const int64 Value = ArchetypeEnum->GetValueByNameString(RowName.ToString());
+		if (Value == INDEX_NONE || Value >= Num())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("UnitArchetypes: riga %s ignorata (archetipo sconosciuto)"), *RowName.ToString());
+			return;
+		}
+		SetArchetype(static_cast<EUnitArchetype>(Value), Row);
+	});
+}
+
+void FUnitArchetypeTable::SetArchetype(EUnitArchetype Archetype, const FUnitArchetypeRow& Row)
+{
+	FUnitArchetype& Stats = Archetypes[static_cast<int32>(Archetype)];
+	Stats.MaxHealth = static_cast<int16>(FMath::Clamp(Row.MaxHealth, 1, MAX_int16));
+	Stats.MovementRange = ToByte(Row.MovementRange);
+	Stats.AttackRange = ToByte(Row.AttackRange);
+	Stats.MinDamage = ToByte(Row.MinDamage);
+	Stats.MaxDamage = FMath::Max(Stats.MinDamage, ToByte(Row.MaxDamage));
+	Stats.CounterMinDamage = ToByte(Row.CounterMinDamage);
+	Stats.CounterMaxDamage = FMath::Max(Stats.CounterMinDamage, ToByte(Row.CounterMaxDamage));
+	Stats.bRanged = Row.bRanged;
+	Stats.bProvokesCounter = Row.bProvokesCounter;
+	Stats.bCountersAtRange = Row.bCountersAtRange;
+
+	FUnitArchetypeVisuals& Visual = Visuals[static_cast<int32>(Archetype)];
+	Visual.Mesh = Row.Mesh;
+	Visual.MeshScale = Row.MeshScale;
+	Visual.PlayerMaterial = Row.PlayerMaterial;
+	Visual.AIMaterial = Row.AIMaterial;
+}
@@ -0,0 +1,148 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "UnitArchetypes.generated.h"
+
+class UStaticMesh;
+class UMaterialInterface;
+
+/** Archetipi delle unità: il valore è l'indice nella tabella degli archetipi */
+UENUM()
+enum class EUnitArchetype : uint8
+{
+	Sniper,      // Attacco a distanza, fragile
+	Brawler,     // Corpo a corpo, resistente
+	Count UMETA(Hidden)
+};
+
+/**
+ * Descrizione:
+ * Riga della DataTable degli archetipi (il nome della riga è quello dell'archetipo: "Sniper", "Brawler").
+ * Contiene statistiche, regole di contrattacco e aspetto grafico: un cambio di bilanciamento
+ * non richiede di ricompilare.
+ */
+USTRUCT(BlueprintType)
+struct PAASCHIFANOFRANCESCO_API FUnitArchetypeRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Stats")
+	int32 MaxHealth = 20;
+
+	UPROPERTY(EditAnywhere, Category = "Stats")
+	int32 MovementRange = 3;
+
+	UPROPERTY(EditAnywhere, Category = "Stats")
+	int32 AttackRange = 1;
+
+	UPROPERTY(EditAnywhere, Category = "Stats")
+	int32 MinDamage = 1;
+
+	UPROPERTY(EditAnywhere, Category = "Stats")
+	int32 MaxDamage = 3;
+
+	/** Attacco a distanza (Sniper) */
+	UPROPERTY(EditAnywhere, Category = "Stats")
+	bool bRanged = false;
+
+	/** Un attacco di questo archetipo provoca il contrattacco del difensore sopravvissuto */
+	UPROPERTY(EditAnywhere, Category = "Counter")
+	bool bProvokesCounter = false;
+
+	/** Da difensore contrattacca anche se l'attaccante non è adiacente */
+	UPROPERTY(EditAnywhere, Category = "Counter")
+	bool bCountersAtRange = false;
+
+	/** Danno del contrattacco inflitto da questo archetipo */
+	UPROPERTY(EditAnywhere, Category = "Counter")
+	int32 CounterMinDamage = 1;
+
+	UPROPERTY(EditAnywhere, Category = "Counter")
+	int32 CounterMaxDamage = 3;
+
+	UPROPERTY(EditAnywhere, Category = "Visuals")
+	TSoftObjectPtr<UStaticMesh> Mesh;
+
+	UPROPERTY(EditAnywhere, Category = "Visuals")
+	FVector MeshScale = FVector::OneVector;
+
+	UPROPERTY(EditAnywhere, Category = "Visuals")
+	TSoftObjectPtr<UMaterialInterface> PlayerMaterial;
+
+	UPROPERTY(EditAnywhere, Category = "Visuals")
+	TSoftObjectPtr<UMaterialInterface> AIMaterial;
+};
+
+/**
+ * Descrizione:
+ * Statistiche di un archetipo nel formato letto a runtime: pochi byte, nessun UObject,
+ * leggibile da qualsiasi thread (IA, pondering, partite headless).
+ */
+struct FUnitArchetype
+{
+	int16 MaxHealth = 0;
+	uint8 MovementRange = 0;
+	uint8 AttackRange = 0;
+	uint8 MinDamage = 0;
+	uint8 MaxDamage = 0;
+	uint8 CounterMinDamage = 0;
+	uint8 CounterMaxDamage = 0;
+
+	bool bRanged = false;
+	bool bProvokesCounter = false;
+	bool bCountersAtRange = false;
+};
+
+/** Aspetto grafico di un archetipo (usato solo dagli attori, sul game thread) */
+struct FUnitArchetypeVisuals
+{
+	TSoftObjectPtr<UStaticMesh> Mesh;
+	FVector MeshScale = FVector::OneVector;
+	TSoftObjectPtr<UMaterialInterface> PlayerMaterial;
+	TSoftObjectPtr<UMaterialInterface> AIMaterial;
+};
+
+/**
+ * Classe: FUnitArchetypeTable
+ * Descrizione:
+ * Tabella immutabile degli archetipi, costruita una sola volta al primo accesso: dalla DataTable
+ * DefaultTablePath se presente, altrimenti dal file JSON DefaultJsonFile distribuito con il gioco;
+ * i valori predefiniti nel codice restano solo come riserva. Attori (AUnitBase),
+ * simulazione (FSimUnit, FCombatResolver, FSimMatch) e analisi (FCombatAnalytics) leggono tutti
+ * da qui tramite l'indice dell'archetipo.
+ * Il primo accesso deve avvenire sul game thread (FCombatAnalytics::WarmupArchetypes).
+ */
+class PAASCHIFANOFRANCESCO_API FUnitArchetypeTable
+{
+public:
+	/** DataTable (righe FUnitArchetypeRow) che sostituisce i valori predefiniti */
+	static constexpr const TCHAR* DefaultTablePath = TEXT("/Game/Data/DT_UnitArchetypes.DT_UnitArchetypes");
+
+	/** Archetipi in JSON, relativo alla cartella Content (usato se la DataTable non esiste) */
+	static constexpr const TCHAR* DefaultJsonFile = TEXT("Data/UnitArchetypes.json");
+
+	static const FUnitArchetypeTable& Get();
+
+	/** Statistiche dell'archetipo indicato (indice valido: 0 <= Index < Num()) */
+	const FUnitArchetype& operator[](int32 Index) const { return Archetypes[Index]; }
+	const FUnitArchetype& operator[](EUnitArchetype Archetype) const { return Archetypes[static_cast<int32>(Archetype)]; }
+
+	const FUnitArchetypeVisuals& GetVisuals(EUnitArchetype Archetype) const { return Visuals[static_cast<int32>(Archetype)]; }
+
+	int32 Num() const { return UE_ARRAY_COUNT(Archetypes); }
+
+	/** Archetipo di un'unità salvata con il solo flag di attacco a distanza (log, replay, salvataggi, registro) */
+	static EUnitArchetype FromRangedFlag(bool bRanged) { return bRanged ? EUnitArchetype::Sniper : EUnitArchetype::Brawler; }
+
+private:
+	FUnitArchetypeTable();
+
+	/** Converte e valida una riga (intervalli non negativi, minimo <= massimo, vita almeno 1) */
+	void SetArchetype(EUnitArchetype Archetype, const FUnitArchetypeRow& Row);
+
+	FUnitArchetype Archetypes[static_cast<int32>(EUnitArchetype::Count)];
+	FUnitArchetypeVisuals Visuals[static_cast<int32>(EUnitArchetype::Count)];
+};
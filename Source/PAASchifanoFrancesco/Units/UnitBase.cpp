@@ -2,10 +2,12 @@
 
 #include "UnitBase.h"
 #include "PAASchifanoFrancesco/Core/MyGameMode.h"
+#include "PAASchifanoFrancesco/Core/GameServices.h"
 #include "MyMovementComponent.h"
+#include "UnitPool.h"
+#include "Materials/MaterialInstanceDynamic.h"
 #include "Components/StaticMeshComponent.h"
 #include "UObject/ConstructorHelpers.h"
-#include "Kismet/GameplayStatics.h"
 #include "PAASchifanoFrancesco/Input/MyPlayerController.h"
 #include "Engine/DamageEvents.h"
 
@@ -42,12 +44,20 @@ void AUnitBase::BeginPlay()
 
 	CurrentAction = EUnitAction::Idle; // A inizio partita, l’unità è in stato “Idle”
 
+	// Statistiche e aspetto dalla tabella degli archetipi (le sottoclassi indicano solo l'archetipo)
+	ApplyArchetypeStats();
+
+	const FUnitArchetypeVisuals& Visuals = FUnitArchetypeTable::Get().GetVisuals(Archetype);
+	PlayerMaterial = Visuals.PlayerMaterial.LoadSynchronous();
+	AIMaterial = Visuals.AIMaterial.LoadSynchronous();
+	SetupMesh(Visuals.Mesh.LoadSynchronous(), Visuals.MeshScale);
+
 	// Messaggio di debug per indicare che l’unità è pronta
 	UE_LOG(LogTemp, Warning, TEXT("UnitBase: %s pronto e in attesa di selezione."), *GetName());
 }
 
-// Metodo utilizzato per assegnare dinamicamente la mesh, il materiale e la scala all'unità
-void AUnitBase::SetupMesh(UStaticMesh* Mesh, UMaterialInterface* Material, const FVector& Scale)
+// Metodo utilizzato per assegnare dinamicamente la mesh, il materiale della fazione e la scala all'unità
+void AUnitBase::SetupMesh(UStaticMesh* Mesh, const FVector& Scale)
 {
 	if (Mesh)
 	{
@@ -59,29 +69,81 @@ void AUnitBase::SetupMesh(UStaticMesh* Mesh, UMaterialInterface* Material, const
 		UE_LOG(LogTemp, Error, TEXT("Mesh is NULL in SetupMesh!")); // Errore se la mesh è nulla
 	}
 
-	if (Material)
+	ApplySideMaterial();
+
+	// Imposta la scala 3D della mesh
+	MeshComponent->SetWorldScale3D(Scale);
+
+	// Salva il nome visualizzato dell'unità
+	UnitDisplayName = GetName();
+}
+
+/**
+ * Descrizione:
+ * Il materiale dipende da chi controlla l'unità e non dal turno in cui viene creata:
+ * un'unità riacquisita dal pool può cambiare fazione. Ogni istanza dinamica viene creata
+ * alla prima richiesta e poi riusata.
+ */
+void AUnitBase::ApplySideMaterial()
+{
+	UMaterialInterface* Source = bIsPlayerControlled ? PlayerMaterial : AIMaterial;
+	UMaterialInstanceDynamic*& Instance = bIsPlayerControlled ? PlayerMaterialInstance : AIMaterialInstance;
+	if (!Source)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Material is NULL in ApplySideMaterial!")); // Errore se il materiale è nullo
+		return;
+	}
+
+	if (!Instance)
 	{
 		// Crea una istanza dinamica del materiale per permettere modifiche runtime
-		UMaterialInstanceDynamic* PawnMaterial = UMaterialInstanceDynamic::Create(Material, this);
-		if (PawnMaterial)
-		{
-			MeshComponent->SetMaterial(0, PawnMaterial); // Applica il materiale alla mesh
-		}
-		else
+		Instance = UMaterialInstanceDynamic::Create(Source, this);
+		if (!Instance)
 		{
 			UE_LOG(LogTemp, Error, TEXT("Failed to create dynamic material!")); // Errore nella creazione del materiale
+			return;
 		}
 	}
-	else
-	{
-		UE_LOG(LogTemp, Error, TEXT("Material is NULL in SetupMesh!")); // Errore se il materiale è nullo
-	}
-
-	// Imposta la scala 3D della mesh
-	MeshComponent->SetWorldScale3D(Scale);
+	MeshComponent->SetMaterial(0, Instance); // Applica il materiale alla mesh
+}
 
-	// Salva il nome visualizzato dell'unità
+/**
+ * Descrizione:
+ * I valori di partenza sono quelli dell'archetipo: l'unità torna come appena spawnata,
+ * con il materiale dell'IA finché non le viene assegnata una fazione.
+ */
+void AUnitBase::ResetToArchetype()
+{
+	ApplyArchetypeStats();
+
+	TeamID = GetClass()->GetDefaultObject<AUnitBase>()->TeamID;
+	bIsPlayerControlled = false;
+	CurrentAction = EUnitAction::Idle;
+	bHasMovedThisTurn = false;
+	bIsMoving = false;
+	RegistryHandle = FUnitHandle();
 	UnitDisplayName = GetName();
+
+	ApplySideMaterial();
+}
+
+void AUnitBase::ApplyArchetypeStats()
+{
+	const FUnitArchetype& Stats = FUnitArchetypeTable::Get()[Archetype];
+	MaxHealth = Stats.MaxHealth;
+	CurrentHealth = Stats.MaxHealth;
+	AttackRange = Stats.AttackRange;
+	MinDamage = Stats.MinDamage;
+	MaxDamage = Stats.MaxDamage;
+	MovementRange = Stats.MovementRange;
+	bIsRangeAttack = Stats.bRanged;
+}
+
+void AUnitBase::SetPooled(bool bPooled)
+{
+	bInPool = bPooled;
+	SetActorHiddenInGame(bPooled);
+	SetActorEnableCollision(!bPooled);
 }
 
 // Ritorna il range di movimento dell’unità
@@ -112,6 +174,7 @@ bool AUnitBase::IsRangedAttack() const
 void AUnitBase::SetIsPlayerController(bool Condition)
 {
 	bIsPlayerControlled = Condition;
+	ApplySideMaterial(); // Il materiale segue la fazione
 }
 
 
@@ -142,43 +205,80 @@ float AUnitBase::GetHealthPercent() const
 /**
  * Descrizione:
  * Permette a questa unità di attaccare un'altra unità specificata come bersaglio.
- * Calcola un danno casuale e lo applica tramite il metodo `TakeDamage()` del bersaglio.
- * Se il bersaglio muore, viene chiamato `Die()`; altrimenti aggiorna la UI della barra vita.
+ * L'esito (danno ed eventuale contrattacco) viene calcolato da FCombatResolver con lo stream
+ * ricevuto, con le stesse regole della simulazione usata dall'IA, e poi applicato:
+ * 1. Registra nella history i valori effettivamente applicati.
+ * 2. Applica il danno al bersaglio tramite `TakeDamage()`; se muore viene chiamato `Die()`.
+ * 3. Applica l'eventuale contrattacco all'attaccante.
+ * 4. Aggiorna le barre della vita nel widget di status.
  */
-void AUnitBase::AttackUnit(AUnitBase* Target)
+FCombatResult AUnitBase::AttackUnit(AUnitBase* Target, FRandomStream& Stream)
 {
-	if (!Target) return; // Controllo di sicurezza sul puntatore
+	if (!Target) return FCombatResult(); // Controllo di sicurezza sul puntatore
 
-	// Calcola il danno da infliggere scegliendo un valore casuale tra MinDamage e MaxDamage
-	int32 Damage = FMath::RandRange(MinDamage, MaxDamage);
-	UE_LOG(LogTemp, Warning, TEXT("%s attacca %s con %d danni!"), *GetName(), *Target->GetName(), Damage);
+	// Riferimenti al GameMode e al widget per aggiornare la UI della salute (dal registro dei servizi)
+	const UGameServices* Services = UGameServices::Get(this);
+	AMyGameMode* GameMode = Services ? Services->GetGameMode() : nullptr;
+	UStatusGameWidget* StatusGame = Services ? Services->GetStatusWidget() : nullptr;
+	AGridManager* GridManager = Services ? Services->GetGridManager() : nullptr;
 
-	// Crea un evento danno necessario per il metodo TakeDamage
-	FPointDamageEvent DamageEvent;
-	Target->TakeDamage(Damage, DamageEvent, GetController(), this); // Infligge il danno al bersaglio
+	// Adiacenza in tile dall'indice di occupazione (stessa regola dell'anteprima e della simulazione)
+	const bool bAdjacent = GridManager && GridManager->AreUnitsAdjacent(this, Target);
+	const FCombatResult Result = FCombatResolver::Resolve(FSimUnit::FromActor(this), FSimUnit::FromActor(Target), bAdjacent, Stream);
+
+	UE_LOG(LogTemp, Warning, TEXT("%s attacca %s con %d danni!"), *GetName(), *Target->GetName(), Result.Damage);
 
-	// Ottiene riferimento al GameMode e al widget per aggiornare la UI della salute
-	AMyGameMode* GameMode = Cast<AMyGameMode>(UGameplayStatics::GetGameMode(this));
-	UStatusGameWidget* StatusGame = nullptr;
-	if (GameMode)
+	// Log dei comandi: va scritto prima di Die(), finché entrambe le unità sono ancora sulla griglia
+	if (GameMode && GridManager)
 	{
-		StatusGame = GameMode->GetStatusGameWidget();
+		const int32 AttackerTile = GridManager->GetTileIndex(GridManager->FindTileAtLocation(GetActorLocation()));
+		const int32 TargetTile = GridManager->GetTileIndex(GridManager->FindTileAtLocation(Target->GetActorLocation()));
+		FMatchCommandLog& CommandLog = GameMode->GetCommandLog();
+		CommandLog.AppendAttack(IsPlayerControlled(), IsRangedAttack(), AttackerTile, TargetTile, Result.Damage, GetTeamID());
+
+		if (Result.bCountered)
+		{
+			CommandLog.AppendCounter(Target->IsPlayerControlled(), Target->IsRangedAttack(), TargetTile, AttackerTile, Result.CounterDamage, Target->GetTeamID());
+		}
 	}
-	
+
+	// Crea un evento danno necessario per il metodo TakeDamage
+	FPointDamageEvent DamageEvent;
+	Target->TakeDamage(Result.Damage, DamageEvent, GetController(), this); // Infligge il danno al bersaglio
+
 	// Se il bersaglio è morto dopo l’attacco, viene rimosso dal gioco
 	if (Target->IsDead())
 	{
 		Target->Die(Target);
 	}
+	else if (StatusGame)
+	{
+		// Altrimenti, aggiorna la barra vita nel widget di status
+		StatusGame->UpdateUnitHealth(Target, Target->GetHealthPercent());
+	}
 	else
 	{
-		if (!StatusGame)
+		UE_LOG(LogTemp, Error, TEXT("StatusGame è NULL in AttackUnit!"));
+	}
+
+	if (Result.bCountered)
+	{
+		UE_LOG(LogTemp, Warning, TEXT(" Contrattacco! %s infligge %d danni a %s"), *Target->GetName(), Result.CounterDamage, *GetName());
+
+		// Applica il danno del contrattacco all'attaccante
+		TakeDamage(Result.CounterDamage, DamageEvent, nullptr, Target);
+
+		if (IsDead())
 		{
-			UE_LOG(LogTemp, Error, TEXT("StatusGame è NULL in AttackUnit!"));
+			Die(this);
+		}
+		else if (StatusGame)
+		{
+			StatusGame->UpdateUnitHealth(this, GetHealthPercent());
 		}
-		// Altrimenti, aggiorna la barra vita nel widget di status
-		StatusGame->UpdateUnitHealth(Target, Target->GetHealthPercent());
 	}
+
+	return Result;
 }
 
 /**
@@ -221,6 +321,13 @@ float AUnitBase::TakeDamage(float DamageAmount, const FDamageEvent& DamageEvent,
 		CurrentHealth -= Damage;
 	}
 	
+	// Allinea la colonna della vita nel registro
+	const UGameServices* Services = UGameServices::Get(this);
+	if (AMyGameMode* GameMode = Services ? Services->GetGameMode() : nullptr)
+	{
+		GameMode->GetUnitRegistry().SetHealth(RegistryHandle, CurrentHealth);
+	}
+
 	// Messaggio di debug con stato aggiornato
 	UE_LOG(LogTemp, Warning, TEXT("%s ha subito %f danni! HP rimanenti: %d"), *GetName(), Damage, CurrentHealth);
 
@@ -238,52 +345,56 @@ float AUnitBase::TakeDamage(float DamageAmount, const FDamageEvent& DamageEvent,
  */
 void AUnitBase::Die(AUnitBase* Unit)
 {
-	// Controlla se l’unità è già in fase di distruzione
-	if (IsPendingKillPending()) return;
+	// Controlla se l’unità è già in fase di distruzione o già tornata nel pool
+	if (IsPendingKillPending() || bInPool) return;
 
-	// Recupera il GameMode
-	AMyGameMode* GameMode = Cast<AMyGameMode>(UGameplayStatics::GetGameMode(this));
+	// Recupera il GameMode dal registro dei servizi
+	const UGameServices* Services = UGameServices::Get(this);
+	AMyGameMode* GameMode = Services ? Services->GetGameMode() : nullptr;
 	if (!GameMode) return;
 
 	// Libera la tile occupata, settando HasPawn = false
-	if (AGridManager* GridManager = GameMode->GetGridManager())
+	if (AGridManager* GridManager = Services->GetGridManager())
 	{
 		ATile* Tile = GridManager->FindTileAtLocation(GetActorLocation());
 		if (Tile)
 		{
+			GameMode->GetCommandLog().AppendDeath(IsPlayerControlled(), IsRangedAttack(), GridManager->GetTileIndex(Tile), GetTeamID());
 			Tile->SetHasPawn(false);
+			GridManager->SetUnitTile(this, INDEX_NONE);
 			UE_LOG(LogTemp, Warning, TEXT("Tile %s liberata"), *Tile->GetName());
 		}
 	}
 
 	// Rimuove la barra della vita dal widget dello status
-	if (UStatusGameWidget* Status = GameMode->GetStatusGameWidget())
+	if (UStatusGameWidget* Status = Services->GetStatusWidget())
 	{
 		Status->RemoveUnitStatus(Unit);
 	}
 
-	// Rimuove l’unità dalla lista corretta (player o AI)
-	if (IsPlayerControlled())
+	// Rimuove l’unità dal registro (gli handle che la riferiscono non sono più validi)
+	FUnitRegistry& Registry = GameMode->GetUnitRegistry();
+	Registry.Remove(RegistryHandle);
+
+	// Rimette l'unità nel pool invece di distruggerla (verrà riusata dal prossimo piazzamento)
+	if (UUnitPool* Pool = UUnitPool::Get(this))
 	{
-		GameMode->PlayerUnits.Remove(Unit);
+		Pool->Release(this);
 	}
 	else
 	{
-		GameMode->AIUnits.Remove(Unit);
+		Destroy();
 	}
 
-	// Distrugge fisicamente l’unità nella scena
-	Destroy();
-
 	// Logga quante unità restano in gioco
-	UE_LOG(LogTemp, Warning, TEXT("PlayerUnits.Num(): %d"), GameMode->PlayerUnits.Num());
-	UE_LOG(LogTemp, Warning, TEXT("AIUnits.Num(): %d"), GameMode->AIUnits.Num());
+	UE_LOG(LogTemp, Warning, TEXT("Unità %s rimaste: %d, unità in gioco: %d"),
+		*FSimBoard::GetTeamName(TeamID), Registry.Num(TeamID), Registry.Num());
 
-	// Controlla se il gioco deve terminare (una delle due liste è vuota)
-	if (GameMode->PlayerUnits.Num() == 0 || GameMode->AIUnits.Num() == 0)
+	// Controlla se il gioco deve terminare (è rimasta una sola squadra con unità)
+	if (Registry.GetAliveTeamsMask() == 0 || Registry.GetLastTeamStanding() != INDEX_NONE)
 	{
 		// Determina il vincitore
-		FString Winner = GameMode->PlayerUnits.Num() == 0 ? TEXT("AI") : TEXT("Player");
+		FString Winner = GameMode->GetWinnerName();
 
 		// Imposta la fase di fine gioco
 		GameMode->SetGamePhase(EGamePhase::EGameOver);
@@ -291,4 +402,28 @@ void AUnitBase::Die(AUnitBase* Unit)
 		// Mostra il widget di fine partita
 		GameMode->HandleGameOver(Winner);
 	}
-}
\ No newline at end of file
+}
+/**
+ * Eventi di mouse-over (abilitati in AMyPlayerController::BeginPlay).
+ * Il controller decide se mostrare l'anteprima dell'attacco: il calcolo avviene
+ * solo quando il cursore cambia unità.
+ */
+void AUnitBase::NotifyActorBeginCursorOver()
+{
+	Super::NotifyActorBeginCursorOver();
+
+	if (AMyPlayerController* PC = UGameServices::Get(this)->GetPlayerController())
+	{
+		PC->OnUnitHovered(this);
+	}
+}
+
+void AUnitBase::NotifyActorEndCursorOver()
+{
+	Super::NotifyActorEndCursorOver();
+
+	if (AMyPlayerController* PC = UGameServices::Get(this)->GetPlayerController())
+	{
+		PC->OnUnitUnhovered(this);
+	}
+}
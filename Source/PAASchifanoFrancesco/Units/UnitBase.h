@@ -5,8 +5,14 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
 #include "MyMovementComponent.h"
+#include "PAASchifanoFrancesco/Simulation/CombatResolver.h"
+#include "UnitRegistry.h"
+#include "UnitArchetypes.h"
 #include "UnitBase.generated.h"
 
+class UMaterialInterface;
+class UMaterialInstanceDynamic;
+
 // Delegate utilizzato per notificare che un'unità è stata selezionata
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUnitSelected, AUnitBase*, SelectedUnit);
 
@@ -63,6 +69,9 @@ public:
 	// Indica se l'unità è un'unità a distanza (Sniper)
 	bool IsRangedAttack() const;
 
+	// Archetipo dell'unità: indice nella tabella condivisa con la simulazione (FUnitArchetypeTable)
+	EUnitArchetype GetArchetype() const { return Archetype; }
+
 	// Indica se l'unità ha già effettuato un movimento durante il turno
 	UPROPERTY()
 	bool bHasMovedThisTurn = false;
@@ -108,8 +117,8 @@ public:
 	// Ritorna la vita attuale (come valore assoluto)
 	float GetHealth() const { return CurrentHealth; }
 
-	// Esegue un attacco contro un’altra unità
-	void AttackUnit(AUnitBase* Target);
+	// Esegue un attacco contro un’altra unità (con eventuale contrattacco) e ne restituisce l'esito
+	FCombatResult AttackUnit(AUnitBase* Target, FRandomStream& Stream);
 
 	// Verifica se l'unità può ancora agire in questo turno
 	bool CanAct() const;
@@ -127,10 +136,29 @@ public:
 	UFUNCTION()
 	void Die(AUnitBase* Target);
 
+	// Squadra dell'unità (0 = player, 1 = AI, le successive sono fazioni IA aggiuntive)
+	int32 GetTeamID() const { return TeamID; }
+	void SetTeamID(int32 NewTeamID) { TeamID = NewTeamID; }
+
+	// Handle dell'unità nel registro del GameMode (non valido se l'unità non è registrata)
+	FUnitHandle GetRegistryHandle() const { return RegistryHandle; }
+	void SetRegistryHandle(FUnitHandle Handle) { RegistryHandle = Handle; }
+
+	// Riporta statistiche e stato ai valori dell'archetipo (unità riacquisita dal pool)
+	void ResetToArchetype();
+
+	// Entra/esce dal pool delle unità: nel pool l'unità è nascosta e senza collisioni
+	void SetPooled(bool bPooled);
+	bool IsInPool() const { return bInPool; }
+
 protected:
 	// Funzione chiamata all’inizio del gioco
 	virtual void BeginPlay() override;
 
+	// Notifica al controller che il cursore è entrato/uscito dall'unità (anteprima attacco)
+	virtual void NotifyActorBeginCursorOver() override;
+	virtual void NotifyActorEndCursorOver() override;
+
 	// Distanza di movimento massima per turno
 	UPROPERTY(EditAnywhere, Category = "Unit Stats")
 	int32 MovementRange;
@@ -139,16 +167,37 @@ protected:
 	UPROPERTY()
 	bool bIsRangeAttack = false;
 
+	// Archetipo della classe, assegnato dal costruttore delle sottoclassi (statistiche e aspetto vengono dalla tabella)
+	UPROPERTY(VisibleDefaultsOnly, Category = "Unit")
+	EUnitArchetype Archetype = EUnitArchetype::Brawler;
+
 	// Mesh visiva dell’unità
 	UPROPERTY(VisibleAnywhere)
 	UStaticMeshComponent* MeshComponent;
 
-	// Funzione per inizializzare la mesh dell’unità
-	virtual void SetupMesh(UStaticMesh* Mesh, UMaterialInterface* Material, const FVector& Scale);
+	// Funzione per inizializzare la mesh dell’unità (il materiale dipende dalla fazione, vedi ApplySideMaterial)
+	virtual void SetupMesh(UStaticMesh* Mesh, const FVector& Scale);
+
+	// Applica il materiale della fazione (player o IA); l'istanza dinamica viene creata una sola volta per fazione
+	void ApplySideMaterial();
+
+	// Materiali del player e dell'IA, caricati dalla tabella degli archetipi in BeginPlay
+	UPROPERTY()
+	UMaterialInterface* PlayerMaterial = nullptr;
+
+	UPROPERTY()
+	UMaterialInterface* AIMaterial = nullptr;
+
+	// Istanze dinamiche dei due materiali (riusate quando l'unità torna dal pool)
+	UPROPERTY()
+	UMaterialInstanceDynamic* PlayerMaterialInstance = nullptr;
 
-	// ID della squadra (non usato attualmente, ma utile per futuri team multipli)
+	UPROPERTY()
+	UMaterialInstanceDynamic* AIMaterialInstance = nullptr;
+
+	// ID della squadra: determina alleati e nemici e la colonna del registro
 	UPROPERTY(EditAnywhere, Category = "Unit")
-	int32 TeamID;
+	int32 TeamID = 0;
 
 	// Specifica se l'unità è controllata dal giocatore
 	UPROPERTY()
@@ -156,4 +205,14 @@ protected:
 
 	// Stato corrente dell’unità (Idle, Moved, ecc.)
 	EUnitAction CurrentAction = EUnitAction::Idle;
+
+	// Posizione dell'unità nel registro (assegnata da FUnitRegistry::Add)
+	FUnitHandle RegistryHandle;
+
+	// true mentre l'unità è parcheggiata nel pool (morta o non ancora piazzata)
+	bool bInPool = false;
+
+private:
+	// Copia le statistiche dell'archetipo (vita piena)
+	void ApplyArchetypeStats();
 };
\ No newline at end of file
@@ -1,66 +1,119 @@
 #include "UnitMovementManager.h"
 #include "PAASchifanoFrancesco/Grid/GridManager.h"
 #include "PAASchifanoFrancesco/Input/MyPlayerController.h"
-#include "Kismet/GameplayStatics.h"
+#include "PAASchifanoFrancesco/Core/GameServices.h"
 
 /**
  * Descrizione:
- * Disattiva il tick dell'attore poiché non è necessario il controllo per frame.
- * Inizializza il puntatore alla unità attualmente in movimento a nullptr.
+ * Il tick dell'attore avanza tutti i movimenti: parte disattivato e viene acceso
+ * solo mentre almeno un'unità si muove.
  */
 AUnitMovementManager::AUnitMovementManager()
 {
-	PrimaryActorTick.bCanEverTick = false;  // Non serve il tick per frame
-	CurrentMovingUnit = nullptr;            // Nessuna unità in movimento all'inizio
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false; // Nessun costo per frame finché nessuno si muove
 }
 
 /**
  * Descrizione:
- * Avvia il movimento di una specifica unità lungo un percorso (`Path`) a una velocità indicata (`Speed`).
- * Questo metodo gestisce anche l'aggiornamento delle celle della griglia (tile di partenza e di arrivo),
- * collega il delegato per la fine del movimento e blocca temporaneamente l'input del giocatore.
- *
- * Parametri:
- * - Unit: puntatore all'unità da muovere
- * - Path: array di celle (ATile*) da attraversare
- * - Speed: velocità del movimento
+ * Controlli che precedono ogni movimento: parametri validi, unità non già in movimento e
+ * GridManager registrato. Chi registra il movimento prima di avviarlo (es. l'IA) lo chiama prima.
  */
-void AUnitMovementManager::MoveUnit(AUnitBase* Unit, const TArray<ATile*>& Path, float Speed)
+bool AUnitMovementManager::CanMoveUnit(const AUnitBase* Unit, const TArray<ATile*>& Path) const
 {
 	// Controlla parametri validi
-	if (!Unit || Path.Num() == 0)
+	if (!Unit || Path.Num() == 0 || !Unit->MovementComponent)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("MoveUnit: Parametri non validi!"));
-		return;
+		return false;
 	}
 
-	// Impedisce avvio di un nuovo movimento se uno è già in corso
-	if (IsMovementInProgress())
+	// Impedisce di avviare un secondo movimento per la stessa unità
+	if (IsUnitMoving(Unit))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("MoveUnit: Movimento già in corso!"));
-		return;
+		UE_LOG(LogTemp, Warning, TEXT("MoveUnit: %s è già in movimento!"), *Unit->GetName());
+		return false;
 	}
 
-	// Ottiene il GridManager per modificare le celle della griglia
-	AGridManager* GridManager = Cast<AGridManager>(UGameplayStatics::GetActorOfClass(GetWorld(), AGridManager::StaticClass()));
-	if (!GridManager)
+	// Serve il GridManager per modificare le celle della griglia
+	const UGameServices* Services = UGameServices::Get(this);
+	if (!Services || !Services->GetGridManager())
 	{
 		UE_LOG(LogTemp, Error, TEXT("MoveUnit: GridManager NON TROVATO!"));
-		return;
+		return false;
 	}
+	return true;
+}
 
-	// Verifiche extra di sicurezza
-	ensure(Unit != nullptr);
-	ensure(Path.Num() > 0);
+/**
+ * Descrizione:
+ * Avvia il movimento di una specifica unità lungo un percorso (`Path`) a una velocità indicata (`Speed`).
+ * Questo metodo gestisce anche l'aggiornamento delle celle della griglia (tile di partenza e di arrivo),
+ * collega il delegato per la fine del movimento e blocca temporaneamente l'input del giocatore.
+ *
+ * Con altri movimenti in corso il percorso viene prenotato nella tabella (tile, passo):
+ * se incrocia un'unità in viaggio, l'unità aspetta sulla tile di partenza il primo passo libero.
+ * Un passo è il tempo per percorrere una tile alla velocità del gruppo di movimenti.
+ *
+ * Parametri:
+ * - Unit: puntatore all'unità da muovere
+ * - Path: array di celle (ATile*) da attraversare
+ * - Speed: velocità del movimento (0 = istantaneo)
+ * - OnArrived: callback di arrivo di questa unità (opzionale)
+ */
+bool AUnitMovementManager::MoveUnit(AUnitBase* Unit, const TArray<ATile*>& Path, float Speed, FOnUnitArrived&& OnArrived)
+{
+	if (!CanMoveUnit(Unit, Path)) return false;
+
+	// GridManager registrato (verificato da CanMoveUnit), nessuna ricerca nel mondo
+	const UGameServices* Services = UGameServices::Get(this);
+	AGridManager* GridManager = Services->GetGridManager();
+
+	ATile* StartTile = GridManager->FindTileAtLocation(Unit->GetActorLocation());
+
+	// Prenotazione del percorso (solo per i movimenti animati: quelli istantanei non si incrociano)
+	float StartDelay = 0.f;
+	if (Speed > 0.f)
+	{
+		// Primo movimento del gruppo: l'orologio riparte e fissa la durata di un passo
+		if (!IsMovementInProgress())
+		{
+			Reservations.Reset();
+			ClockOrigin = GetWorld()->GetTimeSeconds();
+			BatchSpeed = Speed;
+			StepDuration = GridManager->GetTilePitch() / Speed;
+		}
+		Speed = BatchSpeed;
+
+		TArray<int32, TInlineAllocator<16>> PathIndices;
+		for (const ATile* Tile : Path)
+		{
+			PathIndices.Add(GridManager->GetTileIndex(Tile));
+		}
 
-	// Registra l’unità attualmente in movimento
-	CurrentMovingUnit = Unit;
+		const uint32 Owner = Unit->GetUniqueID();
+		const int32 FromIndex = GridManager->GetTileIndex(StartTile);
+		const int32 NextStep = GetNextStep();
+		Reservations.Release(Owner);
+
+		int32 Delay = Reservations.FindStartDelay(Owner, FromIndex, PathIndices, NextStep, MaxStartDelay);
+		if (Delay == INDEX_NONE)
+		{
+			// Nessun passo libero a breve: parte quando tutte le unità in viaggio sono arrivate
+			Delay = FMath::Max(0, Reservations.GetLastTransitStep() + 2 - NextStep);
+		}
+		Reservations.Reserve(Owner, FromIndex, PathIndices, NextStep + Delay);
+
+		StartDelay = static_cast<float>(ClockOrigin + (NextStep + Delay) * StepDuration - GetWorld()->GetTimeSeconds());
+	}
+
+	// Registra l'unità tra quelle in movimento (prima di avviarlo: un movimento istantaneo termina subito)
+	ActiveMoves.Add(FObjectKey(Unit), MoveTemp(OnArrived));
 
 	// Imposta lo stato a “Moved”
 	Unit->SetCurrentAction(EUnitAction::Moved);
 
 	// Libera la tile di partenza
-	ATile* StartTile = GridManager->FindTileAtLocation(Unit->GetActorLocation());
 	if (StartTile)
 	{
 		StartTile->SetHasPawn(false);
@@ -74,58 +127,281 @@ void AUnitMovementManager::MoveUnit(AUnitBase* Unit, const TArray<ATile*>& Path,
 	}
 
 	// Collega il delegato OnMovementCompleted della MovementComponent
-	if (Unit->MovementComponent)
+	// Rimuove prima eventuali bind per evitare duplicazioni
+	Unit->MovementComponent->OnMovementCompleted.RemoveDynamic(this, &AUnitMovementManager::OnUnitMovementComplete);
+	Unit->MovementComponent->OnMovementCompleted.AddDynamic(this, &AUnitMovementManager::OnUnitMovementComplete);
+
+	// Blocca l'input del player durante il movimento
+	// (prima di avviarlo: un movimento istantaneo termina, e sblocca l'input, qui sotto)
+	if (AMyPlayerController* MyPC = Services->GetPlayerController())
 	{
-		// Rimuove prima eventuali bind per evitare duplicazioni
-		Unit->MovementComponent->OnMovementCompleted.RemoveDynamic(this, &AUnitMovementManager::OnUnitMovementComplete);
-		Unit->MovementComponent->OnMovementCompleted.AddDynamic(this, &AUnitMovementManager::OnUnitMovementComplete);
+		MyPC->SetMovementLocked(true);
 	}
 
 	// Avvia il movimento fisico
-	Unit->MovementComponent->StartMovement(Path, Speed);
+	Unit->MovementComponent->BeginMovement(Path);
 
-	// Blocca l'input del player durante il movimento
-	if (APlayerController* PC = UGameplayStatics::GetPlayerController(Unit, 0))
+	// Velocità nulla = movimento istantaneo: l'unità viene posizionata direttamente sull'ultima tile
+	if (Speed <= 0.f)
+	{
+		Unit->SetActorLocation(EndTile->GetPawnSpawnLocation());
+		Unit->MovementComponent->FinishMovement();
+		return true;
+	}
+
+	TArray<FVector, TInlineAllocator<16>> Points;
+	float PolylineLength = 0.f;
+	FVector Previous = Unit->GetActorLocation();
+	for (const ATile* Tile : Path)
 	{
-		if (AMyPlayerController* MyPC = Cast<AMyPlayerController>(PC))
+		Points.Add(Tile->GetPawnSpawnLocation());
+		PolylineLength += FVector::Dist(Previous, Points.Last());
+		Previous = Points.Last();
+	}
+
+	FMovementTrack& Track = Tracks.AddDefaulted_GetRef();
+	Track.Unit = Unit;
+	Track.Key = FObjectKey(Unit);
+	Track.Spline.Build(Unit->GetActorLocation(), Points);
+
+	// Tile ripetute (percorsi cooperativi): l'unità si ferma lì per un passo per ogni ripetizione
+	for (int32 Index = 0; Index < Path.Num(); ++Index)
+	{
+		const ATile* PreviousTile = Index > 0 ? Path[Index - 1] : StartTile;
+		if (Path[Index] != PreviousTile) continue;
+
+		const float Distance = Track.Spline.GetPointDistance(Index);
+		if (Track.Pauses.Num() > 0 && Track.Pauses.Last().Distance == Distance)
+		{
+			Track.Pauses.Last().Remaining += StepDuration;
+		}
+		else
 		{
-			MyPC->SetMovementLocked(true);
+			Track.Pauses.Add({ Distance, StepDuration });
 		}
 	}
+
+	// La curva taglia gli angoli ed è più corta della spezzata: la velocità viene riscalata
+	// perché la durata resti quella delle prenotazioni (un passo per tile, le soste a parte)
+	const float SplineLength = Track.Spline.GetLength();
+	const float TrackSpeed = PolylineLength > KINDA_SMALL_NUMBER ? Speed * SplineLength / PolylineLength : Speed;
+	TrackSpeeds.Add(TrackSpeed);
+	TrackDistances.Add(-FMath::Max(0.f, StartDelay) * TrackSpeed);
+
+	SetActorTickEnabled(true);
+	return true;
+}
+
+/**
+ * Descrizione:
+ * Avanza in blocco le distanze di tutte le tracce e legge le posizioni dalle tabelle delle curve
+ * (FPathSpline::EvaluateBatch). La distanza dipende solo dal tempo trascorso, quindi gli arrivi
+ * sulle tile non dipendono dal frame rate e le prenotazioni restano allineate.
+ * Le unità arrivate vengono notificate dopo il ciclo, perché le callback possono avviare nuovi movimenti.
+ */
+void AUnitMovementManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Unità distrutte durante il movimento: le tracce vengono scartate e la callback riceve nullptr
+	// (l'attore non è più utilizzabile), così il gruppo di movimenti può comunque concludersi
+	TArray<FOnUnitArrived, TInlineAllocator<2>> Dropped;
+	for (int32 Index = Tracks.Num() - 1; Index >= 0; --Index)
+	{
+		if (!Tracks[Index].Unit.IsValid())
+		{
+			FOnUnitArrived OnArrived;
+			ActiveMoves.RemoveAndCopyValue(Tracks[Index].Key, OnArrived);
+			Dropped.Add(MoveTemp(OnArrived));
+			RemoveTrackAtSwap(Index);
+		}
+	}
+	if (Dropped.Num() > 0)
+	{
+		if (!IsMovementInProgress())
+		{
+			Reservations.Reset();
+		}
+		for (FOnUnitArrived& OnArrived : Dropped)
+		{
+			if (OnArrived)
+			{
+				OnArrived(nullptr);
+			}
+		}
+	}
+
+	const int32 NumTracks = Tracks.Num();
+	TArray<const FPathSpline*, TInlineAllocator<16>> Splines;
+	TArray<FVector, TInlineAllocator<16>> Positions;
+	Splines.SetNumUninitialized(NumTracks);
+	Positions.SetNumUninitialized(NumTracks);
+	for (int32 Index = 0; Index < NumTracks; ++Index)
+	{
+		Splines[Index] = &Tracks[Index].Spline;
+	}
+
+	FPathSpline::AdvanceBatch(TrackDistances, TrackSpeeds, DeltaTime);
+	for (int32 Index = 0; Index < NumTracks; ++Index)
+	{
+		if (Tracks[Index].Pauses.Num() > 0)
+		{
+			ApplyPauses(Tracks[Index], TrackDistances[Index], TrackSpeeds[Index]);
+		}
+	}
+	FPathSpline::EvaluateBatch(Splines, TrackDistances, Positions);
+
+	TArray<AUnitBase*, TInlineAllocator<8>> Arrived;
+
+	for (int32 Index = NumTracks - 1; Index >= 0; --Index)
+	{
+		// Ancora in attesa sulla tile di partenza
+		if (TrackDistances[Index] <= 0.f)
+		{
+			continue;
+		}
+
+		FMovementTrack& Track = Tracks[Index];
+		Track.Unit->SetActorLocation(Positions[Index]);
+
+		if (TrackDistances[Index] >= Track.Spline.GetLength() && Track.Pauses.Num() == 0)
+		{
+			Arrived.Add(Track.Unit.Get());
+			RemoveTrackAtSwap(Index);
+		}
+	}
+
+	if (Tracks.Num() == 0)
+	{
+		SetActorTickEnabled(false);
+	}
+
+	for (AUnitBase* Unit : Arrived)
+	{
+		if (IsValid(Unit) && Unit->MovementComponent)
+		{
+			Unit->MovementComponent->FinishMovement();
+		}
+	}
+}
+
+/**
+ * Descrizione:
+ * La distanza percorsa oltre una sosta viene convertita in tempo: finché il tempo non copre l'attesa
+ * residua l'unità resta ferma sulla sosta, il tempo in eccesso riparte dalla sosta alla stessa velocità.
+ */
+void AUnitMovementManager::ApplyPauses(FMovementTrack& Track, float& Distance, float Speed)
+{
+	while (Track.Pauses.Num() > 0 && Distance >= Track.Pauses[0].Distance)
+	{
+		FMovementPause& Pause = Track.Pauses[0];
+		const float Overshoot = (Distance - Pause.Distance) / Speed;
+		if (Overshoot <= Pause.Remaining)
+		{
+			Pause.Remaining -= Overshoot;
+			Distance = Pause.Distance;
+			return;
+		}
+
+		Distance = Pause.Distance + (Overshoot - Pause.Remaining) * Speed;
+		Track.Pauses.RemoveAt(0, 1, EAllowShrinking::No);
+	}
+}
+
+void AUnitMovementManager::RemoveTrackAtSwap(int32 Index)
+{
+	Tracks.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	TrackDistances.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	TrackSpeeds.RemoveAtSwap(Index, 1, EAllowShrinking::No);
 }
 
 /**
  * Descrizione:
  * Viene chiamato automaticamente quando una unità ha terminato il proprio movimento.
- * Rimuove il riferimento all’unità corrente e notifica a chi è in ascolto del delegato.
+ * Rimuove l'unità da quelle in movimento, notifica chi è in ascolto del delegato
+ * e infine esegue la callback del singolo movimento.
  */
-void AUnitMovementManager::OnUnitMovementComplete()
+void AUnitMovementManager::OnUnitMovementComplete(AUnitBase* MovedUnit)
 {
-	if (CurrentMovingUnit)
+	FOnUnitArrived OnArrived;
+	if (!MovedUnit || !ActiveMoves.RemoveAndCopyValue(FObjectKey(MovedUnit), OnArrived))
 	{
-		// Logga il completamento
-		UE_LOG(LogTemp, Warning, TEXT("Movimento completato per %s"), *CurrentMovingUnit->GetName());
+		// Movimento non avviato dal manager (errore logico)
+		UE_LOG(LogTemp, Error, TEXT("OnUnitMovementComplete chiamato per un'unità che non era in movimento!"));
+		return;
+	}
 
-		// Notifica tramite delegato chi ha terminato il movimento
-		OnMovementFinished.Broadcast(CurrentMovingUnit);
+	// Logga il completamento
+	UE_LOG(LogTemp, Warning, TEXT("Movimento completato per %s (%d ancora in movimento)"), *MovedUnit->GetName(), ActiveMoves.Num());
 
-		// Resetta il riferimento
-		CurrentMovingUnit = nullptr;
+	// Gruppo concluso: le prenotazioni non servono più
+	if (!IsMovementInProgress())
+	{
+		Reservations.Reset();
 	}
-	else
+
+	// Notifica tramite delegato chi ha terminato il movimento
+	OnMovementFinished.Broadcast(MovedUnit);
+
+	if (OnArrived)
 	{
-		// In caso il puntatore sia già nullo (errore logico)
-		UE_LOG(LogTemp, Error, TEXT("OnUnitMovementComplete chiamato, ma CurrentMovingUnit è NULL!"));
+		OnArrived(MovedUnit);
 	}
 }
 
 /**
  * Descrizione:
- * Restituisce true se attualmente c'è un'unità in movimento.
- * Utile per evitare sovrapposizione di movimenti.
+ * Rimuove la traccia (se l'unità non è già arrivata in questo frame), libera le prenotazioni dell'unità
+ * e annulla il movimento sul componente senza finalizzarlo, poi esegue la callback del movimento.
  */
-bool AUnitMovementManager::IsMovementInProgress() const
+void AUnitMovementManager::CancelMove(AUnitBase* Unit)
 {
-	return CurrentMovingUnit != nullptr;
+	FOnUnitArrived OnArrived;
+	if (!Unit || !ActiveMoves.RemoveAndCopyValue(FObjectKey(Unit), OnArrived))
+	{
+		return;
+	}
+
+	const FObjectKey Key(Unit);
+	const int32 TrackIndex = Tracks.IndexOfByPredicate([&Key](const FMovementTrack& Track) { return Track.Key == Key; });
+	if (TrackIndex != INDEX_NONE)
+	{
+		RemoveTrackAtSwap(TrackIndex);
+	}
+	if (Tracks.Num() == 0)
+	{
+		SetActorTickEnabled(false);
+	}
+
+	Reservations.Release(Unit->GetUniqueID());
+	if (!IsMovementInProgress())
+	{
+		Reservations.Reset();
+	}
+
+	if (Unit->MovementComponent)
+	{
+		Unit->MovementComponent->OnMovementCompleted.RemoveDynamic(this, &AUnitMovementManager::OnUnitMovementComplete);
+		Unit->MovementComponent->CancelMovement();
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("Movimento annullato per %s (%d ancora in movimento)"), *Unit->GetName(), ActiveMoves.Num());
+
+	if (OnArrived)
+	{
+		OnArrived(Unit);
+	}
 }
 
+/**
+ * Descrizione:
+ * Primo confine di passo non ancora iniziato: un nuovo movimento parte sempre all'inizio di un passo,
+ * così le sue tile vengono raggiunte negli stessi istanti delle unità già in viaggio.
+ */
+int32 AUnitMovementManager::GetNextStep() const
+{
+	if (StepDuration <= 0.f) return 0;
+
+	const double Elapsed = GetWorld()->GetTimeSeconds() - ClockOrigin;
+	return FMath::CeilToInt32(Elapsed / StepDuration);
+}
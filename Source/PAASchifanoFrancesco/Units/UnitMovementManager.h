@@ -5,6 +5,9 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "UnitBase.h"
+#include "MovementReservationTable.h"
+#include "PathSpline.h"
+#include "UObject/ObjectKey.h"
 #include "UnitMovementManager.generated.h"
 
 /**
@@ -20,6 +23,16 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUnitMovementFinished, AUnitBase*,
  * - Eseguire il movimento delle unità lungo un percorso specificato (array di celle ATile*)
  * - Aggiornare lo stato delle celle di partenza e arrivo
  * - Notificare tramite delegato il completamento del movimento
+ *
+ * Più unità possono muoversi contemporaneamente: ogni movimento prenota le proprie tile
+ * per timestep (FMovementReservationTable) e, se il percorso incrocia quello di un'unità già in viaggio,
+ * parte con qualche passo di ritardo invece di attraversarla. Ogni movimento può avere
+ * una propria callback di arrivo, oltre al delegato comune OnMovementFinished.
+ *
+ * Ogni percorso viene trasformato una volta in una curva (FPathSpline) con tabella della lunghezza d'arco;
+ * nel tick del manager le distanze percorse di tutte le unità avanzano in blocco (SIMD) e ogni posizione
+ * si legge dalla tabella in O(1). Il tick è attivo solo mentre ci sono movimenti in corso
+ * e le unità ferme non hanno tick.
  */
 UCLASS()
 class PAASCHIFANOFRANCESCO_API AUnitMovementManager : public AActor
@@ -28,9 +41,15 @@ class PAASCHIFANOFRANCESCO_API AUnitMovementManager : public AActor
 
 public:
 
+	/** Callback di arrivo di un singolo movimento */
+	using FOnUnitArrived = TFunction<void(AUnitBase*)>;
+
 	/** Costruttore di default */
 	AUnitMovementManager();
 
+	/** Avanza tutti i movimenti in corso */
+	virtual void Tick(float DeltaTime) override;
+
 	/**
 	 * Delegate che viene attivato alla fine del movimento di un'unità.
 	 * Utilizzato per informare GameMode, PlayerController o altri manager.
@@ -40,28 +59,93 @@ public:
 
 	/**
 	 * Metodo principale per avviare il movimento di una unità lungo un percorso definito.
-	 * 
+	 *
 	 * @param Unit - L'unità da muovere
-	 * @param Path - Il percorso da seguire, composto da celle (ATile*)
-	 * @param Speed - La velocità del movimento
+	 * @param Path - Il percorso da seguire, composto da celle (ATile*); una tile ripetuta è un passo di attesa
+	 * @param Speed - La velocità del movimento (con altri movimenti in corso si usa la loro velocità)
+	 * @param OnArrived - Chiamata quando questa unità arriva (dopo OnMovementFinished)
+	 * @return false se il movimento non è partito (parametri non validi o unità già in movimento)
+	 */
+	bool MoveUnit(AUnitBase* Unit, const TArray<ATile*>& Path, float Speed, FOnUnitArrived&& OnArrived = nullptr);
+
+	/** true se MoveUnit avvierebbe il movimento (parametri validi, unità ferma, griglia registrata) */
+	bool CanMoveUnit(const AUnitBase* Unit, const TArray<ATile*>& Path) const;
+
+	/**
+	 * Interrompe il movimento dell'unità (unità morta o rimessa nel pool): traccia e prenotazioni vengono
+	 * rimosse e la callback di arrivo viene chiamata, così chi attende il gruppo di movimenti non resta bloccato.
+	 * L'unità non occupa la tile di destinazione e OnMovementFinished non viene emesso.
+	 * Nessun effetto se l'unità non si sta muovendo.
 	 */
-	void MoveUnit(AUnitBase* Unit, const TArray<ATile*>& Path, float Speed);
+	void CancelMove(AUnitBase* Unit);
+
+	/** true se almeno un'unità si sta muovendo */
+	bool IsMovementInProgress() const { return ActiveMoves.Num() > 0; }
+
+	/** Numero di unità che si stanno muovendo */
+	int32 GetNumActiveMoves() const { return ActiveMoves.Num(); }
+
+	/** true se l'unità indicata si sta muovendo */
+	bool IsUnitMoving(const AUnitBase* Unit) const { return ActiveMoves.Contains(FObjectKey(Unit)); }
 
 private:
 
 	/**
-	 * Callback privata chiamata automaticamente quando il movimento termina.
-	 * Emette il delegato OnMovementFinished e pulisce lo stato interno.
+	 * Callback privata chiamata automaticamente quando il movimento di un'unità termina.
+	 * Emette il delegato OnMovementFinished, la callback del movimento e libera le prenotazioni.
 	 */
 	UFUNCTION()
-	void OnUnitMovementComplete();
+	void OnUnitMovementComplete(AUnitBase* MovedUnit);
+
+	/** Sosta lungo il percorso: una o più attese di un passo sulla stessa tile */
+	struct FMovementPause
+	{
+		float Distance = 0.f;
+		float Remaining = 0.f;
+	};
 
 	/**
-	 * Metodo interno che restituisce true se un'unità è attualmente in movimento.
-	 * Utile per bloccare doppi movimenti o comportamenti errati.
+	 * Movimento animato: unità, curva del percorso e soste (in ordine di distanza).
+	 * L'unità è un riferimento debole (il manager non la trattiene dal GC); Key resta valida anche
+	 * dopo la distruzione dell'attore e permette di togliere il movimento da ActiveMoves.
 	 */
-	bool IsMovementInProgress() const;
+	struct FMovementTrack
+	{
+		TWeakObjectPtr<AUnitBase> Unit;
+		FObjectKey Key;
+		FPathSpline Spline;
+		TArray<FMovementPause, TInlineAllocator<2>> Pauses;
+	};
+
+	/** Trattiene la distanza della traccia sulla prima sosta raggiunta finché l'attesa non è finita */
+	static void ApplyPauses(FMovementTrack& Track, float& Distance, float Speed);
+
+	/**
+	 * Movimenti animati in corso, compatti: l'ordine cambia quando un movimento termina.
+	 * Distanze e velocità sono colonne parallele a Tracks, per avanzarle in blocco.
+	 * Una distanza negativa è l'attesa sulla tile di partenza (prenotazioni): la curva resta all'inizio.
+	 */
+	TArray<FMovementTrack> Tracks;
+	TArray<float> TrackDistances;
+	TArray<float> TrackSpeeds;
+
+	/** Rimuove la traccia Index da tutte le colonne */
+	void RemoveTrackAtSwap(int32 Index);
+
+	/** Passo corrente dell'orologio dei movimenti (arrotondato al passo successivo) */
+	int32 GetNextStep() const;
+
+	/** Movimenti in corso per chiave dell'unità, con la callback di arrivo di ciascuno */
+	TMap<FObjectKey, FOnUnitArrived> ActiveMoves;
+
+	/** Prenotazioni (tile, passo) dei movimenti in corso */
+	FMovementReservationTable Reservations;
+
+	/** Origine dell'orologio e durata di un passo (una tile) del gruppo di movimenti in corso */
+	double ClockOrigin = 0.0;
+	float StepDuration = 0.f;
+	float BatchSpeed = 0.f;
 
-	/** Puntatore all'unità che si sta muovendo attualmente (nullptr se nessuna) */
-	AUnitBase* CurrentMovingUnit;
+	/** Ritardo massimo (in passi) cercato nella tabella; oltre, l'unità parte a transiti conclusi */
+	static constexpr int32 MaxStartDelay = 16;
 };
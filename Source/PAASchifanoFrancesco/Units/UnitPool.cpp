@@ -0,0 +1,102 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "UnitPool.h"
+#include "UnitBase.h"
+#include "UnitMovementManager.h"
+#include "PAASchifanoFrancesco/Core/GameServices.h"
+#include "Engine/World.h"
+
+namespace
+{
+	/** Posizione delle unità nel pool: sotto la griglia, lontano da ogni tile */
+	const FVector PoolParkingLocation(0.f, 0.f, -10000.f);
+}
+
+UUnitPool* UUnitPool::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UUnitPool>() : nullptr;
+}
+
+AUnitBase* UUnitPool::Acquire(TSubclassOf<AUnitBase> UnitClass, const FVector& Location)
+{
+	if (!UnitClass) return nullptr;
+
+	if (FUnitPoolBucket* Bucket = FreeUnits.Find(UnitClass.Get()))
+	{
+		while (Bucket->Units.Num() > 0)
+		{
+			AUnitBase* Unit = Bucket->Units.Pop(EAllowShrinking::No);
+			if (!IsValid(Unit)) continue;
+
+			Unit->ResetToArchetype();
+			Unit->SetActorLocation(Location);
+			Unit->SetPooled(false);
+			return Unit;
+		}
+	}
+
+	return SpawnUnit(UnitClass.Get(), Location);
+}
+
+/**
+ * Descrizione:
+ * L'unità conserva lo stato con cui è morta (vita a zero) finché non viene riacquisita:
+ * chi ne legge ancora i dati nello stesso frame la vede morta e non già ripristinata.
+ */
+void UUnitPool::Release(AUnitBase* Unit)
+{
+	if (!IsValid(Unit) || Unit->IsInPool()) return;
+
+	// Un movimento in corso viene annullato: l'unità nascosta non deve arrivare né rioccupare la griglia
+	if (const UGameServices* Services = UGameServices::Get(this))
+	{
+		if (AUnitMovementManager* MovementManager = Services->GetMovementManager())
+		{
+			MovementManager->CancelMove(Unit);
+		}
+	}
+
+	Unit->SetPooled(true);
+	Unit->SetActorLocation(PoolParkingLocation);
+	FreeUnits.FindOrAdd(Unit->GetClass()).Units.Add(Unit);
+}
+
+void UUnitPool::Prewarm(TSubclassOf<AUnitBase> UnitClass, int32 Count)
+{
+	if (!UnitClass) return;
+
+	FUnitPoolBucket& Bucket = FreeUnits.FindOrAdd(UnitClass.Get());
+	Bucket.Units.Reserve(Count);
+	while (Bucket.Units.Num() < Count)
+	{
+		AUnitBase* Unit = SpawnUnit(UnitClass.Get(), PoolParkingLocation);
+		if (!Unit) return;
+
+		Unit->SetPooled(true);
+		Bucket.Units.Add(Unit);
+	}
+}
+
+int32 UUnitPool::GetNumFree(TSubclassOf<AUnitBase> UnitClass) const
+{
+	const FUnitPoolBucket* Bucket = FreeUnits.Find(UnitClass.Get());
+	return Bucket ? Bucket->Units.Num() : 0;
+}
+
+AUnitBase* UUnitPool::SpawnUnit(UClass* UnitClass, const FVector& Location)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AUnitBase* Unit = GetWorld()->SpawnActor<AUnitBase>(UnitClass, Location, FRotator::ZeroRotator, SpawnParams);
+	if (Unit)
+	{
+		++NumSpawned;
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("UnitPool: spawn fallito per %s"), *UnitClass->GetName());
+	}
+	return Unit;
+}
@@ -0,0 +1,60 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnitPool.generated.h"
+
+class AUnitBase;
+
+/** Unità libere di una stessa classe */
+USTRUCT()
+struct FUnitPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AUnitBase*> Units;
+};
+
+/**
+ * Classe: UUnitPool
+ * Descrizione:
+ * Pool delle unità, uno per mondo. Un'unità morta non viene distrutta: viene nascosta, senza collisioni,
+ * e parcheggiata sotto la griglia finché un nuovo piazzamento (o un caricamento) non la richiede.
+ * All'uscita dal pool l'unità torna ai valori della propria classe (ResetToArchetype): niente spawn,
+ * BeginPlay o creazione dei materiali dinamici, e nessun attore distrutto da raccogliere.
+ */
+UCLASS()
+class PAASCHIFANOFRANCESCO_API UUnitPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Pool del mondo dell'oggetto (nullptr senza mondo) */
+	static UUnitPool* Get(const UObject* WorldContextObject);
+
+	/** Unità della classe indicata, in gioco sulla posizione data: dal pool se disponibile, altrimenti spawnata */
+	AUnitBase* Acquire(TSubclassOf<AUnitBase> UnitClass, const FVector& Location);
+
+	/** Rimette l'unità nel pool (deve essere già fuori da registro, griglia e widget) */
+	void Release(AUnitBase* Unit);
+
+	/** Porta a Count le unità libere della classe, spawnandole subito (es. a inizio piazzamento) */
+	void Prewarm(TSubclassOf<AUnitBase> UnitClass, int32 Count);
+
+	/** Unità libere della classe indicata */
+	int32 GetNumFree(TSubclassOf<AUnitBase> UnitClass) const;
+
+	/** Unità spawnate dal pool dall'inizio del mondo */
+	int32 GetNumSpawned() const { return NumSpawned; }
+
+private:
+	AUnitBase* SpawnUnit(UClass* UnitClass, const FVector& Location);
+
+	UPROPERTY()
+	TMap<UClass*, FUnitPoolBucket> FreeUnits;
+
+	int32 NumSpawned = 0;
+};
@@ -0,0 +1,150 @@
+// Creato da: Schifano Francesco 5469994
+
+#include "UnitRegistry.h"
+#include "UnitBase.h"
+
+FUnitHandle FUnitRegistry::Add(AUnitBase* Unit)
+{
+	if (!Unit) return FUnitHandle();
+
+	int32 SlotIndex;
+	if (FreeSlots.Num() > 0)
+	{
+		SlotIndex = FreeSlots.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		SlotIndex = Slots.AddDefaulted();
+	}
+
+	const int32 Team = FMath::Clamp(Unit->GetTeamID(), 0, MaxTeams - 1);
+	FColumns& Columns = Teams[Team];
+
+	FSlot& Slot = Slots[SlotIndex];
+	Slot.Team = Team;
+	Slot.DenseIndex = Columns.Num();
+
+	FUnitHandle Handle;
+	Handle.Index = SlotIndex;
+	Handle.Generation = Slot.Generation;
+
+	Columns.Actors.Add(Unit);
+	Columns.Handles.Add(Handle);
+	Columns.Health.Add(static_cast<int16>(Unit->CurrentHealth));
+	Columns.MaxHealth.Add(static_cast<int16>(Unit->MaxHealth));
+	Columns.MovementRange.Add(static_cast<uint8>(Unit->GetMovementRange()));
+	Columns.AttackRange.Add(static_cast<uint8>(Unit->GetAttackRange()));
+	Columns.MinDamage.Add(static_cast<uint8>(Unit->MinDamage));
+	Columns.MaxDamage.Add(static_cast<uint8>(Unit->MaxDamage));
+	Columns.Ranged.Add(Unit->IsRangedAttack());
+
+	AliveTeams |= 1u << Team;
+	Unit->SetRegistryHandle(Handle);
+	return Handle;
+}
+
+/**
+ * Descrizione:
+ * Rimozione con swap: l'ultima unità della squadra viene spostata nell'indice liberato
+ * e il suo slot aggiornato. Lo slot rimosso cambia generazione e torna disponibile.
+ */
+bool FUnitRegistry::Remove(FUnitHandle Handle)
+{
+	const FSlot* Found = FindSlot(Handle);
+	if (!Found) return false;
+
+	FSlot& Slot = Slots[Handle.Index];
+	FColumns& Columns = Teams[Slot.Team];
+	const int32 DenseIndex = Slot.DenseIndex;
+	const int32 LastIndex = Columns.Num() - 1;
+
+	if (AUnitBase* Unit = Columns.Actors[DenseIndex])
+	{
+		Unit->SetRegistryHandle(FUnitHandle());
+	}
+
+	if (DenseIndex != LastIndex)
+	{
+		Slots[Columns.Handles[LastIndex].Index].DenseIndex = DenseIndex;
+	}
+
+	Columns.Actors.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+	Columns.Handles.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+	Columns.Health.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+	Columns.MaxHealth.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+	Columns.MovementRange.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+	Columns.AttackRange.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+	Columns.MinDamage.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+	Columns.MaxDamage.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+	Columns.Ranged.RemoveAtSwap(DenseIndex);
+
+	if (Columns.Num() == 0)
+	{
+		AliveTeams &= ~(1u << Slot.Team);
+	}
+
+	++Slot.Generation;
+	Slot.Team = INDEX_NONE;
+	Slot.DenseIndex = INDEX_NONE;
+	FreeSlots.Add(Handle.Index);
+	return true;
+}
+
+AUnitBase* FUnitRegistry::Get(FUnitHandle Handle) const
+{
+	const FSlot* Slot = FindSlot(Handle);
+	return Slot ? Teams[Slot->Team].Actors[Slot->DenseIndex] : nullptr;
+}
+
+void FUnitRegistry::SetHealth(FUnitHandle Handle, int32 Health)
+{
+	if (const FSlot* Slot = FindSlot(Handle))
+	{
+		Teams[Slot->Team].Health[Slot->DenseIndex] = static_cast<int16>(Health);
+	}
+}
+
+void FUnitRegistry::Reset()
+{
+	for (int32 SlotIndex = 0; SlotIndex < Slots.Num(); ++SlotIndex)
+	{
+		FSlot& Slot = Slots[SlotIndex];
+		if (Slot.Team == INDEX_NONE) continue;
+
+		++Slot.Generation;
+		Slot.Team = INDEX_NONE;
+		Slot.DenseIndex = INDEX_NONE;
+		FreeSlots.Add(SlotIndex);
+	}
+
+	for (FColumns& Columns : Teams)
+	{
+		Columns = FColumns();
+	}
+	AliveTeams = 0;
+}
+
+int32 FUnitRegistry::Num() const
+{
+	int32 Total = 0;
+	for (const FColumns& Columns : Teams)
+	{
+		Total += Columns.Num();
+	}
+	return Total;
+}
+
+int32 FUnitRegistry::GetLastTeamStanding() const
+{
+	// Un solo bit acceso: la squadra è l'indice di quel bit
+	if (AliveTeams == 0 || (AliveTeams & (AliveTeams - 1)) != 0) return INDEX_NONE;
+	return FMath::CountTrailingZeros(AliveTeams);
+}
+
+const FUnitRegistry::FSlot* FUnitRegistry::FindSlot(FUnitHandle Handle) const
+{
+	if (!Slots.IsValidIndex(Handle.Index)) return nullptr;
+
+	const FSlot& Slot = Slots[Handle.Index];
+	return Slot.Generation == Handle.Generation && Slot.Team != INDEX_NONE ? &Slot : nullptr;
+}
@@ -0,0 +1,126 @@
+// Creato da: Schifano Francesco 5469994
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AUnitBase;
+
+/**
+ * Descrizione:
+ * Riferimento stabile a un'unità del registro. L'indice punta a uno slot, la generazione
+ * distingue l'unità attuale da quelle che hanno occupato lo stesso slot in passato:
+ * un handle di un'unità morta non risolve mai verso un'unità nuova.
+ */
+struct FUnitHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool IsSet() const { return Index != INDEX_NONE; }
+
+	bool operator==(const FUnitHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+	bool operator!=(const FUnitHandle& Other) const { return !(*this == Other); }
+
+	friend uint32 GetTypeHash(const FUnitHandle& Handle) { return HashCombine(GetTypeHash(Handle.Index), Handle.Generation); }
+};
+
+/**
+ * Classe: FUnitRegistry
+ * Descrizione:
+ * Registro delle unità in partita, sostituisce le liste PlayerUnits/AIUnits del GameMode.
+ * Per ogni squadra (TeamID dell'unità) le unità vive sono compatte in colonne parallele (SoA):
+ * attori, handle, vita e statistiche di combattimento. Iterare una squadra legge solo array
+ * contigui, anche con centinaia di unità.
+ *
+ * La rimozione è O(1): l'ultima unità della squadra prende il posto di quella rimossa.
+ * L'ordine di iterazione cambia quindi dopo una morte, ma è lo stesso per il gioco,
+ * la board simulata e i salvataggi, che leggono tutti dal registro.
+ */
+class PAASCHIFANOFRANCESCO_API FUnitRegistry
+{
+public:
+	/** Squadra del giocatore umano e prima squadra IA */
+	static constexpr int32 PlayerTeam = 0;
+	static constexpr int32 AITeam = 1;
+	static constexpr int32 MaxTeams = 4;
+
+	/** Colonne di una squadra: l'indice denso è lo stesso in tutti gli array */
+	struct FColumns
+	{
+		TArray<AUnitBase*> Actors;
+		TArray<FUnitHandle> Handles;
+		TArray<int16> Health;
+		TArray<int16> MaxHealth;
+		TArray<uint8> MovementRange;
+		TArray<uint8> AttackRange;
+		TArray<uint8> MinDamage;
+		TArray<uint8> MaxDamage;
+		TBitArray<> Ranged;
+
+		int32 Num() const { return Actors.Num(); }
+	};
+
+	/** Numero di squadre della partita (2 .. MaxTeams) */
+	void SetNumTeams(int32 InNumTeams) { NumTeams = FMath::Clamp(InNumTeams, 2, MaxTeams); }
+	int32 GetNumTeams() const { return NumTeams; }
+
+	/** Registra un'unità nella squadra del suo TeamID (le statistiche sono copiate dall'attore) */
+	FUnitHandle Add(AUnitBase* Unit);
+
+	/** Rimuove l'unità; false se l'handle non è più valido */
+	bool Remove(FUnitHandle Handle);
+
+	/** Attore dell'unità, nullptr se l'unità è stata rimossa */
+	AUnitBase* Get(FUnitHandle Handle) const;
+
+	bool Contains(FUnitHandle Handle) const { return Get(Handle) != nullptr; }
+
+	/** Aggiorna la vita nella colonna (chiamato quando l'attore subisce danni) */
+	void SetHealth(FUnitHandle Handle, int32 Health);
+
+	/** Svuota il registro; le generazioni restano, così gli handle vecchi non tornano validi */
+	void Reset();
+
+	int32 Num(int32 Team) const { return Teams[Team].Num(); }
+	int32 Num() const;
+
+	/** Numero di Sniper della squadra */
+	int32 CountRanged(int32 Team) const { return Teams[Team].Ranged.CountSetBits(); }
+
+	/** Un bit per ogni squadra che ha ancora unità vive */
+	uint32 GetAliveTeamsMask() const { return AliveTeams; }
+
+	/** Squadra vincitrice se ne resta una sola, altrimenti INDEX_NONE */
+	int32 GetLastTeamStanding() const;
+
+	/** Unità vive della squadra, per iterazione diretta */
+	TConstArrayView<AUnitBase*> GetUnits(int32 Team) const { return Teams[Team].Actors; }
+	TConstArrayView<AUnitBase*> GetPlayerUnits() const { return GetUnits(PlayerTeam); }
+
+	/** Handle delle unità vive della squadra (stesso ordine di GetUnits) */
+	TConstArrayView<FUnitHandle> GetHandles(int32 Team) const { return Teams[Team].Handles; }
+
+	/** Colonne della squadra, per i sistemi che leggono le statistiche di molte unità */
+	const FColumns& GetColumns(int32 Team) const { return Teams[Team]; }
+
+private:
+	/** Slot sparso: squadra e indice denso dell'unità che lo occupa */
+	struct FSlot
+	{
+		uint32 Generation = 0;
+		int32 Team = INDEX_NONE;
+		int32 DenseIndex = INDEX_NONE;
+	};
+
+	const FSlot* FindSlot(FUnitHandle Handle) const;
+
+	FColumns Teams[MaxTeams];
+	int32 NumTeams = 2;
+
+	/** Aggiornato a ogni Add/Remove: il controllo di fine partita non scorre le squadre */
+	uint32 AliveTeams = 0;
+
+	TArray<FSlot> Slots;
+	TArray<int32> FreeSlots;
+};